@@ -1,8 +1,13 @@
 #pragma once
 
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cstring>
 #include <cstdio>
+#include <algorithm>
 
 namespace sp
 {
@@ -28,5 +33,89 @@ namespace sp
 			// Removes the file 'fileName' if possible
 			return !std::remove(fileName.c_str());
 		}
+
+		inline std::size_t getFileSize(const std::string & fileName)
+		{
+			// Returns the size of the file 'fileName' in bytes, or 0 if it can't be opened
+			std::ifstream file(fileName, std::ios::in | std::ios::binary | std::ios::ate);
+			return file.is_open() ? static_cast<std::size_t>(file.tellg()) : 0;
+		}
+
+		const std::size_t maximumReservedLines = std::size_t(1) << 20; // Past this the list of lines grows as it's filled
+
+		inline std::size_t estimateLineCount(std::size_t fileSize, const char * sample, std::size_t sampleSize)
+		{
+			// Estimates the number of lines in a file of 'fileSize' bytes from the line length in its first
+			// 'sampleSize' bytes. The estimate is only used to reserve space, so it's capped: a file starting
+			// with many short lines would otherwise ask for far more than it holds.
+			std::size_t newlines = std::count(sample, sample + sampleSize, '\n');
+			if (sampleSize == fileSize)
+			{
+				return newlines + (fileSize && sample[sampleSize - 1] != '\n');
+			}
+			return newlines ? std::min(fileSize / (sampleSize / newlines) + 1, maximumReservedLines) : 1;
+		}
+
+		template <typename ReserveFunctionType, typename FunctionType>
+		bool forEachLineInFile(const std::string & fileName, const ReserveFunctionType & reserve, const FunctionType & function)
+		{
+			// Reads 'fileName' in large blocks and calls function(std::string_view) for each line, with the
+			// same line splitting as std::getline. Before the first line, calls reserve(std::size_t) with an
+			// estimate of the number of lines taken from the size of the file and the first block. Memory
+			// use is bounded by the block size and the longest line. Returns false if the file couldn't be opened.
+			std::ifstream file(fileName, std::ios::in | std::ios::binary | std::ios::ate);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			std::size_t fileSize = static_cast<std::size_t>(file.tellg());
+			file.seekg(0);
+			std::vector<char> buffer(1 << 20);
+			std::size_t carried = 0; // Bytes of an unfinished line kept at the front of the buffer
+			bool first = true;
+			while (file)
+			{
+				if (carried == buffer.size())
+				{
+					buffer.resize(buffer.size() * 2);
+				}
+				file.read(buffer.data() + carried, buffer.size() - carried);
+				std::size_t end = carried + static_cast<std::size_t>(file.gcount());
+				if (first)
+				{
+					reserve(estimateLineCount(fileSize, buffer.data(), end));
+					first = false;
+				}
+				const char * lineStart = buffer.data();
+				const char * searchStart = buffer.data() + carried;
+				const char * bufferEnd = buffer.data() + end;
+				while (const char * newline = static_cast<const char *>(std::memchr(searchStart, '\n', bufferEnd - searchStart)))
+				{
+					std::size_t length = newline - lineStart;
+#ifdef _WIN32
+					if (length && lineStart[length - 1] == '\r') // Match the newline translation of a text-mode stream
+					{
+						--length;
+					}
+#endif
+					function(std::string_view(lineStart, length));
+					lineStart = searchStart = newline + 1;
+				}
+				carried = bufferEnd - lineStart;
+				std::memmove(buffer.data(), lineStart, carried);
+			}
+			if (carried)
+			{
+				function(std::string_view(buffer.data(), carried));
+			}
+			return true;
+		}
+
+		template <typename FunctionType>
+		bool forEachLineInFile(const std::string & fileName, const FunctionType & function)
+		{
+			// As above, without the estimate
+			return forEachLineInFile(fileName, [](std::size_t) {}, function);
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,707 @@
+// CompactNumericFile Class
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include <memory>
+#include <memory_resource>
+
+#include "NumericFile.hpp"
+
+namespace fileFunctions
+{
+	// A view of a contiguous run of values, e.g. one line of a CompactNumericFile. It's invalidated by
+	// anything that reallocates the values it refers to.
+	template <typename T>
+	class BasicNumericSpan
+	{
+	private:
+		T *         first;
+		std::size_t count;
+	public:
+		typedef T                                     value_type;
+		typedef T *                                   iterator;
+		typedef T *                                   const_iterator;
+		typedef std::reverse_iterator<iterator>       reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		BasicNumericSpan() : first(nullptr), count(0)
+		{
+		}
+		BasicNumericSpan(T * data, std::size_t size) : first(data), count(size)
+		{
+		}
+		template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+		BasicNumericSpan(const BasicNumericSpan<U> & rhs) : first(rhs.data()), count(rhs.size())
+		{
+			// Lets a span of doubles be used as a span of const doubles
+		}
+		T *              data() const
+		{
+			return first;
+		}
+		std::size_t      size() const
+		{
+			return count;
+		}
+		bool             empty() const
+		{
+			return count == 0;
+		}
+		T &              operator [] (std::size_t index) const
+		{
+			// Doesn't perform any bounds checking
+			return first[index];
+		}
+		T &              front() const
+		{
+			return first[0];
+		}
+		T &              back() const
+		{
+			return first[count - 1];
+		}
+		iterator         begin() const
+		{
+			return first;
+		}
+		iterator         end() const
+		{
+			return first + count;
+		}
+		reverse_iterator rbegin() const
+		{
+			return reverse_iterator(end());
+		}
+		reverse_iterator rend() const
+		{
+			return reverse_iterator(begin());
+		}
+		BasicNumericSpan subspan(std::size_t offset, std::size_t length) const
+		{
+			// Returns the values [offset, offset + length) of the span, clamped to its size
+			offset = std::min(offset, count);
+			return BasicNumericSpan(first + offset, std::min(length, count - offset));
+		}
+	};
+
+	typedef BasicNumericSpan<double>       NumericRow;
+	typedef BasicNumericSpan<const double> ConstNumericRow;
+
+	// Holds the same data as a NumericFile in compressed-row form: every value of the file in one contiguous
+	// buffer, plus the offset at which each line starts. Lines are handed out as spans instead of copies,
+	// and statistics over a line, a range of lines or the whole file each run over a single flat range.
+	// Appending values to the last line and appending lines are cheap; changing the length of any other
+	// line moves every value after it.
+	template <class Allocator = std::allocator<double>>
+	class BasicCompactNumericFile
+	{
+	public:
+		typedef Allocator                                                                          AllocatorType;
+		typedef std::vector<double, Allocator>                                                     Values;
+		typedef std::vector<std::size_t, typename std::allocator_traits<Allocator>::template rebind_alloc<std::size_t>> RowOffsets;
+	private:
+		Values          values;
+		RowOffsets      rowOffsets; // Line i holds values[rowOffsets[i]] to values[rowOffsets[i + 1] - 1], rowOffsets[0] is 0
+		std::string     fileName;
+		FileCloseAction closingAction;
+	public:
+		// Constructors
+		BasicCompactNumericFile         () : rowOffsets(1, 0), closingAction(FileCloseAction::NONE)
+		{
+			// Create an empty CompactNumericFile object
+		}
+		explicit BasicCompactNumericFile(const AllocatorType & allocator) : values(allocator), rowOffsets(1, 0, typename RowOffsets::allocator_type(allocator)), closingAction(FileCloseAction::NONE)
+		{
+			// Create an empty CompactNumericFile object whose storage is allocated by 'allocator'
+		}
+		explicit BasicCompactNumericFile(const std::string & filePath, FileCloseAction onClose = FileCloseAction::NONE, ExecutionMode mode = ExecutionMode::SEQUENTIAL, const AllocatorType & allocator = AllocatorType()) : values(allocator), rowOffsets(1, 0, typename RowOffsets::allocator_type(allocator)), fileName(filePath), closingAction(onClose)
+		{
+			// Creates a CompactNumericFile object that is associated with a file and loads data upon creation
+			loadFromFile(filePath, mode);
+		}
+		template <class NumericAllocator>
+		explicit BasicCompactNumericFile(const BasicNumericFile<NumericAllocator> & file, const AllocatorType & allocator = AllocatorType()) : values(allocator), rowOffsets(typename RowOffsets::allocator_type(allocator)), fileName(file.getFileName()), closingAction(FileCloseAction::NONE)
+		{
+			// Converts a NumericFile to the compressed-row layout. The closing action isn't copied, so only one
+			// of the two objects would ever write to the file.
+			const typename BasicNumericFile<NumericAllocator>::Contents & contents = file.getFileContents();
+			std::size_t total = 0;
+			for (const auto & i : contents)
+			{
+				total += i.size();
+			}
+			values.reserve(total);
+			rowOffsets.reserve(contents.size() + 1);
+			rowOffsets.push_back(0);
+			for (const auto & i : contents)
+			{
+				values.insert(values.end(), i.begin(), i.end());
+				rowOffsets.push_back(values.size());
+			}
+		}
+		BasicCompactNumericFile         (const BasicCompactNumericFile & rhs) : values(rhs.values), rowOffsets(rhs.rowOffsets), fileName(rhs.fileName), closingAction(rhs.closingAction)
+		{
+			// Copy constructor
+		}
+		BasicCompactNumericFile         (BasicCompactNumericFile && rhs) : values(std::move(rhs.values)), rowOffsets(std::move(rhs.rowOffsets)), fileName(std::move(rhs.fileName)), closingAction(rhs.closingAction)
+		{
+			// Move constructor. rhs is left empty and with no closing action.
+			rhs.rowOffsets.assign(1, 0);
+			rhs.closingAction = FileCloseAction::NONE;
+		}
+		// Destructor
+		~BasicCompactNumericFile()
+		{
+			// Perform an action based on the value of closingAction
+			switch (closingAction)
+			{
+			case FileCloseAction::OUTPUT: // Output the contents to 'fileName'
+				{
+					outputToFile();
+					break;
+				}
+			case FileCloseAction::APPEND: // Append the contents to 'fileName'
+				{
+					appendToFile();
+					break;
+				}
+			default:
+				{
+					break;
+				}
+			}
+		}
+		// Conversion
+		template <class NumericAllocator = std::allocator<double>>
+		BasicNumericFile<NumericAllocator> toNumericFile(const NumericAllocator & allocator = NumericAllocator()) const
+		{
+			// Returns the contents as a NumericFile associated with the same file, with no closing action
+			BasicNumericFile<NumericAllocator> result(allocator);
+			result.setFileName(fileName);
+			for (std::size_t i = 0; i < size(); ++i)
+			{
+				ConstNumericRow line = getLineView(i);
+				result.appendLineToFile(typename BasicNumericFile<NumericAllocator>::NumericLine(line.begin(), line.end(), allocator));
+			}
+			return result;
+		}
+		// Accessors
+		double          getEntry        (std::size_t line, std::size_t index) const
+		{
+			// Returns the entry at (line, index) if the entry exists, otherwise returns 0
+			return index < lineSize(line) ? values[rowOffsets[line] + index] : 0;
+		}
+		ConstNumericRow getLineView     (std::size_t line) const
+		{
+			// Returns a view of the line at (line) if it exists, otherwise an empty view
+			return line < size() ? ConstNumericRow(values.data() + rowOffsets[line], lineSize(line)) : ConstNumericRow();
+		}
+		NumericRow      getLineView     (std::size_t line)
+		{
+			// Returns a modifiable view of the line at (line) if it exists, otherwise an empty view
+			return line < size() ? NumericRow(values.data() + rowOffsets[line], lineSize(line)) : NumericRow();
+		}
+		ConstNumericRow getValues       () const
+		{
+			// Returns a view of every value in the file, line after line
+			return ConstNumericRow(values.data(), values.size());
+		}
+		NumericRow      getValues       ()
+		{
+			// Returns a modifiable view of every value in the file, line after line
+			return NumericRow(values.data(), values.size());
+		}
+		const RowOffsets & getRowOffsets() const
+		{
+			// Returns the offsets at which each line starts in getValues(), followed by the number of values
+			return rowOffsets;
+		}
+		std::string     getFileName     () const
+		{
+			return fileName;
+		}
+		std::string_view getFileNameView() const
+		{
+			return fileName;
+		}
+		FileCloseAction getClosingAction() const
+		{
+			return closingAction;
+		}
+		AllocatorType   getAllocator    () const
+		{
+			return values.get_allocator();
+		}
+		// Mutators
+		void setFileName     (const std::string & filePath)
+		{
+			fileName = filePath;
+		}
+		void setClosingAction(FileCloseAction onClose)
+		{
+			closingAction = onClose;
+		}
+		void setEntry        (std::size_t line, std::size_t index, double value)
+		{
+			// Sets the entry at (line, index) if it exists
+			if (index < lineSize(line))
+			{
+				values[rowOffsets[line] + index] = value;
+			}
+		}
+		template <typename IteratorType>
+		void appendLineToFile(IteratorType first, IteratorType last)
+		{
+			// Appends a line holding [first, last) to the file
+			values.insert(values.end(), first, last);
+			rowOffsets.push_back(values.size());
+		}
+		template <typename ContainerType>
+		void appendLineToFile(const ContainerType & line)
+		{
+			// Appends a line holding the values of 'line' (a NumericLine, a span, a std::vector, ...) to the file
+			appendLineToFile(std::begin(line), std::end(line));
+		}
+		void appendEmptyLine ()
+		{
+			// Appends a line with no values to the file
+			rowOffsets.push_back(values.size());
+		}
+		void appendEntryToLastLine(double value)
+		{
+			// Appends a value to the last line, starting a line first if the file is empty
+			if (empty())
+			{
+				appendEmptyLine();
+			}
+			values.push_back(value);
+			++rowOffsets.back();
+		}
+		void appendEntryToLine(std::size_t line, double value)
+		{
+			// Appends a value to a line if it exists. Moves every value after the line.
+			if (line < size())
+			{
+				values.insert(values.begin() + rowOffsets[line + 1], value);
+				for (std::size_t i = line + 1; i < rowOffsets.size(); ++i)
+				{
+					++rowOffsets[i];
+				}
+			}
+		}
+		void removeLine      (std::size_t line)
+		{
+			// Removes a line from the file if it exists. Moves every value after the line.
+			if (line < size())
+			{
+				std::size_t count = lineSize(line);
+				values.erase(values.begin() + rowOffsets[line], values.begin() + rowOffsets[line + 1]);
+				rowOffsets.erase(rowOffsets.begin() + line + 1);
+				for (std::size_t i = line + 1; i < rowOffsets.size(); ++i)
+				{
+					rowOffsets[i] -= count;
+				}
+			}
+		}
+		void clearContents   ()
+		{
+			// Removes every line, keeping the allocated storage
+			values.clear();
+			rowOffsets.assign(1, 0);
+		}
+		void reserve         (std::size_t valueCount, std::size_t lineCount)
+		{
+			// Makes room for 'valueCount' values in 'lineCount' lines
+			values.reserve(valueCount);
+			rowOffsets.reserve(lineCount + 1);
+		}
+		void shrinkToFit     ()
+		{
+			values.shrink_to_fit();
+			rowOffsets.shrink_to_fit();
+		}
+		// Utilities
+		bool        empty      () const
+		{
+			// Returns true if the file has no lines
+			return size() == 0;
+		}
+		std::size_t size       () const
+		{
+			// Returns the number of lines in the file
+			return rowOffsets.size() - 1;
+		}
+		std::size_t lineSize   (std::size_t line) const
+		{
+			// Returns the size of a line in the file if it exists, otherwise returns 0
+			return line < size() ? rowOffsets[line + 1] - rowOffsets[line] : 0;
+		}
+		std::size_t valueCount () const
+		{
+			// Returns the number of values in the file
+			return values.size();
+		}
+		bool        loadFromFile(ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Clears the contents of the file, then loads the contents of the file 'fileName'
+			return loadFromFile(fileName, mode);
+		}
+		bool        loadFromFile(const std::string & filePath, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Clears the contents of the file, then loads the contents of the file 'filePath' with the bulk
+			// parser of NumericFile::bulkLoadFromFile. Returns false if the file couldn't be opened or held
+			// tokens that aren't numbers.
+			clearContents();
+			return loadFromFileAndAppend(filePath, mode);
+		}
+		bool        loadFromFileAndAppend(const std::string & filePath, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Loads the contents of the file 'filePath' and appends them to the current contents
+			values.reserve(values.size() + FWPF::getFileSize(filePath) / 8);
+			return NFPF::forEachParsedNumericLine(filePath, mode, [this](const double * first, const double * last)
+			{
+				appendLineToFile(first, last);
+			});
+		}
+		bool        loadFromBinaryFile(const std::string & filePath)
+		{
+			// Clears the contents of the file, then loads the binary file 'filePath' (see NumericBinary.hpp).
+			// The values go straight from the file into the value buffer, with no parsing.
+			if (!NFPF::readBinaryNumericFile(filePath, rowOffsets, values))
+			{
+				clearContents();
+				return false;
+			}
+			return true;
+		}
+		bool        outputToBinaryFile(const std::string & filePath) const
+		{
+			// Saves the contents of the file in the same formats as NumericFile::outputToBinaryFile
+			return NFPF::writeBinaryNumericFile(filePath, size(), [this](std::size_t line) { return getLineView(line); });
+		}
+		void        outputToStream(std::ostream & ostr, const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Outputs the contents of the file to a std::ostream, in the same format as NumericFile
+			NFPF::writeRows(ostr, size(), [this](std::size_t line) { return getLineView(line); }, format, mode);
+		}
+		void        outputToFile(const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			outputToFile(fileName, format, mode);
+		}
+		void        outputToFile(const std::string & filePath, const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Outputs the contents of the file to the file 'filePath'
+			std::fstream file(filePath, std::ios::out);
+			if (file.is_open())
+			{
+				outputToStream(file, format, mode);
+			}
+		}
+		void        appendToFile(const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			appendToFile(fileName, format, mode);
+		}
+		void        appendToFile(const std::string & filePath, const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Appends the contents of the file to the file 'filePath'
+			std::fstream file(filePath, std::ios::out | std::ios::app);
+			if (file.is_open())
+			{
+				outputToStream(file, format, mode);
+			}
+		}
+		// Statistics. Lines that don't exist are ignored, and anything computed over no values is 0.
+		double computeSumOfLine                  (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return sumOf(lineRange(line), mode);
+		}
+		double computeSumOfLines                 (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return sumOf(linesRange(lowerBound, upperBound), mode);
+		}
+		double computeSumOfContents              (SummationMode mode = SummationMode::STANDARD) const
+		{
+			return sumOf(getValues(), mode);
+		}
+		double computeAbsoluteSumOfLine          (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return absoluteSumOf(lineRange(line), mode);
+		}
+		double computeAbsoluteSumOfLines         (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return absoluteSumOf(linesRange(lowerBound, upperBound), mode);
+		}
+		double computeAbsoluteSumOfContents      (SummationMode mode = SummationMode::STANDARD) const
+		{
+			return absoluteSumOf(getValues(), mode);
+		}
+		double computeAverageOfLine              (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return averageOf(lineRange(line), mode);
+		}
+		double computeAverageOfLines             (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return averageOf(linesRange(lowerBound, upperBound), mode);
+		}
+		double computeAverageOfContents          (SummationMode mode = SummationMode::STANDARD) const
+		{
+			return averageOf(getValues(), mode);
+		}
+		double computeAbsoluteAverageOfLine      (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return range.empty() ? 0 : absoluteSumOf(range, mode) / range.size();
+		}
+		double computeAbsoluteAverageOfLines     (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return range.empty() ? 0 : absoluteSumOf(range, mode) / range.size();
+		}
+		double computeAbsoluteAverageOfContents  (SummationMode mode = SummationMode::STANDARD) const
+		{
+			return values.empty() ? 0 : absoluteSumOf(getValues(), mode) / values.size();
+		}
+		double computeVarianceOfLine             (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return varianceOf(lineRange(line), mode);
+		}
+		double computeVarianceOfLines            (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return varianceOf(linesRange(lowerBound, upperBound), mode);
+		}
+		double computeVarianceOfContents         (SummationMode mode = SummationMode::STANDARD) const
+		{
+			return varianceOf(getValues(), mode);
+		}
+		double computeStandardDeviationOfLine    (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfLine(line, mode));
+		}
+		double computeStandardDeviationOfLines   (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfLines(lowerBound, upperBound, mode));
+		}
+		double computeStandardDeviationOfContents(SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfContents(mode));
+		}
+		double computeMinimumOfLine              (std::size_t line) const
+		{
+			return minimumOf(lineRange(line));
+		}
+		double computeMinimumOfLines             (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return minimumOf(linesRange(lowerBound, upperBound));
+		}
+		double computeMinimumOfContents          () const
+		{
+			return minimumOf(getValues());
+		}
+		double computeMaximumOfLine              (std::size_t line) const
+		{
+			return maximumOf(lineRange(line));
+		}
+		double computeMaximumOfLines             (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return maximumOf(linesRange(lowerBound, upperBound));
+		}
+		double computeMaximumOfContents          () const
+		{
+			return maximumOf(getValues());
+		}
+		NumericSummary computeSummaryOfLine      (std::size_t line) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::summariseRanges(&range, &range + 1);
+		}
+		NumericSummary computeSummaryOfLines     (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::summariseRanges(&range, &range + 1);
+		}
+		NumericSummary computeSummaryOfContents  () const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::summariseRanges(&range, &range + 1);
+		}
+		NumericColumnSummary computeColumnSummaryOfLines   (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return columnSummaryOf(lowerBound, upperBound);
+		}
+		NumericColumnSummary computeColumnSummaryOfContents() const
+		{
+			return columnSummaryOf(0, std::numeric_limits<std::size_t>::max());
+		}
+		double computeQuantileOfLine             (std::size_t line, double quantile) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::quantileOfRanges(&range, &range + 1, quantile);
+		}
+		double computeQuantileOfLines            (std::size_t lowerBound, std::size_t upperBound, double quantile) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::quantileOfRanges(&range, &range + 1, quantile);
+		}
+		double computeQuantileOfContents         (double quantile) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::quantileOfRanges(&range, &range + 1, quantile);
+		}
+		double computeMedianOfLine               (std::size_t line) const
+		{
+			return computeQuantileOfLine(line, 0.5);
+		}
+		double computeMedianOfLines              (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return computeQuantileOfLines(lowerBound, upperBound, 0.5);
+		}
+		double computeMedianOfContents           () const
+		{
+			return computeQuantileOfContents(0.5);
+		}
+		QuantileSketch computeQuantileSketchOfLines   (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::sketchRanges(&range, &range + 1);
+		}
+		QuantileSketch computeQuantileSketchOfContents() const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::sketchRanges(&range, &range + 1);
+		}
+		NumericHistogram computeHistogramOfLine    (std::size_t line, NumericHistogram histogram) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfLines   (std::size_t lowerBound, std::size_t upperBound, NumericHistogram histogram) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfContents(NumericHistogram histogram) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram));
+		}
+		// Operators
+		BasicCompactNumericFile & operator = (const BasicCompactNumericFile & rhs)
+		{
+			// Copy assignment operator
+			values = rhs.values;
+			rowOffsets = rhs.rowOffsets;
+			fileName = rhs.fileName;
+			closingAction = rhs.closingAction;
+			return *this;
+		}
+		BasicCompactNumericFile & operator = (BasicCompactNumericFile && rhs)
+		{
+			// Move assignment operator. rhs is left empty and with no closing action.
+			if (this != &rhs)
+			{
+				values = std::move(rhs.values);
+				rowOffsets = std::move(rhs.rowOffsets);
+				fileName = std::move(rhs.fileName);
+				closingAction = rhs.closingAction;
+				rhs.values.clear();
+				rhs.rowOffsets.assign(1, 0);
+				rhs.closingAction = FileCloseAction::NONE;
+			}
+			return *this;
+		}
+		bool            operator == (const BasicCompactNumericFile & rhs) const
+		{
+			return values == rhs.values && rowOffsets == rhs.rowOffsets && fileName == rhs.fileName && closingAction == rhs.closingAction;
+		}
+		bool            operator != (const BasicCompactNumericFile & rhs) const
+		{
+			return !(*this == rhs);
+		}
+		ConstNumericRow operator [] (std::size_t line) const
+		{
+			// Doesn't perform any bounds checking
+			return ConstNumericRow(values.data() + rowOffsets[line], rowOffsets[line + 1] - rowOffsets[line]);
+		}
+		NumericRow      operator [] (std::size_t line)
+		{
+			// Doesn't perform any bounds checking
+			return NumericRow(values.data() + rowOffsets[line], rowOffsets[line + 1] - rowOffsets[line]);
+		}
+	private:
+		ConstNumericRow lineRange (std::size_t line) const
+		{
+			return getLineView(line);
+		}
+		ConstNumericRow linesRange(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Lines [lowerBound, upperBound] are next to each other, so their values form one range
+			FWPF::validateBounds(lowerBound, upperBound);
+			if (lowerBound >= size())
+			{
+				return ConstNumericRow();
+			}
+			upperBound = std::min(upperBound, size() - 1);
+			return ConstNumericRow(values.data() + rowOffsets[lowerBound], rowOffsets[upperBound + 1] - rowOffsets[lowerBound]);
+		}
+		NumericColumnSummary columnSummaryOf(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Lines are contiguous, so each is summarised in place
+			FWPF::validateBounds(lowerBound, upperBound);
+			if (lowerBound >= size())
+			{
+				return NumericColumnSummary();
+			}
+			upperBound = std::min(upperBound, size() - 1);
+			return NFPF::summariseColumns(upperBound + 1 - lowerBound, [this, lowerBound](std::size_t i)
+			{
+				return (*this)[lowerBound + i];
+			});
+		}
+		template <NFPF::ReductionType Type>
+		static double reduce       (ConstNumericRow range, double parameter = 0, SummationMode mode = SummationMode::STANDARD)
+		{
+			// Goes through the same fixed blocks as NumericFile, so both return the same bits for the same values
+			return NFPF::reduceRanges<Type>(&range, &range + 1, parameter, mode);
+		}
+		static double sumOf        (ConstNumericRow range, SummationMode mode)
+		{
+			return reduce<NFPF::ReductionType::SUM>(range, 0, mode);
+		}
+		static double absoluteSumOf(ConstNumericRow range, SummationMode mode)
+		{
+			return reduce<NFPF::ReductionType::ABSOLUTE_SUM>(range, 0, mode);
+		}
+		static double averageOf    (ConstNumericRow range, SummationMode mode)
+		{
+			return range.empty() ? 0 : sumOf(range, mode) / range.size();
+		}
+		static double varianceOf   (ConstNumericRow range, SummationMode mode)
+		{
+			// Population variance, computed in two passes like NumericFile does
+			return range.empty() ? 0 : reduce<NFPF::ReductionType::SQUARED_DEVIATION>(range, averageOf(range, mode), mode) / range.size();
+		}
+		static double minimumOf    (ConstNumericRow range)
+		{
+			return reduce<NFPF::ReductionType::MINIMUM>(range);
+		}
+		static double maximumOf    (ConstNumericRow range)
+		{
+			return reduce<NFPF::ReductionType::MAXIMUM>(range);
+		}
+	};
+
+	typedef BasicCompactNumericFile<> CompactNumericFile;
+
+	namespace pmr
+	{
+		typedef BasicCompactNumericFile<std::pmr::polymorphic_allocator<double>> CompactNumericFile;
+	}
+}
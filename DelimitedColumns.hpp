@@ -0,0 +1,390 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <charconv>
+#include <iterator>
+#include <type_traits>
+
+#include "FileWrapper.hpp"
+
+namespace sp
+{
+	// Treats the lines of a FileWrapper as rows of delimited fields (CSV, TSV, ...). Every line is split once,
+	// on demand, into a table of field offsets; after that, looking up any field of any row is a couple of
+	// array reads, so working through one column of a large file never re-tokenizes the others.
+	// The columns refer to the FileWrapper they were made from. Call invalidate() after changing its
+	// contents. Building the table isn't thread-safe, so call buildIndex() before sharing the object
+	// between threads.
+	template <class Allocator = std::allocator<char>>
+	class BasicDelimitedColumns
+	{
+	public:
+		typedef BasicFileWrapper<Allocator> FileType;
+
+		class ColumnView;
+	private:
+		struct FieldSpan
+		{
+			// The position of a field inside its line. Lines are limited to 4 GiB.
+			std::uint32_t begin;
+			std::uint32_t length;
+		};
+
+		const FileType *                 m_file;
+		Tokenizer                        m_tokenizer;
+		ExecutionMode                    m_mode;
+		mutable bool                     m_indexed;
+		mutable std::vector<std::size_t> m_rowOffsets; // The fields of row i are m_fields[m_rowOffsets[i]] to m_fields[m_rowOffsets[i + 1] - 1]
+		mutable std::vector<FieldSpan>   m_fields;
+	public:
+		explicit BasicDelimitedColumns(const FileType & file, const Tokenizer & tokenizer = Tokenizer(','), ExecutionMode mode = ExecutionMode::SEQUENTIAL) : m_file(&file), m_tokenizer(tokenizer), m_mode(mode), m_indexed(false)
+		{
+			// Creates a columnar view of 'file'. Nothing is split until the first field is needed,
+			// at which point every line is split using 'mode'.
+		}
+		// Index
+		void        buildIndex() const
+		{
+			// Splits every line of the file into fields if that hasn't been done yet
+			if (!m_indexed)
+			{
+				buildIndex(m_mode);
+			}
+		}
+		void        buildIndex(ExecutionMode mode) const
+		{
+			// Splits every line of the file into fields, replacing any previous table.
+			// In parallel each thread splits a contiguous block of lines, and the blocks are joined in order.
+			std::size_t rows = m_file->size();
+			std::size_t chunkCount = FWPF::getChunkCount(rows, mode);
+			std::vector<std::vector<FieldSpan>> chunkFields(chunkCount);
+			std::vector<std::size_t> rowOffsets(rows + 1, 0);
+			FWPF::parallelForChunks(rows, chunkCount, [this, &chunkFields, &rowOffsets](std::size_t chunk, std::size_t first, std::size_t last)
+			{
+				Tokenizer::Fields fields;
+				std::vector<FieldSpan> & spans = chunkFields[chunk];
+				for (std::size_t i = first; i < last; ++i)
+				{
+					std::string_view line = m_file->getLineView(i);
+					m_tokenizer.split(line, fields);
+					for (std::string_view field : fields)
+					{
+						spans.push_back(FieldSpan{ static_cast<std::uint32_t>(field.data() - line.data()), static_cast<std::uint32_t>(field.size()) });
+					}
+					rowOffsets[i + 1] = fields.size(); // Turned into offsets below
+				}
+			});
+			std::size_t total = 0;
+			for (const std::vector<FieldSpan> & i : chunkFields)
+			{
+				total += i.size();
+			}
+			m_fields.clear();
+			m_fields.reserve(total);
+			for (const std::vector<FieldSpan> & i : chunkFields)
+			{
+				m_fields.insert(m_fields.end(), i.begin(), i.end());
+			}
+			for (std::size_t i = 0; i < rows; ++i)
+			{
+				rowOffsets[i + 1] += rowOffsets[i];
+			}
+			m_rowOffsets = std::move(rowOffsets);
+			m_indexed = true;
+		}
+		void        invalidate()
+		{
+			// Throws away the table of fields, so it is rebuilt from the current contents of the file when next needed
+			m_indexed = false;
+			m_rowOffsets.clear();
+			m_fields.clear();
+		}
+		bool        isIndexed() const
+		{
+			return m_indexed;
+		}
+		// Accessors
+		std::size_t rowCount() const
+		{
+			// Returns the number of rows, i.e. the number of lines in the file
+			buildIndex();
+			return m_rowOffsets.size() - 1;
+		}
+		std::size_t fieldCount(std::size_t row) const
+		{
+			// Returns the number of fields in a row, or 0 if the row doesn't exist
+			buildIndex();
+			return row < rowCount() ? m_rowOffsets[row + 1] - m_rowOffsets[row] : 0;
+		}
+		std::string_view getField(std::size_t row, std::size_t column) const
+		{
+			// Returns a view of a field if it exists. Otherwise returns an empty view.
+			if (column >= fieldCount(row))
+			{
+				return std::string_view();
+			}
+			const FieldSpan & span = m_fields[m_rowOffsets[row] + column];
+			return m_file->getLineView(row).substr(span.begin, span.length);
+		}
+		ColumnView       getColumn(std::size_t column) const
+		{
+			// Returns a lazy view of the fields of one column, one per row (an empty view where a row is too short)
+			buildIndex();
+			return ColumnView(this, column, 0, rowCount());
+		}
+		template <typename T>
+		std::vector<T>   getColumnAs(std::size_t column, T defaultValue = T(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Returns the fields of one column converted to T, one per row. Numbers are parsed with std::from_chars,
+			// ignoring surrounding whitespace and a leading '+'. Rows where the field is missing or doesn't
+			// parse completely get 'defaultValue'.
+			buildIndex();
+			std::vector<T> result(rowCount(), defaultValue);
+			FWPF::parallelForChunks(result.size(), FWPF::getChunkCount(result.size(), mode), [this, column, &result](std::size_t, std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; ++i)
+				{
+					if (column < fieldCount(i))
+					{
+						parseField(getField(i, column), result[i]);
+					}
+				}
+			});
+			return result;
+		}
+		// Queries
+		template <typename PredicateType>
+		std::vector<std::size_t> findRows(std::size_t column, const PredicateType & predicate, ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Returns, in order, the rows for which predicate(field) == true, where 'field' is a std::string_view
+			// of the row's field in 'column' (empty if the row is too short)
+			buildIndex();
+			std::size_t rows = rowCount();
+			std::size_t chunkCount = FWPF::getChunkCount(rows, mode);
+			std::vector<std::vector<std::size_t>> chunkRows(chunkCount);
+			FWPF::parallelForChunks(rows, chunkCount, [this, column, &predicate, &chunkRows](std::size_t chunk, std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; ++i)
+				{
+					if (predicate(getField(i, column)))
+					{
+						chunkRows[chunk].push_back(i);
+					}
+				}
+			});
+			std::vector<std::size_t> result = std::move(chunkRows[0]);
+			for (std::size_t i = 1; i < chunkCount; ++i)
+			{
+				result.insert(result.end(), chunkRows[i].begin(), chunkRows[i].end());
+			}
+			return result;
+		}
+		template <typename PredicateType>
+		FileType         filterRows(std::size_t column, const PredicateType & predicate, ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Returns a new FileWrapper object holding the whole lines for which predicate(field) == true
+			FileType result(m_file->getAllocator());
+			std::vector<std::size_t> rows = findRows(column, predicate, mode);
+			result.reserve(rows.size());
+			for (std::size_t i : rows)
+			{
+				result.emplaceLine(m_file->getLineView(i));
+			}
+			return result;
+		}
+		FileType         project(const std::vector<std::size_t> & columns, std::string_view separator) const
+		{
+			// Returns a new FileWrapper object whose lines hold only 'columns' of each row, in the order given,
+			// joined with 'separator'. Fields missing from a row are left empty.
+			buildIndex();
+			FileType result(m_file->getAllocator());
+			result.reserve(rowCount());
+			SmallVector<std::string_view, 16> fields;
+			for (std::size_t i = 0; i < rowCount(); ++i)
+			{
+				fields.clear();
+				for (std::size_t j : columns)
+				{
+					fields.push_back(getField(i, j));
+				}
+				result.appendJoinedLine(fields, separator);
+			}
+			return result;
+		}
+	private:
+		template <typename T>
+		static void parseField(std::string_view field, T & value)
+		{
+			// Converts 'field' to a T, leaving 'value' unchanged if it can't be
+			if constexpr (!std::is_arithmetic_v<T>)
+			{
+				value = T(field);
+			}
+			else
+			{
+				const char * first = field.data();
+				const char * last = first + field.size();
+				const FFPF::CharacterTables & tables = FFPF::getCharacterTables();
+				while (first != last && tables.space[static_cast<unsigned char>(*first)])
+				{
+					++first;
+				}
+				while (first != last && tables.space[static_cast<unsigned char>(last[-1])])
+				{
+					--last;
+				}
+				if (first != last && *first == '+')
+				{
+					++first;
+				}
+				T parsed = T();
+				std::from_chars_result result = std::from_chars(first, last, parsed);
+				if (result.ec == std::errc() && result.ptr == last)
+				{
+					value = parsed;
+				}
+			}
+		}
+	};
+
+	template <class Allocator>
+	class BasicDelimitedColumns<Allocator>::ColumnView final : public LineViewInterface<typename BasicDelimitedColumns<Allocator>::ColumnView>
+	{
+	private:
+		const BasicDelimitedColumns * m_columns;
+		std::size_t                   m_column;
+		std::size_t                   m_first;
+		std::size_t                   m_last;
+	public:
+		class iterator
+		{
+		private:
+			const BasicDelimitedColumns * m_columns;
+			std::size_t                   m_column;
+			std::size_t                   m_row;
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef std::string_view                value_type;
+			typedef std::string_view                reference;
+			typedef std::ptrdiff_t                  difference_type;
+			typedef void                            pointer;
+
+			iterator(const BasicDelimitedColumns * columns, std::size_t column, std::size_t row) : m_columns(columns), m_column(column), m_row(row)
+			{
+			}
+			std::string_view operator *  () const
+			{
+				return m_columns->getField(m_row, m_column);
+			}
+			std::string_view operator [] (difference_type offset) const
+			{
+				return m_columns->getField(m_row + offset, m_column);
+			}
+			std::size_t      row() const
+			{
+				// Returns the row the iterator is on
+				return m_row;
+			}
+			iterator &       operator ++ ()
+			{
+				++m_row;
+				return *this;
+			}
+			iterator         operator ++ (int)
+			{
+				iterator result = *this;
+				++m_row;
+				return result;
+			}
+			iterator &       operator -- ()
+			{
+				--m_row;
+				return *this;
+			}
+			iterator         operator -- (int)
+			{
+				iterator result = *this;
+				--m_row;
+				return result;
+			}
+			iterator &       operator += (difference_type offset)
+			{
+				m_row += offset;
+				return *this;
+			}
+			iterator &       operator -= (difference_type offset)
+			{
+				m_row -= offset;
+				return *this;
+			}
+			iterator         operator +  (difference_type offset) const
+			{
+				return iterator(m_columns, m_column, m_row + offset);
+			}
+			iterator         operator -  (difference_type offset) const
+			{
+				return iterator(m_columns, m_column, m_row - offset);
+			}
+			difference_type  operator -  (const iterator & rhs) const
+			{
+				return static_cast<difference_type>(m_row) - static_cast<difference_type>(rhs.m_row);
+			}
+			bool             operator == (const iterator & rhs) const
+			{
+				return m_row == rhs.m_row;
+			}
+			bool             operator != (const iterator & rhs) const
+			{
+				return m_row != rhs.m_row;
+			}
+			bool             operator <  (const iterator & rhs) const
+			{
+				return m_row < rhs.m_row;
+			}
+		};
+
+		ColumnView(const BasicDelimitedColumns * columns, std::size_t column, std::size_t first, std::size_t last) : m_columns(columns), m_column(column), m_first(first), m_last(last)
+		{
+			// Creates a view of the fields of 'column' in rows [first, last)
+		}
+		iterator         begin() const
+		{
+			return iterator(m_columns, m_column, m_first);
+		}
+		iterator         end() const
+		{
+			return iterator(m_columns, m_column, m_last);
+		}
+		std::size_t      size() const
+		{
+			return m_last - m_first;
+		}
+		std::size_t      count() const
+		{
+			return size();
+		}
+		std::string_view operator [] (std::size_t index) const
+		{
+			// Doesn't perform any bounds checking
+			return m_columns->getField(m_first + index, m_column);
+		}
+		ColumnView       slice(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Returns the fields of rows [lowerBound, upperBound] of this view without wrapping the view
+			FWPF::validateBounds(lowerBound, upperBound);
+			lowerBound = std::min(lowerBound, size());
+			upperBound = upperBound < size() ? upperBound + 1 : size();
+			return ColumnView(m_columns, m_column, m_first + lowerBound, m_first + upperBound);
+		}
+	};
+
+	typedef BasicDelimitedColumns<> DelimitedColumns;
+
+	namespace pmr
+	{
+		typedef BasicDelimitedColumns<std::pmr::polymorphic_allocator<char>> DelimitedColumns;
+	}
+}
@@ -6,69 +6,98 @@
 #include <algorithm>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
 
 #include "FileCloseAction.hpp"
 #include "CommonFunctions.hpp"
+#include "ParallelFunctions.hpp"
+#include "RegexFunctions.hpp"
+#include "LineViews.hpp"
+#include "FormattingPipeline.hpp"
 
 namespace sp
 {
-	class FileWrapper final
+	// The storage of every line and of the list of lines comes from 'Allocator'. FileWrapper uses
+	// the default allocator; pmr::FileWrapper takes a std::pmr::memory_resource, so a file can be
+	// loaded into e.g. a std::pmr::monotonic_buffer_resource and released all at once.
+	template <class Allocator = std::allocator<char>>
+	class BasicFileWrapper final
 	{
 	public:
-		typedef std::vector<std::string>     File;
-		typedef File::iterator               Iterator;
-		typedef File::const_iterator         ConstIterator;
-		typedef File::reverse_iterator       ReverseIterator;
-		typedef File::const_reverse_iterator ConstReverseIterator;
+		typedef Allocator                                                                                     AllocatorType;
+		typedef std::basic_string<char, std::char_traits<char>, Allocator>                                    Line;
+		typedef std::vector<Line, typename std::allocator_traits<Allocator>::template rebind_alloc<Line>>     File;
+		typedef typename File::iterator                                                                       Iterator;
+		typedef typename File::const_iterator                                                                 ConstIterator;
+		typedef typename File::reverse_iterator                                                               ReverseIterator;
+		typedef typename File::const_reverse_iterator                                                         ConstReverseIterator;
 	private:
+		// Strings other than Line, such as a std::string given to a pmr::FileWrapper, are copied into a new Line
+		template <typename StringType>
+		using EnableIfOtherString = std::enable_if_t<std::is_convertible_v<const StringType &, std::string_view> && !std::is_same_v<StringType, Line>>;
+
 		File            m_contents;
 		std::string     m_filename;
 		FileCloseAction m_closingAction;
 	public:
 		// Constructors
-		FileWrapper() : m_closingAction(FileCloseAction::NONE)
+		BasicFileWrapper() : m_closingAction(FileCloseAction::NONE)
 		{
 			// Creates an empty FileWrapper object
 		}
-		explicit FileWrapper(FileCloseAction closingAction) : m_closingAction(closingAction)
+		explicit BasicFileWrapper(const AllocatorType & allocator) : m_contents(typename File::allocator_type(allocator)), m_closingAction(FileCloseAction::NONE)
+		{
+			// Creates an empty FileWrapper object whose lines are allocated by 'allocator'
+		}
+		explicit BasicFileWrapper(FileCloseAction closingAction, const AllocatorType & allocator = AllocatorType()) : m_contents(typename File::allocator_type(allocator)), m_closingAction(closingAction)
 		{
 			// Creates an empty FileWrapper object
 		}
-		explicit FileWrapper(const std::string & filename, FileCloseAction closingAction = FileCloseAction::NONE) : m_filename(filename), m_closingAction(closingAction)
+		explicit BasicFileWrapper(const std::string & filename, FileCloseAction closingAction = FileCloseAction::NONE, const AllocatorType & allocator = AllocatorType()) : m_contents(typename File::allocator_type(allocator)), m_filename(filename), m_closingAction(closingAction)
 		{
 			// Opens and loads a file into memory
 			loadFromFile(filename);
 		}
-		FileWrapper(Iterator first, Iterator last) : m_contents(first, last), m_closingAction(FileCloseAction::NONE)
+		BasicFileWrapper(Iterator first, Iterator last, const AllocatorType & allocator = AllocatorType()) : m_contents(first, last, typename File::allocator_type(allocator)), m_closingAction(FileCloseAction::NONE)
 		{
 			// Creates a new FileWrapper object from two valid non-const iterators
 		}
-		FileWrapper(ConstIterator first, ConstIterator last) : m_contents(first, last), m_closingAction(FileCloseAction::NONE)
+		BasicFileWrapper(ConstIterator first, ConstIterator last, const AllocatorType & allocator = AllocatorType()) : m_contents(first, last, typename File::allocator_type(allocator)), m_closingAction(FileCloseAction::NONE)
 		{
 			// Creates a new FileWrapper object from two valid const iterators
 		}
-		FileWrapper(ReverseIterator first, ReverseIterator last) : m_contents(first, last), m_closingAction(FileCloseAction::NONE)
+		BasicFileWrapper(ReverseIterator first, ReverseIterator last, const AllocatorType & allocator = AllocatorType()) : m_contents(first, last, typename File::allocator_type(allocator)), m_closingAction(FileCloseAction::NONE)
 		{
 			// Creates a new FileWrapper object from two valid non-const reverse iterators
 		}
-		FileWrapper(ConstReverseIterator first, ConstReverseIterator last) : m_contents(first, last), m_closingAction(FileCloseAction::NONE)
+		BasicFileWrapper(ConstReverseIterator first, ConstReverseIterator last, const AllocatorType & allocator = AllocatorType()) : m_contents(first, last, typename File::allocator_type(allocator)), m_closingAction(FileCloseAction::NONE)
 		{
 			// Creates a new FileWrapper object from two valid const reverse iterators
 		}
-		FileWrapper(const FileWrapper & rhs) : m_contents(rhs.m_contents), m_filename(rhs.m_filename), m_closingAction(rhs.m_closingAction)
+		BasicFileWrapper(const BasicFileWrapper & rhs) : m_contents(rhs.m_contents), m_filename(rhs.m_filename), m_closingAction(rhs.m_closingAction)
 		{
 			// Copies the contents of one FileWrapper object to another
 		}
-		FileWrapper(const FileWrapper & rhs, FileCloseAction closingAction) : m_contents(rhs.m_contents), m_filename(rhs.m_filename), m_closingAction(closingAction)
+		BasicFileWrapper(const BasicFileWrapper & rhs, const AllocatorType & allocator) : m_contents(rhs.m_contents, typename File::allocator_type(allocator)), m_filename(rhs.m_filename), m_closingAction(rhs.m_closingAction)
+		{
+			// Copies the contents of one FileWrapper object to another, allocating the copy with 'allocator'
+		}
+		BasicFileWrapper(const BasicFileWrapper & rhs, FileCloseAction closingAction) : m_contents(rhs.m_contents), m_filename(rhs.m_filename), m_closingAction(closingAction)
 		{
 			// Copies the contents of one FileWrapper object to another, but uses a new closing action
 		}
-		FileWrapper(FileWrapper && rhs) : m_contents(std::move(rhs.m_contents)), m_filename(std::move(rhs.m_filename)), m_closingAction(std::move(rhs.m_closingAction))
+		BasicFileWrapper(BasicFileWrapper && rhs) : m_contents(std::move(rhs.m_contents)), m_filename(std::move(rhs.m_filename)), m_closingAction(std::move(rhs.m_closingAction))
 		{
-			// Move constructor
+			// Move constructor. rhs is left with no closing action, so it can't overwrite the file with nothing.
+			rhs.m_closingAction = FileCloseAction::NONE;
 		}
 		// Destructor
-		~FileWrapper()
+		~BasicFileWrapper()
 		{
 			switch (m_closingAction)
 			{
@@ -88,17 +117,38 @@ namespace sp
 		std::string     getFirstLine() const
 		{
 			// If the file has a first line, returns it. Otherwise returns a blank string.
-			return size() ? m_contents.at(0) : "";
+			return size() ? std::string(m_contents.at(0)) : std::string();
 		}
 		std::string     getLastLine() const
 		{
 			// If the file has a last line, returns it. Otherwise returns a blank string.
-			return size() ? m_contents.at(size() - 1) : "";
+			return size() ? std::string(m_contents.at(size() - 1)) : std::string();
 		}
 		std::string     getLine(std::size_t index) const
 		{
 			// Returns a line in the file if it exists. Otherwise returns a blank string.
-			return index < size() ? m_contents.at(index) : "";
+			return index < size() ? std::string(m_contents.at(index)) : std::string();
+		}
+		std::string_view getFirstLineView() const
+		{
+			// If the file has a first line, returns a view of it. Otherwise returns an empty view.
+			return size() ? std::string_view(m_contents.front()) : std::string_view();
+		}
+		std::string_view getLastLineView() const
+		{
+			// If the file has a last line, returns a view of it. Otherwise returns an empty view.
+			return size() ? std::string_view(m_contents.back()) : std::string_view();
+		}
+		std::string_view getLineView(std::size_t index) const
+		{
+			// Returns a view of a line in the file if it exists. Otherwise returns an empty view.
+			// The view is invalidated by anything that modifies or removes the line.
+			return index < size() ? std::string_view(m_contents[index]) : std::string_view();
+		}
+		TransformView<LineView<ConstIterator>, FWPF::StringViewOf> getLinesView(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Returns a range of string_views over the lines in [lowerBound, upperBound] without copying them
+			return lines(lowerBound, upperBound).transform(FWPF::StringViewOf());
 		}
 		File            getLines(std::size_t lowerBound, std::size_t upperBound) const
 		{
@@ -106,9 +156,19 @@ namespace sp
 			FWPF::validateBounds(lowerBound, upperBound);
 			if (lowerBound < size())
 			{
-				return File(m_contents.begin() + lowerBound, m_contents.begin() + 1 + std::min(upperBound, size() - 1));
+				return File(m_contents.begin() + lowerBound, m_contents.begin() + 1 + std::min(upperBound, size() - 1), m_contents.get_allocator());
 			}
-			return File();
+			return File(m_contents.get_allocator());
+		}
+		LineView<ConstIterator> lines() const
+		{
+			// Returns a lazy view of every line in the file. See LineViews.hpp.
+			return LineView<ConstIterator>(m_contents.cbegin(), m_contents.cend());
+		}
+		LineView<ConstIterator> lines(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Returns a lazy view of the lines in [lowerBound, upperBound] without copying them
+			return lines().slice(lowerBound, upperBound);
 		}
 		const File &    getContents() const
 		{
@@ -120,6 +180,16 @@ namespace sp
 			// Returns the name of the file associated with the FileWrapper object
 			return m_filename;
 		}
+		std::string_view getFilenameView() const
+		{
+			// Returns a view of the name of the file associated with the FileWrapper object
+			return m_filename;
+		}
+		AllocatorType   getAllocator() const
+		{
+			// Returns the allocator used for the lines of the file
+			return AllocatorType(m_contents.get_allocator());
+		}
 		FileCloseAction getClosingAction() const
 		{
 			// Returns the action that will occur upon destruction
@@ -161,7 +231,7 @@ namespace sp
 			// Changes the closing action of the FileWrapper object to the one specified by 'closingAction'
 			m_closingAction = closingAction;
 		}
-		void setLine(std::size_t index, const std::string & str)
+		void setLine(std::size_t index, const Line & str)
 		{
 			// Sets line[index] to 'str'
 			if (index < size())
@@ -169,12 +239,59 @@ namespace sp
 				m_contents.at(index) = str;
 			}
 		}
-		void appendLine(const std::string & str)
+		void setLine(std::size_t index, Line && str)
+		{
+			// Sets line[index] to 'str', taking over its buffer
+			if (index < size())
+			{
+				m_contents.at(index) = std::move(str);
+			}
+		}
+		template <typename StringType, typename = EnableIfOtherString<StringType>>
+		void setLine(std::size_t index, const StringType & str)
+		{
+			// Sets line[index] to a copy of 'str', keeping the line's allocator
+			if (index < size())
+			{
+				m_contents.at(index).assign(std::string_view(str));
+			}
+		}
+		void appendLine(const Line & str)
 		{
 			// Places a line at the end of the file
 			m_contents.push_back(str);
 		}
-		void appendToLine(std::size_t index, const std::string & str)
+		void appendLine(Line && str)
+		{
+			// Places a line at the end of the file, taking over the buffer of 'str'
+			m_contents.push_back(std::move(str));
+		}
+		template <typename StringType, typename = EnableIfOtherString<StringType>>
+		void appendLine(const StringType & str)
+		{
+			// Places a copy of 'str' at the end of the file
+			m_contents.emplace_back(std::string_view(str));
+		}
+		template <typename... Args>
+		void emplaceLine(Args &&... args)
+		{
+			// Constructs a line at the end of the file from 'args' (e.g. a std::string_view, or a pointer and a length)
+			m_contents.emplace_back(std::forward<Args>(args)...);
+		}
+		template <typename RangeType>
+		void appendJoinedLine(const RangeType & range, std::string_view separator = ", ")
+		{
+			// Places a line at the end of the file made of the elements of 'range' (strings or numbers) with
+			// 'separator' between them. The line is built in place.
+			joinInto(m_contents.emplace_back(), std::begin(range), std::end(range), separator);
+		}
+		template <typename IteratorType>
+		void appendJoinedLine(IteratorType first, IteratorType last, std::string_view separator = ", ")
+		{
+			// Places a line at the end of the file made of the elements of [first, last) with 'separator' between them
+			joinInto(m_contents.emplace_back(), first, last, separator);
+		}
+		void appendToLine(std::size_t index, std::string_view str)
 		{
 			// Append the contents of str to the indexth line of the file
 			if (index < size())
@@ -182,12 +299,23 @@ namespace sp
 				m_contents.at(index).append(str);
 			}
 		}
-		void prependLine(const std::string & str)
+		void prependLine(const Line & str)
 		{
 			// Inserts a line at the beginning of the file
 			m_contents.insert(m_contents.begin(), str);
 		}
-		void prependToLine(std::size_t index, const std::string & str)
+		void prependLine(Line && str)
+		{
+			// Inserts a line at the beginning of the file, taking over the buffer of 'str'
+			m_contents.insert(m_contents.begin(), std::move(str));
+		}
+		template <typename StringType, typename = EnableIfOtherString<StringType>>
+		void prependLine(const StringType & str)
+		{
+			// Inserts a copy of 'str' at the beginning of the file
+			m_contents.emplace(m_contents.begin(), std::string_view(str));
+		}
+		void prependToLine(std::size_t index, std::string_view str)
 		{
 			// Prepend the contents of str to the indexth line of the file
 			if (index < size())
@@ -195,7 +323,7 @@ namespace sp
 				m_contents.at(index).insert(m_contents.at(index).begin(), str.begin(), str.end());
 			}
 		}
-		void insertLine(std::size_t index, const std::string & str)
+		void insertLine(std::size_t index, const Line & str)
 		{
 			// Inserts a line before the given index
 			if (index < size())
@@ -203,6 +331,23 @@ namespace sp
 				m_contents.insert(m_contents.begin() + index, str);
 			}
 		}
+		void insertLine(std::size_t index, Line && str)
+		{
+			// Inserts a line before the given index, taking over the buffer of 'str'
+			if (index < size())
+			{
+				m_contents.insert(m_contents.begin() + index, std::move(str));
+			}
+		}
+		template <typename StringType, typename = EnableIfOtherString<StringType>>
+		void insertLine(std::size_t index, const StringType & str)
+		{
+			// Inserts a copy of 'str' before the given index
+			if (index < size())
+			{
+				m_contents.emplace(m_contents.begin() + index, std::string_view(str));
+			}
+		}
 		void removeLine(std::size_t index)
 		{
 			// Removes a line from the file
@@ -252,6 +397,47 @@ namespace sp
 				}
 			}
 		}
+		void removeLinesMatching(const std::string & pattern, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Erases every line in the file that matches the regular expression 'pattern'
+			std::vector<char> matches = FWPF::markMatches(m_contents.cbegin(), m_contents.cend(), pattern, mode);
+			std::size_t position = 0;
+			for (std::size_t i = 0; i < size(); ++i)
+			{
+				if (!matches[i])
+				{
+					if (position != i)
+					{
+						m_contents[position] = std::move(m_contents[i]);
+					}
+					++position;
+				}
+			}
+			m_contents.erase(m_contents.begin() + position, m_contents.end());
+		}
+		void removeLinesMatching(std::size_t lowerBound, std::size_t upperBound, const std::string & pattern, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Erases every line in [lowerBound, upperBound] that matches the regular expression 'pattern'
+			FWPF::validateBounds(lowerBound, upperBound);
+			if (lowerBound < size())
+			{
+				upperBound = std::min(upperBound, size() - 1);
+				std::vector<char> matches = FWPF::markMatches(m_contents.cbegin() + lowerBound, m_contents.cbegin() + upperBound + 1, pattern, mode);
+				std::size_t position = lowerBound;
+				for (std::size_t i = lowerBound; i < size(); ++i)
+				{
+					if (i > upperBound || !matches[i - lowerBound])
+					{
+						if (position != i)
+						{
+							m_contents[position] = std::move(m_contents[i]);
+						}
+						++position;
+					}
+				}
+				m_contents.erase(m_contents.begin() + position, m_contents.end());
+			}
+		}
 		void clearContents()
 		{
 			// Erases every line in the file
@@ -263,6 +449,20 @@ namespace sp
 			// Goes through each line in the file and erases it if function(line) == true
 			removeLinesIf(0, size() ? size() - 1 : 0, function, args...);
 		}
+		void reserve(std::size_t lineCount)
+		{
+			// Makes room for 'lineCount' lines, so appending up to that many lines won't reallocate the list of lines
+			m_contents.reserve(lineCount);
+		}
+		void shrinkToFit()
+		{
+			// Releases unused capacity in the list of lines and in each line
+			for (Line & i : m_contents)
+			{
+				i.shrink_to_fit();
+			}
+			m_contents.shrink_to_fit();
+		}
 		// Utilities
 		bool        empty() const
 		{
@@ -274,6 +474,11 @@ namespace sp
 			// Returns the number of lines held by the FileWrapper object
 			return m_contents.size();
 		}
+		std::size_t capacity() const
+		{
+			// Returns the number of lines the FileWrapper object can hold before it has to reallocate its list of lines
+			return m_contents.capacity();
+		}
 		std::size_t lineSize(std::size_t index) const
 		{
 			// Returns the size of a line in the file if the line exists, otherwise returns 0
@@ -283,99 +488,71 @@ namespace sp
 		{
 			// Clears the contents of the FileWrapper object, then loads in the
 			// data from the file specified by FileWrapper::m_filename
-			std::fstream file(m_filename, std::ios::in);
 			clearContents();
-			if (file.is_open())
-			{
-				std::string buffer;
-				while (std::getline(file, buffer))
-				{
-					m_contents.push_back(buffer);
-				}
-			}
+			loadLinesFromFile(m_filename, 0);
 		}
 		void        loadFromFile(const std::string & filename)
 		{
 			// Clears the contents of the FileWrapper object, then loads in the
 			// data from the file specified by 'filename'
-			std::fstream file(filename, std::ios::in);
 			clearContents();
-			if (file.is_open())
-			{
-				std::string buffer;
-				while (std::getline(file, buffer))
-				{
-					m_contents.push_back(buffer);
-				}
-			}
+			loadLinesFromFile(filename, 0);
 		}
 		void        loadFromFileAndAppend()
 		{
 			// Loads the data from the file specified by FileWrapper::m_filename, then
 			// appends it to the data currently held by the FileWrapper object
-			std::fstream file(m_filename, std::ios::in);
-			if (file.is_open())
-			{
-				std::string buffer;
-				while (std::getline(file, buffer))
-				{
-					m_contents.push_back(buffer);
-				}
-			}
+			loadLinesFromFile(m_filename, size());
 		}
 		void        loadFromFileAndAppend(const std::string & filename)
 		{
 			// Loads the data from the file specified by 'filename', then
 			// appends it to the data currently held by the FileWrapper
 			// object
-			std::fstream file(filename, std::ios::in);
-			if (file.is_open())
-			{
-				std::string buffer;
-				while (std::getline(file, buffer))
-				{
-					m_contents.push_back(buffer);
-				}
-			}
+			loadLinesFromFile(filename, size());
 		}
 		void		loadFromFileAndPrepend()
 		{
 			// Loads the data from the file specified by 'm_filename', then
 			// prepends it to the data currently held by the FileWrapper
 			// object
-			std::fstream file(m_filename, std::ios::in);
-			if (file.is_open())
-			{
-				int position = 0;
-				std::string buffer;
-				while (std::getline(file, buffer))
-				{
-					m_contents.insert(m_contents.begin() + position++, buffer);
-				}
-			}
+			loadLinesFromFile(m_filename, 0);
 		}
 		void		loadFromFileAndPrepend(const std::string & filename)
 		{
 			// Loads the data from the file specified by 'filename', then
 			// prepends it to the data currently held by the FileWrapper
 			// object
-			std::fstream file(filename, std::ios::in);
-			if (file.is_open())
-			{
-				int position = 0;
-				std::string buffer;
-				while (std::getline(file, buffer))
-				{
-					m_contents.insert(m_contents.begin() + position++, buffer);
-				}
-			}
+			loadLinesFromFile(filename, 0);
+		}
+		template <typename... Stages>
+		void        loadFromFile(const std::string & filename, const Pipeline<Stages...> & pipeline)
+		{
+			// Clears the contents of the FileWrapper object, then loads in the data from the file specified by 'filename',
+			// running 'pipeline' over each line as it is read
+			clearContents();
+			loadLinesFromFile(filename, 0, [&pipeline](Line & line) { pipeline.apply(line); });
+		}
+		template <typename... Stages>
+		void        loadFromFileAndAppend(const std::string & filename, const Pipeline<Stages...> & pipeline)
+		{
+			// Loads the data from the file specified by 'filename', running 'pipeline' over each line
+			// as it is read, then appends it to the data currently held by the FileWrapper object
+			loadLinesFromFile(filename, size(), [&pipeline](Line & line) { pipeline.apply(line); });
+		}
+		template <typename... Stages>
+		void        loadFromFileAndPrepend(const std::string & filename, const Pipeline<Stages...> & pipeline)
+		{
+			// Loads the data from the file specified by 'filename', running 'pipeline' over each line
+			// as it is read, then prepends it to the data currently held by the FileWrapper object
+			loadLinesFromFile(filename, 0, [&pipeline](Line & line) { pipeline.apply(line); });
 		}
 		void        outputToFile() const
 		{
 			// Clears the contents of the file specified by FileWrapper::m_filename, then outputs
 			// the data held by the FileWrapper object to the file specified by FileWrapper::m_filename
 			std::fstream file(m_filename, std::ios::out);
-			for (auto i : m_contents)
+			for (const Line & i : m_contents)
 			{
 				if (file.is_open())
 				{
@@ -389,7 +566,7 @@ namespace sp
 			// the data held by the FileWrapper object to the file specified by
 			// 'filename'
 			std::fstream file(filename, std::ios::out);
-			for (auto i : m_contents)
+			for (const Line & i : m_contents)
 			{
 				if (file.is_open())
 				{
@@ -402,7 +579,7 @@ namespace sp
 			// Appends the contents of the FileWrapper object to
 			// the file specified by FileWrapper::m_filename
 			std::fstream file(m_filename, std::ios::out | std::ios::app);
-			for (auto i : m_contents)
+			for (const Line & i : m_contents)
 			{
 				if (file.is_open())
 				{
@@ -415,7 +592,7 @@ namespace sp
 			// Appends the contents of the FileWrapper object to the file specified
 			// by 'filename'. Does not affect the file held by FileWrapper::m_filename
 			std::fstream file(filename, std::ios::out | std::ios::app);
-			for (auto i : m_contents)
+			for (const Line & i : m_contents)
 			{
 				if (file.is_open())
 				{
@@ -426,7 +603,7 @@ namespace sp
 		void        outputToStream(std::ostream & ostr) const
 		{
 			// Output the contents of the file to a std::ostream (i.e. std::ostream, std::ofstream, etc.) if the stream is valid
-			for (auto i : m_contents)
+			for (const Line & i : m_contents)
 			{
 				if (ostr.good())
 				{
@@ -434,12 +611,16 @@ namespace sp
 				}
 			}
 		}
+		// applyFunctionTo{Line,Lines,Contents} replace each line with function(line, args...). A function that
+		// can't take a Line, such as convertToLowerCase with a pmr::FileWrapper, is given the line as a
+		// std::string_view or else as a std::string, and its result is assigned back into the line, which
+		// keeps the wrapper's allocator.
 		template <typename FunctionType, typename... Args>
 		void        applyFunctionToLine(std::size_t index, const FunctionType & function, const Args &... args)
 		{
 			if (index < size())
 			{
-				m_contents.at(index) = function(m_contents.at(index), args...);
+				m_contents.at(index) = callOnLine(m_contents.at(index), function, args...);
 			}
 		}
 		template <typename FunctionType, typename... Args>
@@ -448,7 +629,7 @@ namespace sp
 			FWPF::validateBounds(lowerBound, upperBound);
 			for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
 			{
-				m_contents.at(i) = function(m_contents.at(i), args...);
+				m_contents.at(i) = callOnLine(m_contents.at(i), function, args...);
 			}
 		}
 		template <typename FunctionType, typename... Args>
@@ -456,116 +637,265 @@ namespace sp
 		{
 			for (auto & i : m_contents)
 			{
-				i = function(i, args...);
+				i = callOnLine(i, function, args...);
+			}
+		}
+		template <typename FunctionType, typename... Args>
+		void        applyFunctionToLineInPlace(std::size_t index, const FunctionType & function, const Args &... args)
+		{
+			// Calls function(line, args...) on a line, where 'function' modifies the line it is given
+			if (index < size())
+			{
+				function(m_contents[index], args...);
+			}
+		}
+		template <typename FunctionType, typename... Args>
+		void        applyFunctionToLinesInPlace(std::size_t lowerBound, std::size_t upperBound, const FunctionType & function, const Args &... args)
+		{
+			// Calls function(line, args...) on each line in [lowerBound, upperBound], where 'function' modifies the line it is given
+			FWPF::validateBounds(lowerBound, upperBound);
+			for (std::size_t i = lowerBound; i <= upperBound && i < size(); ++i)
+			{
+				function(m_contents[i], args...);
 			}
 		}
-		void        mergeAndAppend(const FileWrapper & rhs)
+		template <typename FunctionType, typename... Args>
+		void        applyFunctionToContentsInPlace(const FunctionType & function, const Args &... args)
+		{
+			// Calls function(line, args...) on every line, where 'function' modifies the line it is given
+			for (Line & i : m_contents)
+			{
+				function(i, args...);
+			}
+		}
+		template <typename... Stages>
+		void        applyFunctionToLine(std::size_t index, const Pipeline<Stages...> & pipeline)
+		{
+			// Runs 'pipeline' over a line in place
+			if (index < size())
+			{
+				pipeline.apply(m_contents[index]);
+			}
+		}
+		template <typename... Stages>
+		void        applyFunctionToLines(std::size_t lowerBound, std::size_t upperBound, const Pipeline<Stages...> & pipeline)
+		{
+			// Runs 'pipeline' over each line in [lowerBound, upperBound] in place
+			FWPF::validateBounds(lowerBound, upperBound);
+			for (std::size_t i = lowerBound; i <= upperBound && i < size(); ++i)
+			{
+				pipeline.apply(m_contents[i]);
+			}
+		}
+		template <typename... Stages>
+		void        applyFunctionToContents(const Pipeline<Stages...> & pipeline, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Runs 'pipeline' over every line in place
+			applyToEachLine(mode, [&pipeline](Line & line) { pipeline.apply(line); });
+		}
+		void        convertContentsToLowerCase(ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Converts the ASCII letters of every line to lower-case
+			applyToEachLine(mode, [](Line & line) { convertToLowerCaseInPlace(line); });
+		}
+		void        convertContentsToUpperCase(ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Converts the ASCII letters of every line to upper-case
+			applyToEachLine(mode, [](Line & line) { convertToUpperCaseInPlace(line); });
+		}
+		void        invertCaseOfContents(ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Swaps the case of the ASCII letters of every line
+			applyToEachLine(mode, [](Line & line) { invertCaseInPlace(line); });
+		}
+		void        removePunctuationFromContents(ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Erases the ASCII punctuation characters from every line
+			applyToEachLine(mode, [](Line & line) { removePunctuationInPlace(line); });
+		}
+		void        removeSpacesFromContents(ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Erases the whitespace characters from every line
+			applyToEachLine(mode, [](Line & line) { removeSpacesInPlace(line); });
+		}
+		void        removeCharacterFromContents(char ch, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Erases every occurrence of 'ch' from every line
+			applyToEachLine(mode, [ch](Line & line) { removeCharacterInPlace(line, ch); });
+		}
+		void        replaceCharacterInContents(char remove, char replace, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Replaces every occurrence of 'remove' with 'replace' in every line
+			applyToEachLine(mode, [remove, replace](Line & line) { replaceCharacterInPlace(line, remove, replace); });
+		}
+		void        mergeAndAppend(const BasicFileWrapper & rhs)
 		{
 			// Adds the contents of rhs to the end of the FileWrapper object
-			for (unsigned int i = 0; i < rhs.size(); ++i)
+			std::size_t count = rhs.size(); // rhs may be *this, so its size is read before anything is added
+			m_contents.reserve(size() + count);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				m_contents.push_back(rhs.m_contents[i]);
+			}
+		}
+		void        mergeAndAppend(BasicFileWrapper && rhs)
+		{
+			// Moves the contents of rhs to the end of the FileWrapper object without copying any line.
+			// rhs is left empty and with no closing action.
+			if (&rhs == this)
 			{
-				appendLine(rhs.getLine(i));
+				mergeAndAppend(static_cast<const BasicFileWrapper &>(rhs));
+				return;
 			}
+			if (empty() && m_contents.get_allocator() == rhs.m_contents.get_allocator())
+			{
+				m_contents.swap(rhs.m_contents); // Takes over the whole list of lines
+			}
+			else
+			{
+				m_contents.insert(m_contents.end(), std::make_move_iterator(rhs.m_contents.begin()), std::make_move_iterator(rhs.m_contents.end()));
+			}
+			rhs.m_contents.clear();
+			rhs.m_closingAction = FileCloseAction::NONE;
 		}
 		void        mergeAndAppend(Iterator begin, Iterator end)
 		{
 			// Adds the contents of [begin, end) to the end of the FileWrapper object
+			if (size() + std::distance(begin, end) > capacity())
+			{
+				insertCopies(size(), begin, end); // Growing would invalidate [begin, end) if it points into this object
+				return;
+			}
 			while (begin != end)
 			{
-				appendLine(*begin++);
+				m_contents.emplace_back(*begin++);
 			}
 		}
 		void        mergeAndAppend(ConstIterator begin, ConstIterator end)
 		{
 			// Adds the contents of [begin, end) to the end of the FileWrapper object
+			if (size() + std::distance(begin, end) > capacity())
+			{
+				insertCopies(size(), begin, end); // Growing would invalidate [begin, end) if it points into this object
+				return;
+			}
 			while (begin != end)
 			{
-				appendLine(*begin++);
+				m_contents.emplace_back(*begin++);
 			}
 		}
 		void        mergeAndAppend(ReverseIterator begin, ReverseIterator end)
 		{
 			// Adds the contents of [begin, end) to the end of the FileWrapper object
+			if (size() + std::distance(begin, end) > capacity())
+			{
+				insertCopies(size(), begin, end); // Growing would invalidate [begin, end) if it points into this object
+				return;
+			}
 			while (begin != end)
 			{
-				appendLine(*begin++);
+				m_contents.emplace_back(*begin++);
 			}
 		}
 		void        mergeAndAppend(ConstReverseIterator begin, ConstReverseIterator end)
 		{
 			// Adds the contents of [begin, end) to the end of the FileWrapper object
+			if (size() + std::distance(begin, end) > capacity())
+			{
+				insertCopies(size(), begin, end); // Growing would invalidate [begin, end) if it points into this object
+				return;
+			}
 			while (begin != end)
 			{
-				appendLine(*begin++);
+				m_contents.emplace_back(*begin++);
 			}
 		}
-		void        mergeAndPrepend(const FileWrapper & rhs)
+		void        mergeAndPrepend(const BasicFileWrapper & rhs)
 		{
 			// Prepends the contents of rhs to the FileWrapper object
-			std::size_t position = 0;
-			for (unsigned int i = 0; i < rhs.size(); ++i)
+			if (&rhs == this)
+			{
+				File copy(rhs.m_contents, m_contents.get_allocator());
+				m_contents.insert(m_contents.begin(), copy.begin(), copy.end());
+			}
+			else
 			{
-				insertLine(position++, rhs.getLine(i));
+				m_contents.insert(m_contents.begin(), rhs.m_contents.begin(), rhs.m_contents.end());
 			}
 		}
-		void        mergeAndPrepend(Iterator begin, Iterator end)
+		void        mergeAndPrepend(BasicFileWrapper && rhs)
 		{
-			// Prepends the contents of [begin, end) to the FileWrapper object
-			std::size_t position = 0;
-			while (begin != end)
+			// Moves the contents of rhs to the beginning of the FileWrapper object without copying any line.
+			// rhs is left empty and with no closing action.
+			if (&rhs == this)
 			{
-				insertLine(position++, *begin++);
+				mergeAndPrepend(static_cast<const BasicFileWrapper &>(rhs));
+				return;
 			}
+			m_contents.insert(m_contents.begin(), std::make_move_iterator(rhs.m_contents.begin()), std::make_move_iterator(rhs.m_contents.end()));
+			rhs.m_contents.clear();
+			rhs.m_closingAction = FileCloseAction::NONE;
+		}
+		void        mergeAndPrepend(Iterator begin, Iterator end)
+		{
+			// Prepends the contents of [begin, end) to the FileWrapper object
+			insertCopies(0, begin, end);
 		}
 		void        mergeAndPrepend(ConstIterator begin, ConstIterator end)
 		{
 			// Prepends the contents of [begin, end) to the FileWrapper object
-			std::size_t position = 0;
-			while (begin != end)
-			{
-				insertLine(position++, *begin++);
-			}
+			insertCopies(0, begin, end);
 		}
 		void        mergeAndPrepend(ReverseIterator begin, ReverseIterator end)
 		{
 			// Prepends the contents of [begin, end) to the FileWrapper object
-			std::size_t position = 0;
-			while (begin != end)
-			{
-				insertLine(position++, *begin++);
-			}
+			insertCopies(0, begin, end);
 		}
 		void        mergeAndPrepend(ConstReverseIterator begin, ConstReverseIterator end)
 		{
 			// Prepends the contents of [begin, end) to the FileWrapper object
-			std::size_t position = 0;
-			while (begin != end)
-			{
-				insertLine(position++, *begin++);
-			}
+			insertCopies(0, begin, end);
 		}
-		void        mergeAndInsert(std::size_t index, const FileWrapper & rhs)
+		void        mergeAndInsert(std::size_t index, const BasicFileWrapper & rhs)
 		{
 			// Merge the contents of rhs with those of the FileWrapper object, starting at index
 			// Each line is inserted before index, so the valid range is [0, size() -1]
 			if (index < size())
 			{
-				for (unsigned int i = 0; i < rhs.size(); ++i)
+				if (&rhs == this)
+				{
+					File copy(rhs.m_contents, m_contents.get_allocator());
+					m_contents.insert(m_contents.begin() + index, copy.begin(), copy.end());
+				}
+				else
 				{
-					insertLine(index++, rhs.getLine(i));
+					m_contents.insert(m_contents.begin() + index, rhs.m_contents.begin(), rhs.m_contents.end());
 				}
 			}
 		}
+		void        mergeAndInsert(std::size_t index, BasicFileWrapper && rhs)
+		{
+			// Moves the contents of rhs into the FileWrapper object before index without copying any line.
+			// The valid range is [0, size() - 1]. rhs is left empty and with no closing action.
+			if (&rhs == this)
+			{
+				mergeAndInsert(index, static_cast<const BasicFileWrapper &>(rhs));
+				return;
+			}
+			if (index < size())
+			{
+				m_contents.insert(m_contents.begin() + index, std::make_move_iterator(rhs.m_contents.begin()), std::make_move_iterator(rhs.m_contents.end()));
+				rhs.m_contents.clear();
+				rhs.m_closingAction = FileCloseAction::NONE;
+			}
+		}
 		void        mergeAndInsert(std::size_t index, Iterator begin, Iterator end)
 		{
 			// Merge the contents of [begin, end) with those of the FileWrapper object, starting at index
 			// Each line is inserted before index, so the valid range is [0, size() - 1]
 			if (index < size())
 			{
-				while (begin != end)
-				{
-					insertLine(index++, *begin++);
-				}
+				insertCopies(index, begin, end);
 			}
 		}
 		void        mergeAndInsert(std::size_t index, ConstIterator begin, ConstIterator end)
@@ -574,10 +904,7 @@ namespace sp
 			// Each line is inserted before index, so the valid range is [0, size() - 1]
 			if (index < size())
 			{
-				while (begin != end)
-				{
-					insertLine(index++, *begin++);
-				}
+				insertCopies(index, begin, end);
 			}
 		}
 		void        mergeAndInsert(std::size_t index, ReverseIterator begin, ReverseIterator end)
@@ -586,10 +913,7 @@ namespace sp
 			// Each line is inserted before index, so the valid range is [0, size() - 1]
 			if (index < size())
 			{
-				while (begin != end)
-				{
-					insertLine(index++, *begin++);
-				}
+				insertCopies(index, begin, end);
 			}
 		}
 		void        mergeAndInsert(std::size_t index, ConstReverseIterator begin, ConstReverseIterator end)
@@ -598,10 +922,7 @@ namespace sp
 			// Each line is inserted before index, so the valid range is [0, size() - 1]
 			if (index < size())
 			{
-				while (begin != end)
-				{
-					insertLine(index++, *begin++);
-				}
+				insertCopies(index, begin, end);
 			}
 		}
 		// Iterators
@@ -765,8 +1086,32 @@ namespace sp
 			}
 			return iterator;
 		}
+		Iterator             findRegex(const std::string & pattern, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Find the first line matching the regular expression 'pattern' and return an iterator to that line
+			return begin() + FWPF::findFirstMatch(cbegin(), cend(), pattern, mode);
+		}
+		ConstIterator        findRegex(const std::string & pattern, ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Find the first line matching the regular expression 'pattern' and return an iterator to that line
+			return cbegin() + FWPF::findFirstMatch(cbegin(), cend(), pattern, mode);
+		}
+		std::vector<std::size_t> findAllRegex(const std::string & pattern, ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Returns the indices of every line matching the regular expression 'pattern', in ascending order
+			std::vector<char> matches = FWPF::markMatches(cbegin(), cend(), pattern, mode);
+			std::vector<std::size_t> result;
+			for (std::size_t i = 0; i < matches.size(); ++i)
+			{
+				if (matches[i])
+				{
+					result.push_back(i);
+				}
+			}
+			return result;
+		}
 		// Overloaded Operators
-		FileWrapper &       operator =  (const FileWrapper & rhs)
+		BasicFileWrapper &  operator =  (const BasicFileWrapper & rhs)
 		{
 			// Copy assignment operator
 			m_contents = rhs.getContents();
@@ -774,33 +1119,115 @@ namespace sp
 			m_closingAction = rhs.getClosingAction();
 			return *this;
 		}
-		FileWrapper &       operator =  (FileWrapper && rhs)
+		BasicFileWrapper &  operator =  (BasicFileWrapper && rhs)
 		{
-			// Move assignment operator
-			m_contents = std::move(rhs.getContents());
-			m_filename = std::move(rhs.getFilename());
-			m_closingAction = std::move(rhs.getClosingAction());
+			// Move assignment operator. rhs is left with no closing action, so it can't overwrite the file with nothing.
+			// Moving into itself leaves the wrapper as it was.
+			if (this != &rhs)
+			{
+				m_contents = std::move(rhs.m_contents);
+				m_filename = std::move(rhs.m_filename);
+				m_closingAction = rhs.m_closingAction;
+				rhs.m_closingAction = FileCloseAction::NONE;
+			}
 			return *this;
 		}
-		bool                operator == (const FileWrapper & rhs) const
+		bool                operator == (const BasicFileWrapper & rhs) const
 		{
 			// Returns true if all the components are equal, otherwise returns false
 			return m_contents == rhs.getContents() && m_filename == rhs.getFilename() && m_closingAction == rhs.getClosingAction();
 		}
-		bool                operator != (const FileWrapper & rhs) const
+		bool                operator != (const BasicFileWrapper & rhs) const
 		{
 			// Returns true if any of the components are not equal, otherwise returns false
 			return m_contents != rhs.getContents() || m_filename != rhs.getFilename() || m_closingAction != rhs.getClosingAction();
 		}
-		const std::string & operator [] (std::size_t index) const
+		const Line &        operator [] (std::size_t index) const
 		{
 			// Doesn't perform any bounds checking, leaves that to the container
 			return m_contents.at(index);
 		}
-		std::string &       operator [] (std::size_t index)
+		Line &              operator [] (std::size_t index)
 		{
 			// Doesn't perform any bounds checking, leaves that to the container
 			return m_contents.at(index);
 		}
+	private:
+		template <typename FunctionType, typename... Args>
+		static auto callOnLine(Line & line, const FunctionType & function, const Args &... args)
+		{
+			if constexpr (std::is_invocable_v<const FunctionType &, Line &, const Args &...>)
+			{
+				return function(line, args...);
+			}
+			else if constexpr (std::is_invocable_v<const FunctionType &, std::string_view, const Args &...>)
+			{
+				return function(std::string_view(line), args...);
+			}
+			else
+			{
+				return function(std::string(line.data(), line.size()), args...);
+			}
+		}
+		template <typename FunctionType>
+		void applyToEachLine(ExecutionMode mode, const FunctionType & function)
+		{
+			// Calls function(line) on every line, splitting the lines across threads if mode == PARALLEL
+			FWPF::parallelForChunks(size(), FWPF::getChunkCount(size(), mode), [this, &function](std::size_t, std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; ++i)
+				{
+					function(m_contents[i]);
+				}
+			});
+		}
+		void loadLinesFromFile(const std::string & filename, std::size_t position)
+		{
+			loadLinesFromFile(filename, position, [](Line &) {});
+		}
+		template <typename FunctionType>
+		void loadLinesFromFile(const std::string & filename, std::size_t position, const FunctionType & function)
+		{
+			// Inserts the lines of the file 'filename' before 'position', calling function(line) on each new line.
+			// The list of lines is sized from an estimate made while reading the first block, up to a limit,
+			// and each line is built straight from the read buffer, so the only allocations are the lines themselves.
+			if (position == size())
+			{
+				FWPF::forEachLineInFile(filename, [this](std::size_t expected)
+				{
+					m_contents.reserve(size() + expected);
+				}, [this, &function](std::string_view line)
+				{
+					function(m_contents.emplace_back(line));
+				});
+			}
+			else
+			{
+				File lines(m_contents.get_allocator());
+				FWPF::forEachLineInFile(filename, [&lines](std::size_t expected)
+				{
+					lines.reserve(expected);
+				}, [&lines, &function](std::string_view line)
+				{
+					function(lines.emplace_back(line));
+				});
+				m_contents.insert(m_contents.begin() + position, std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+			}
+		}
+		template <typename IteratorType>
+		void insertCopies(std::size_t position, IteratorType begin, IteratorType end)
+		{
+			// Inserts copies of [begin, end) before 'position' with a single shift of the existing lines.
+			// The copies are made first, so [begin, end) may point into this object.
+			File lines(begin, end, m_contents.get_allocator());
+			m_contents.insert(m_contents.begin() + position, std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+		}
 	};
-}
\ No newline at end of file
+
+	typedef BasicFileWrapper<> FileWrapper;
+
+	namespace pmr
+	{
+		typedef BasicFileWrapper<std::pmr::polymorphic_allocator<char>> FileWrapper;
+	}
+}
@@ -4,53 +4,345 @@
 #include <string>
 #include <algorithm>
 #include <numeric>
+#include <limits>
 #include <list>
+#include <array>
+#include <cstring>
+#include <cstdint>
+#include <string_view>
+#include <charconv>
+#include <iterator>
+#include <type_traits>
+
+#include "SmallVector.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
 
 namespace sp
 {
-	std::string convertToLowerCase(const std::string & str)
+	namespace FFPF // FormattingFunctionsPrivateFunctions
 	{
-		std::string result;
-		for (char i : str)
+		// ASCII-only character classification and case tables. Bytes outside of ASCII are never
+		// letters, spaces or punctuation, which is what the "C" locale does as well.
+		struct CharacterTables
+		{
+			std::array<char, 256> lower;
+			std::array<char, 256> upper;
+			std::array<char, 256> invert;
+			std::array<bool, 256> space;
+			std::array<bool, 256> punctuation;
+		};
+
+		inline const CharacterTables & getCharacterTables()
+		{
+			static const CharacterTables tables = []()
+			{
+				CharacterTables result;
+				for (int i = 0; i < 256; ++i)
+				{
+					char ch = static_cast<char>(i);
+					bool isUpper = i >= 'A' && i <= 'Z';
+					bool isLower = i >= 'a' && i <= 'z';
+					result.lower[i] = isUpper ? static_cast<char>(i + 32) : ch;
+					result.upper[i] = isLower ? static_cast<char>(i - 32) : ch;
+					result.invert[i] = isUpper || isLower ? static_cast<char>(i ^ 32) : ch;
+					result.space[i] = i == ' ' || (i >= '\t' && i <= '\r');
+					result.punctuation[i] = (i >= '!' && i <= '/') || (i >= ':' && i <= '@') || (i >= '[' && i <= '`') || (i >= '{' && i <= '~');
+				}
+				return result;
+			}();
+			return tables;
+		}
+
+		inline unsigned countTrailingZeros(std::uint32_t value)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			unsigned long index;
+			_BitScanForward(&index, value);
+			return index;
+#else
+			return __builtin_ctz(value);
+#endif
+		}
+
+		// The widest vector the target was compiled for: 32 bytes with AVX2, 16 with SSE2 (always present on
+		// x86-64). Without either, only the table-driven scalar loops are used.
+#if defined(__AVX2__)
+#define SP_FORMATTING_SIMD
+		typedef __m256i Block;
+		const std::size_t blockSize = 32;
+		inline Block loadBlock(const char * data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+		inline void  storeBlock(char * data, Block block) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), block); }
+		inline Block splat(char ch) { return _mm256_set1_epi8(ch); }
+		inline Block equal(Block lhs, Block rhs) { return _mm256_cmpeq_epi8(lhs, rhs); }
+		inline Block greater(Block lhs, Block rhs) { return _mm256_cmpgt_epi8(lhs, rhs); }
+		inline Block bitAnd(Block lhs, Block rhs) { return _mm256_and_si256(lhs, rhs); }
+		inline Block bitOr(Block lhs, Block rhs) { return _mm256_or_si256(lhs, rhs); }
+		inline Block bitXor(Block lhs, Block rhs) { return _mm256_xor_si256(lhs, rhs); }
+		inline Block bitAndNot(Block mask, Block value) { return _mm256_andnot_si256(mask, value); }
+		inline std::uint32_t moveMask(Block block) { return static_cast<std::uint32_t>(_mm256_movemask_epi8(block)); }
+#elif defined(__SSE2__) || defined(_M_X64)
+#define SP_FORMATTING_SIMD
+		typedef __m128i Block;
+		const std::size_t blockSize = 16;
+		inline Block loadBlock(const char * data) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)); }
+		inline void  storeBlock(char * data, Block block) { _mm_storeu_si128(reinterpret_cast<__m128i *>(data), block); }
+		inline Block splat(char ch) { return _mm_set1_epi8(ch); }
+		inline Block equal(Block lhs, Block rhs) { return _mm_cmpeq_epi8(lhs, rhs); }
+		inline Block greater(Block lhs, Block rhs) { return _mm_cmpgt_epi8(lhs, rhs); }
+		inline Block bitAnd(Block lhs, Block rhs) { return _mm_and_si128(lhs, rhs); }
+		inline Block bitOr(Block lhs, Block rhs) { return _mm_or_si128(lhs, rhs); }
+		inline Block bitXor(Block lhs, Block rhs) { return _mm_xor_si128(lhs, rhs); }
+		inline Block bitAndNot(Block mask, Block value) { return _mm_andnot_si128(mask, value); }
+		inline std::uint32_t moveMask(Block block) { return static_cast<std::uint32_t>(_mm_movemask_epi8(block)); }
+#endif
+
+#ifdef SP_FORMATTING_SIMD
+		inline Block inRange(Block block, char low, char high)
+		{
+			// Marks the bytes in [low, high]. Bytes >= 0x80 compare as negative, so they are never in an ASCII range.
+			return bitAnd(greater(block, splat(static_cast<char>(low - 1))), greater(splat(static_cast<char>(high + 1)), block));
+		}
+		inline Block isUpperBlock(Block block)
+		{
+			return inRange(block, 'A', 'Z');
+		}
+		inline Block isLowerBlock(Block block)
+		{
+			return inRange(block, 'a', 'z');
+		}
+		inline Block isSpaceBlock(Block block)
+		{
+			return bitOr(equal(block, splat(' ')), inRange(block, '\t', '\r'));
+		}
+		inline Block isPunctuationBlock(Block block)
+		{
+			return bitOr(bitOr(inRange(block, '!', '/'), inRange(block, ':', '@')), bitOr(inRange(block, '[', '`'), inRange(block, '{', '~')));
+		}
+#endif
+
+		template <typename BlockFunction, typename ScalarFunction>
+		void transformInPlace(char * data, std::size_t size, const BlockFunction & blockFunction, const ScalarFunction & scalarFunction)
+		{
+			// Replaces every byte with its transformed value, a whole vector at a time where possible
+			std::size_t i = 0;
+#ifdef SP_FORMATTING_SIMD
+			for (; i + blockSize <= size; i += blockSize)
+			{
+				storeBlock(data + i, blockFunction(loadBlock(data + i)));
+			}
+#else
+			(void)blockFunction;
+#endif
+			for (; i < size; ++i)
+			{
+				data[i] = scalarFunction(data[i]);
+			}
+		}
+
+		template <typename BlockFunction, typename ScalarFunction>
+		std::size_t removeInPlace(char * data, std::size_t size, const BlockFunction & removeBlock, const ScalarFunction & remove)
+		{
+			// Shifts the bytes for which remove(byte) == false to the front and returns how many there are.
+			// Blocks with nothing to remove are moved as a whole.
+			std::size_t read = 0;
+			std::size_t write = 0;
+#ifdef SP_FORMATTING_SIMD
+			for (; read + blockSize <= size; read += blockSize)
+			{
+				Block block = loadBlock(data + read);
+				std::uint32_t removed = moveMask(removeBlock(block));
+				if (removed == 0)
+				{
+					storeBlock(data + write, block);
+					write += blockSize;
+				}
+				else
+				{
+					alignas(32) char bytes[blockSize];
+					storeBlock(bytes, block);
+					std::uint32_t kept = ~removed & static_cast<std::uint32_t>((std::uint64_t(1) << blockSize) - 1);
+					while (kept)
+					{
+						data[write++] = bytes[countTrailingZeros(kept)];
+						kept &= kept - 1;
+					}
+				}
+			}
+#else
+			(void)removeBlock;
+#endif
+			for (; read < size; ++read)
+			{
+				if (!remove(data[read]))
+				{
+					data[write++] = data[read];
+				}
+			}
+			return write;
+		}
+
+		inline const char * findByte(const char * first, const char * last, char ch)
 		{
-			result += tolower(i);
+			// Returns a pointer to the first byte in [first, last) equal to 'ch', or 'last' if there is none.
+			// The C library's memchr is already vectorised, so there's no block loop here.
+			const void * found = first != last ? std::memchr(first, ch, static_cast<std::size_t>(last - first)) : nullptr;
+			return found ? static_cast<const char *>(found) : last;
 		}
+	}
+
+	template <typename StringType>
+	void convertToLowerCaseInPlace(StringType & str)
+	{
+		// Converts the ASCII letters in 'str' to lower-case
+		const FFPF::CharacterTables & tables = FFPF::getCharacterTables();
+		FFPF::transformInPlace(str.data(), str.size(), [](auto block)
+		{
+#ifdef SP_FORMATTING_SIMD
+			return FFPF::bitOr(block, FFPF::bitAnd(FFPF::isUpperBlock(block), FFPF::splat(0x20)));
+#else
+			return block;
+#endif
+		}, [&tables](char ch)
+		{
+			return tables.lower[static_cast<unsigned char>(ch)];
+		});
+	}
+
+	template <typename StringType>
+	void convertToUpperCaseInPlace(StringType & str)
+	{
+		// Converts the ASCII letters in 'str' to upper-case
+		const FFPF::CharacterTables & tables = FFPF::getCharacterTables();
+		FFPF::transformInPlace(str.data(), str.size(), [](auto block)
+		{
+#ifdef SP_FORMATTING_SIMD
+			return FFPF::bitXor(block, FFPF::bitAnd(FFPF::isLowerBlock(block), FFPF::splat(0x20)));
+#else
+			return block;
+#endif
+		}, [&tables](char ch)
+		{
+			return tables.upper[static_cast<unsigned char>(ch)];
+		});
+	}
+
+	template <typename StringType>
+	void invertCaseInPlace(StringType & str)
+	{
+		// Swaps the case of the ASCII letters in 'str'
+		const FFPF::CharacterTables & tables = FFPF::getCharacterTables();
+		FFPF::transformInPlace(str.data(), str.size(), [](auto block)
+		{
+#ifdef SP_FORMATTING_SIMD
+			return FFPF::bitXor(block, FFPF::bitAnd(FFPF::bitOr(FFPF::isUpperBlock(block), FFPF::isLowerBlock(block)), FFPF::splat(0x20)));
+#else
+			return block;
+#endif
+		}, [&tables](char ch)
+		{
+			return tables.invert[static_cast<unsigned char>(ch)];
+		});
+	}
+
+	template <typename StringType>
+	void replaceCharacterInPlace(StringType & str, char remove, char replace)
+	{
+		// Replaces every occurrence of 'remove' in 'str' with 'replace'
+		FFPF::transformInPlace(str.data(), str.size(), [remove, replace](auto block)
+		{
+#ifdef SP_FORMATTING_SIMD
+			auto matches = FFPF::equal(block, FFPF::splat(remove));
+			return FFPF::bitOr(FFPF::bitAndNot(matches, block), FFPF::bitAnd(matches, FFPF::splat(replace)));
+#else
+			return block;
+#endif
+		}, [remove, replace](char ch)
+		{
+			return ch == remove ? replace : ch;
+		});
+	}
+
+	template <typename StringType>
+	void removePunctuationInPlace(StringType & str)
+	{
+		// Erases the ASCII punctuation characters in 'str'
+		const FFPF::CharacterTables & tables = FFPF::getCharacterTables();
+		str.resize(FFPF::removeInPlace(str.data(), str.size(), [](auto block)
+		{
+#ifdef SP_FORMATTING_SIMD
+			return FFPF::isPunctuationBlock(block);
+#else
+			return block;
+#endif
+		}, [&tables](char ch)
+		{
+			return tables.punctuation[static_cast<unsigned char>(ch)];
+		}));
+	}
+
+	template <typename StringType>
+	void removeSpacesInPlace(StringType & str)
+	{
+		// Erases the whitespace characters in 'str'
+		const FFPF::CharacterTables & tables = FFPF::getCharacterTables();
+		str.resize(FFPF::removeInPlace(str.data(), str.size(), [](auto block)
+		{
+#ifdef SP_FORMATTING_SIMD
+			return FFPF::isSpaceBlock(block);
+#else
+			return block;
+#endif
+		}, [&tables](char ch)
+		{
+			return tables.space[static_cast<unsigned char>(ch)];
+		}));
+	}
+
+	template <typename StringType>
+	void removeCharacterInPlace(StringType & str, char ch)
+	{
+		// Erases every occurrence of 'ch' in 'str'
+		str.resize(FFPF::removeInPlace(str.data(), str.size(), [ch](auto block)
+		{
+#ifdef SP_FORMATTING_SIMD
+			return FFPF::equal(block, FFPF::splat(ch));
+#else
+			return block;
+#endif
+		}, [ch](char current)
+		{
+			return current == ch;
+		}));
+	}
+
+	std::string convertToLowerCase(const std::string & str)
+	{
+		std::string result(str);
+		convertToLowerCaseInPlace(result);
 		return result;
 	}
 
 	std::string convertToUpperCase(const std::string & str)
 	{
-		std::string result;
-		for (char i : str)
-		{
-			result += toupper(i);
-		}
+		std::string result(str);
+		convertToUpperCaseInPlace(result);
 		return result;
 	}
 
 	std::string removePunctuation(const std::string & str)
 	{
-		std::string result;
-		for (char i : str)
-		{
-			if (!ispunct(i))
-			{
-				result += i;
-			}
-		}
+		std::string result(str);
+		removePunctuationInPlace(result);
 		return result;
 	}
 
 	std::string removeSpaces(const std::string & str)
 	{
-		std::string result;
-		for (char i : str)
-		{
-			if (!isspace(i))
-			{
-				result += i;
-			}
-		}
+		std::string result(str);
+		removeSpacesInPlace(result);
 		return result;
 	}
 
@@ -68,51 +360,22 @@ namespace sp
 
 	std::string removeCharacter(const std::string & str, char ch)
 	{
-		std::string result;
-		for (char i : str)
-		{
-			if (i != ch)
-			{
-				result += i;
-			}
-		}
+		std::string result(str);
+		removeCharacterInPlace(result, ch);
 		return result;
 	}
 
 	std::string replaceCharacter(const std::string & str, char remove, char replace)
 	{
-		std::string result(str.cbegin(), str.cend());
-		for (char & i : result)
-		{
-			if (i == remove)
-			{
-				i = replace;
-			}
-		}
+		std::string result(str);
+		replaceCharacterInPlace(result, remove, replace);
 		return result;
 	}
 
 	std::string invertCase(const std::string & str)
 	{
-		std::string result;
-		for (char i : str)
-		{
-			if (isalpha(i))
-			{
-				if (i == tolower(i)) // 'i' is lower-case
-				{
-					result += toupper(i);
-				}
-				else // 'i' is upper-case
-				{
-					result += tolower(i);
-				}
-			}
-			else // 'i' is not a part of the alphabet. Upper/lower-case doesn't make sense for this character
-			{
-				result += i;
-			}
-		}
+		std::string result(str);
+		invertCaseInPlace(result);
 		return result;
 	}
 
@@ -123,7 +386,12 @@ namespace sp
 
 	std::string removeTrailingSpaces(const std::string & str)
 	{
-		return reverse(removeLeadingSpaces(reverse(str)));
+		std::size_t length = str.size();
+		while (length && isspace(static_cast<unsigned char>(str[length - 1])))
+		{
+			--length;
+		}
+		return str.substr(0, length);
 	}
 
 	bool startsWithCharacter(const std::string & str, char ch)
@@ -148,54 +416,286 @@ namespace sp
 		return str.size() == length;
 	}
 
-	template <class T>
-	std::string inflateList(const std::list<T> & list, const std::string & separator = ", ")
+	namespace FFPF // FormattingFunctionsPrivateFunctions
 	{
-		std::string result = std::accumulate(list.cbegin(), list.cend(), std::string(), [separator](const std::string & current, const T & val)
+		template <typename T>
+		constexpr bool isStringLike = std::is_convertible_v<const T &, std::string_view>;
+
+		template <typename T>
+		std::size_t joinedSize(const T & value)
 		{
-			return current + std::to_string(val) + separator;
-		});
-		if (result.size())
+			// Returns the number of characters 'value' takes up when joined. Exact for strings and characters,
+			// an upper bound for numbers.
+			if constexpr (isStringLike<T>)
+			{
+				return std::string_view(value).size();
+			}
+			else if constexpr (std::is_same_v<T, char>)
+			{
+				return 1;
+			}
+			else
+			{
+				static_assert(std::is_arithmetic_v<T>, "join can only format strings, characters and numbers");
+				return std::is_floating_point_v<T> ? 32 : std::numeric_limits<T>::digits10 + 3;
+			}
+		}
+
+		template <typename StringType, typename T>
+		void appendJoined(StringType & output, const T & value)
 		{
-			return std::string(result.begin(), result.begin() + result.size() - separator.size()); // Trim off the final separator
+			// Appends 'value' to 'output'. Numbers are written with std::to_chars, floating-point
+			// numbers in their shortest round-trip form.
+			if constexpr (isStringLike<T>)
+			{
+				output.append(std::string_view(value));
+			}
+			else if constexpr (std::is_same_v<T, char>)
+			{
+				output.push_back(value);
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+			{
+				output.push_back(value ? '1' : '0');
+			}
+			else
+			{
+				char buffer[64];
+				std::to_chars_result written = std::to_chars(buffer, buffer + sizeof(buffer), value);
+				output.append(buffer, written.ptr);
+			}
 		}
-		return result;
 	}
-	std::string inflateList(const std::list<std::string> & list, const std::string & separator = ", ")
+
+	template <typename StringType, typename IteratorType>
+	StringType & joinInto(StringType & output, IteratorType first, IteratorType last, std::string_view separator = ", ")
 	{
-		std::string result = std::accumulate(list.cbegin(), list.cend(), std::string(), [separator](const std::string & current, const std::string & val)
+		// Appends the elements of [first, last) to 'output' with 'separator' between them, and returns 'output'.
+		// For forward iterators the room needed is worked out first, so 'output' grows at most once.
+		typedef std::remove_cv_t<std::remove_reference_t<decltype(*first)>> ValueType;
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<IteratorType>::iterator_category>)
 		{
-			return current + val + separator;
-		});
-		if (result.size())
+			std::size_t size = 0;
+			std::size_t count = 0;
+			for (IteratorType i = first; i != last; ++i, ++count)
+			{
+				size += FFPF::joinedSize<ValueType>(*i);
+			}
+			if (count)
+			{
+				output.reserve(output.size() + size + (count - 1) * separator.size());
+			}
+		}
+		for (bool firstElement = true; first != last; ++first, firstElement = false)
 		{
-			return std::string(result.begin(), result.begin() + result.size() - separator.size()); // Trim off the final separator
+			if (!firstElement)
+			{
+				output.append(separator);
+			}
+			FFPF::appendJoined<StringType, ValueType>(output, *first);
 		}
-		return result;
+		return output;
 	}
 
-	std::list<std::string> splitString(const std::string & str, char separator = ',')
+	template <typename IteratorType>
+	std::string join(IteratorType first, IteratorType last, std::string_view separator = ", ")
 	{
-		std::list<std::string> result;
-		std::string::const_iterator iterator = str.cbegin();
-		std::string temp;
-		while (iterator != str.cend())
+		// Returns the elements of [first, last) with 'separator' between them
+		std::string result;
+		return joinInto(result, first, last, separator);
+	}
+
+	template <typename RangeType>
+	std::string join(const RangeType & range, std::string_view separator = ", ")
+	{
+		// Returns the elements of 'range' (any container, view or array) with 'separator' between them
+		std::string result;
+		return joinInto(result, std::begin(range), std::end(range), separator);
+	}
+
+	template <class T>
+	std::string inflateList(const std::list<T> & list, const std::string & separator = ", ")
+	{
+		if constexpr (std::is_floating_point_v<T> || std::is_same_v<T, char>)
 		{
-			if (*iterator != separator)
+			std::string result; // Keeps std::to_string's formatting, which join doesn't use for these types
+			for (auto i = list.cbegin(); i != list.cend(); ++i)
 			{
-				temp += *iterator;
+				if (i != list.cbegin())
+				{
+					result += separator;
+				}
+				result += std::to_string(*i);
 			}
-			else
+			return result;
+		}
+		else
+		{
+			return join(list, separator);
+		}
+	}
+	std::string inflateList(const std::list<std::string> & list, const std::string & separator = ", ")
+	{
+		return join(list, separator);
+	}
+
+	// Splits lines into fields without copying them: each field is a std::string_view into the line,
+	// so the line has to outlive the fields. Separators may be several characters long and are found
+	// with memchr. With a quote character set, a field that starts with it runs to the matching
+	// closing quote and may contain separators. The quotes are left out of the field, but a doubled quote
+	// inside it is not collapsed (see Tokenizer::unquote).
+	class Tokenizer
+	{
+	public:
+		typedef SmallVector<std::string_view, 16> Fields;
+	private:
+		std::string m_separator;
+		char        m_quote;
+		bool        m_quoted;
+		bool        m_keepEmptyLastField;
+	public:
+		explicit Tokenizer(char separator = ',') : m_separator(1, separator), m_quote('"'), m_quoted(false), m_keepEmptyLastField(true)
+		{
+		}
+		explicit Tokenizer(std::string_view separator) : m_separator(separator), m_quote('"'), m_quoted(false), m_keepEmptyLastField(true)
+		{
+			// An empty separator splits nothing: every line is a single field
+		}
+		Tokenizer & setQuote(char quote)
+		{
+			// Treats fields that start with 'quote' as quoted
+			m_quote = quote;
+			m_quoted = true;
+			return *this;
+		}
+		Tokenizer & clearQuote()
+		{
+			// Stops treating any character as a quote
+			m_quoted = false;
+			return *this;
+		}
+		Tokenizer & setKeepEmptyLastField(bool keep)
+		{
+			// Decides whether "a,b," is split into {"a", "b", ""} (the default) or {"a", "b"}
+			m_keepEmptyLastField = keep;
+			return *this;
+		}
+		std::size_t split(std::string_view line, Fields & fields) const
+		{
+			// Replaces the contents of 'fields' with the fields of 'line' and returns how many there are.
+			// An empty line has no fields.
+			fields.clear();
+			if (line.empty())
 			{
-				result.push_back(temp);
-				temp.clear();
+				return 0;
 			}
-			++iterator;
+			if (m_separator.empty())
+			{
+				fields.push_back(line);
+				return 1;
+			}
+			const char * first = line.data();
+			const char * last = first + line.size();
+			const char * fieldStart = first;
+			while (true)
+			{
+				const char * separator = nullptr;
+				if (m_quoted && fieldStart != last && *fieldStart == m_quote)
+				{
+					const char * closing = findClosingQuote(fieldStart + 1, last);
+					separator = findSeparator(closing == last ? last : closing + 1, last);
+					if (closing + 1 == separator || closing == last)
+					{
+						fields.push_back(std::string_view(fieldStart + 1, closing - fieldStart - 1));
+					}
+					else
+					{
+						fields.push_back(std::string_view(fieldStart, separator - fieldStart)); // Text after the closing quote, keep the field as it is
+					}
+				}
+				else
+				{
+					separator = findSeparator(fieldStart, last);
+					if (separator != last || fieldStart != last || m_keepEmptyLastField)
+					{
+						fields.push_back(std::string_view(fieldStart, separator - fieldStart));
+					}
+				}
+				if (separator == last)
+				{
+					break;
+				}
+				fieldStart = separator + m_separator.size();
+			}
+			return fields.size();
+		}
+		Fields      split(std::string_view line) const
+		{
+			// Returns the fields of 'line'
+			Fields fields;
+			split(line, fields);
+			return fields;
 		}
-		if (temp.size())
+		std::string unquote(std::string_view field) const
+		{
+			// Returns a quoted field with each doubled quote collapsed to one
+			std::string result;
+			result.reserve(field.size());
+			for (std::size_t i = 0; i < field.size(); ++i)
+			{
+				result += field[i];
+				if (field[i] == m_quote && i + 1 < field.size() && field[i + 1] == m_quote)
+				{
+					++i;
+				}
+			}
+			return result;
+		}
+	private:
+		const char * findSeparator(const char * first, const char * last) const
+		{
+			// Returns the start of the next separator in [first, last), or 'last'. A one-character separator
+			// is a single search; a longer one is checked wherever its first character turns up.
+			std::size_t length = m_separator.size();
+			if (length == 1)
+			{
+				return FFPF::findByte(first, last, m_separator[0]);
+			}
+			while ((first = FFPF::findByte(first, last, m_separator[0])) != last)
+			{
+				if (static_cast<std::size_t>(last - first) >= length && std::memcmp(first, m_separator.data(), length) == 0)
+				{
+					return first;
+				}
+				++first;
+			}
+			return last;
+		}
+		const char * findClosingQuote(const char * first, const char * last) const
+		{
+			// Returns the quote that closes a quoted field starting at 'first', skipping doubled quotes, or 'last'
+			while ((first = FFPF::findByte(first, last, m_quote)) != last)
+			{
+				if (first + 1 != last && first[1] == m_quote)
+				{
+					first += 2;
+					continue;
+				}
+				return first;
+			}
+			return last;
+		}
+	};
+
+	std::list<std::string> splitString(const std::string & str, char separator = ',')
+	{
+		std::list<std::string> result;
+		Tokenizer::Fields fields;
+		Tokenizer(separator).setKeepEmptyLastField(false).split(str, fields);
+		for (std::string_view i : fields)
 		{
-			result.push_back(temp);
+			result.emplace_back(i);
 		}
 		return result;
 	}
-}
\ No newline at end of file
+}
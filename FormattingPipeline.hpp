@@ -0,0 +1,277 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#include "FormattingFunctions.hpp"
+
+namespace sp
+{
+	// A Pipeline fuses several character-level formatting steps into a single pass over a line.
+	// sp::pipeline(stages::removeLeadingSpaces(), stages::removeTrailingSpaces(), stages::convertToLowerCase())
+	// reads each character once and hands it from stage to stage, so no intermediate strings are built.
+	// None of the stages ever output more characters than they have read, which lets a pipeline
+	// rewrite a line in place.
+	//
+	// A stage is any type providing:
+	//     struct State;                                                    - per-line state, default constructed at the start of each line
+	//     template <typename Next> void push(char, State &, Next &) const  - takes a character, calls next(ch) for each character it outputs
+	//     template <typename Next> void finish(State &, Next &) const      - called at the end of a line, outputs anything still held back
+	namespace stages
+	{
+		template <typename FunctionType>
+		class MapCharacters
+		{
+		private:
+			FunctionType m_function;
+		public:
+			struct State
+			{
+			};
+
+			explicit MapCharacters(FunctionType function) : m_function(std::move(function))
+			{
+			}
+			template <typename Next>
+			void push(char ch, State &, Next & next) const
+			{
+				next(static_cast<char>(m_function(ch)));
+			}
+			template <typename Next>
+			void finish(State &, Next &) const
+			{
+			}
+		};
+
+		template <typename PredicateType>
+		class RemoveCharactersIf
+		{
+		private:
+			PredicateType m_predicate;
+		public:
+			struct State
+			{
+			};
+
+			explicit RemoveCharactersIf(PredicateType predicate) : m_predicate(std::move(predicate))
+			{
+			}
+			template <typename Next>
+			void push(char ch, State &, Next & next) const
+			{
+				if (!m_predicate(ch))
+				{
+					next(ch);
+				}
+			}
+			template <typename Next>
+			void finish(State &, Next &) const
+			{
+			}
+		};
+
+		class RemoveLeadingSpaces
+		{
+		public:
+			struct State
+			{
+				bool started = false;
+			};
+
+			template <typename Next>
+			void push(char ch, State & state, Next & next) const
+			{
+				if (state.started || !FFPF::getCharacterTables().space[static_cast<unsigned char>(ch)])
+				{
+					state.started = true;
+					next(ch);
+				}
+			}
+			template <typename Next>
+			void finish(State &, Next &) const
+			{
+			}
+		};
+
+		class RemoveTrailingSpaces
+		{
+		public:
+			struct State
+			{
+				std::string pending; // The current run of whitespace, output only if something follows it
+			};
+
+			template <typename Next>
+			void push(char ch, State & state, Next & next) const
+			{
+				if (FFPF::getCharacterTables().space[static_cast<unsigned char>(ch)])
+				{
+					state.pending += ch;
+					return;
+				}
+				for (char i : state.pending)
+				{
+					next(i);
+				}
+				state.pending.clear();
+				next(ch);
+			}
+			template <typename Next>
+			void finish(State &, Next &) const
+			{
+				// Whatever is still pending is trailing whitespace, so it's dropped
+			}
+		};
+
+		template <typename FunctionType>
+		MapCharacters<FunctionType> mapCharacters(FunctionType function)
+		{
+			// Replaces each character 'ch' with function(ch)
+			return MapCharacters<FunctionType>(std::move(function));
+		}
+
+		template <typename PredicateType>
+		RemoveCharactersIf<PredicateType> removeCharactersIf(PredicateType predicate)
+		{
+			// Drops each character 'ch' for which predicate(ch) == true
+			return RemoveCharactersIf<PredicateType>(std::move(predicate));
+		}
+
+		inline auto convertToLowerCase()
+		{
+			return mapCharacters([](char ch) { return FFPF::getCharacterTables().lower[static_cast<unsigned char>(ch)]; });
+		}
+
+		inline auto convertToUpperCase()
+		{
+			return mapCharacters([](char ch) { return FFPF::getCharacterTables().upper[static_cast<unsigned char>(ch)]; });
+		}
+
+		inline auto invertCase()
+		{
+			return mapCharacters([](char ch) { return FFPF::getCharacterTables().invert[static_cast<unsigned char>(ch)]; });
+		}
+
+		inline auto replaceCharacter(char remove, char replace)
+		{
+			return mapCharacters([remove, replace](char ch) { return ch == remove ? replace : ch; });
+		}
+
+		inline auto removePunctuation()
+		{
+			return removeCharactersIf([](char ch) { return FFPF::getCharacterTables().punctuation[static_cast<unsigned char>(ch)]; });
+		}
+
+		inline auto removeSpaces()
+		{
+			return removeCharactersIf([](char ch) { return FFPF::getCharacterTables().space[static_cast<unsigned char>(ch)]; });
+		}
+
+		inline auto removeCharacter(char remove)
+		{
+			return removeCharactersIf([remove](char ch) { return ch == remove; });
+		}
+
+		inline RemoveLeadingSpaces removeLeadingSpaces()
+		{
+			return RemoveLeadingSpaces();
+		}
+
+		inline RemoveTrailingSpaces removeTrailingSpaces()
+		{
+			return RemoveTrailingSpaces();
+		}
+	}
+
+	template <typename... Stages>
+	class Pipeline
+	{
+	private:
+		typedef std::tuple<typename Stages::State...> States;
+
+		std::tuple<Stages...> m_stages;
+	public:
+		explicit Pipeline(Stages... stages) : m_stages(std::move(stages)...)
+		{
+		}
+		std::size_t run(const char * first, const char * last, char * output) const
+		{
+			// Passes [first, last) through every stage and writes the result to 'output', which may be 'first'.
+			// Returns the number of characters written, which is never more than last - first.
+			States states;
+			std::size_t written = 0;
+			auto sink = [output, &written](char ch)
+			{
+				output[written++] = ch;
+			};
+			for (; first != last; ++first)
+			{
+				push<0>(*first, states, sink);
+			}
+			finish<0>(states, sink);
+			return written;
+		}
+		template <typename StringType>
+		void apply(StringType & str) const
+		{
+			// Runs the pipeline over 'str' in place
+			str.resize(run(str.data(), str.data() + str.size(), str.data()));
+		}
+		std::string operator () (std::string_view str) const
+		{
+			// Returns the result of running the pipeline over 'str'
+			std::string result(str.size(), '\0');
+			result.resize(run(str.data(), str.data() + str.size(), result.data()));
+			return result;
+		}
+		template <typename StringType, typename = std::enable_if_t<!std::is_same_v<StringType, std::string_view> && !std::is_convertible_v<const StringType &, const char *>>>
+		StringType operator () (const StringType & str) const
+		{
+			// Returns the result of running the pipeline over 'str' as the same type of string
+			StringType result(str);
+			apply(result);
+			return result;
+		}
+	private:
+		template <std::size_t Index, typename Sink>
+		void push(char ch, States & states, Sink & sink) const
+		{
+			if constexpr (Index == sizeof...(Stages))
+			{
+				sink(ch);
+			}
+			else
+			{
+				auto next = [this, &states, &sink](char output)
+				{
+					push<Index + 1>(output, states, sink);
+				};
+				std::get<Index>(m_stages).push(ch, std::get<Index>(states), next);
+			}
+		}
+		template <std::size_t Index, typename Sink>
+		void finish(States & states, Sink & sink) const
+		{
+			if constexpr (Index < sizeof...(Stages))
+			{
+				// Whatever a stage releases at the end of the line still has to go through the stages after it
+				auto next = [this, &states, &sink](char output)
+				{
+					push<Index + 1>(output, states, sink);
+				};
+				std::get<Index>(m_stages).finish(std::get<Index>(states), next);
+				finish<Index + 1>(states, sink);
+			}
+		}
+	};
+
+	template <typename... Stages>
+	Pipeline<Stages...> pipeline(Stages... stages)
+	{
+		// Fuses 'stages' into a single pass, applied to each line in the order given
+		return Pipeline<Stages...>(std::move(stages)...);
+	}
+}
@@ -0,0 +1,489 @@
+#pragma once
+
+#include <fstream>
+#include <deque>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+
+#include "FileWrapper.hpp"
+
+namespace sp
+{
+	namespace FWPF // FileWrapperPrivateFunctions
+	{
+		inline std::size_t heapBytes(const std::string & str)
+		{
+			// Returns the number of bytes 'str' holds outside of its own object (none for short strings)
+			static const std::size_t inlineCapacity = std::string().capacity();
+			return str.capacity() > inlineCapacity ? str.capacity() + 1 : 0;
+		}
+
+		struct DereferenceLine
+		{
+			// Turns a pooled line pointer into the line, for views over an InternedFileWrapper
+			const std::string & operator () (const std::string * line) const
+			{
+				return *line;
+			}
+		};
+	}
+
+	// A deduplicating store of immutable strings. Interning the same text twice returns the same
+	// pointer, so interned strings can be compared by address. Strings are never modified or freed
+	// until the pool is destroyed, even once nothing points at them. A pool is not thread-safe, so
+	// objects sharing one mustn't be used from different threads at the same time.
+	class StringPool final
+	{
+	private:
+		std::deque<std::string>                                   m_strings; // A deque never moves its elements, so pointers stay valid
+		std::unordered_map<std::string_view, const std::string *> m_lookup;
+		std::size_t                                               m_heapBytes;
+	public:
+		StringPool() : m_heapBytes(0)
+		{
+			// Creates an empty pool
+		}
+		StringPool(const StringPool &) = delete;
+		StringPool & operator = (const StringPool &) = delete;
+		const std::string * intern(std::string_view str)
+		{
+			// Returns the pooled copy of 'str', adding it to the pool if it isn't there yet
+			auto found = m_lookup.find(str);
+			if (found != m_lookup.end())
+			{
+				return found->second;
+			}
+			m_strings.emplace_back(str);
+			m_heapBytes += FWPF::heapBytes(m_strings.back());
+			m_lookup.emplace(m_strings.back(), &m_strings.back());
+			return &m_strings.back();
+		}
+		std::size_t size() const
+		{
+			// Returns the number of distinct strings in the pool
+			return m_strings.size();
+		}
+		std::size_t getStoredBytes() const
+		{
+			// Returns an estimate of the memory held by the pool, including its lookup table
+			return m_strings.size() * sizeof(std::string) + m_heapBytes
+				+ m_lookup.bucket_count() * sizeof(void *)
+				+ m_lookup.size() * (sizeof(std::string_view) + 2 * sizeof(void *) + sizeof(std::size_t));
+		}
+	};
+
+	struct InternStatistics
+	{
+		std::size_t lineCount;       // Number of lines in the file
+		std::size_t uniqueLineCount; // Number of distinct lines in the file
+		std::size_t logicalBytes;    // Estimated memory the lines would need in a FileWrapper
+		std::size_t storedBytes;     // Estimated memory the lines and their pool actually use
+		std::size_t savedBytes;      // logicalBytes - storedBytes, or 0 if deduplication didn't pay off
+	};
+
+	// A FileWrapper-like container whose lines live in a StringPool, so identical lines share a single
+	// buffer. Lines are immutable: setLine, appendToLine and prependToLine intern the new text and point
+	// the line at it (copy-on-write), leaving every other line that shared the old text untouched.
+	// The text of removed and replaced lines stays in the pool until compact() is called.
+	// Each object has a pool of its own, copies included, unless a pool is passed in explicitly.
+	// Several InternedFileWrappers can then share one pool, in which case lines are compared by
+	// address across all of them as well, but they mustn't be used from different threads at once.
+	class InternedFileWrapper final
+	{
+	public:
+		typedef std::vector<const std::string *> File;
+		typedef File::const_iterator              ConstIterator;
+	private:
+		std::shared_ptr<StringPool> m_pool;
+		File                        m_contents;
+		std::string                 m_filename;
+		FileCloseAction             m_closingAction;
+	public:
+		// Constructors
+		InternedFileWrapper() : m_pool(std::make_shared<StringPool>()), m_closingAction(FileCloseAction::NONE)
+		{
+			// Creates an empty InternedFileWrapper object with a pool of its own
+		}
+		explicit InternedFileWrapper(std::shared_ptr<StringPool> pool, FileCloseAction closingAction = FileCloseAction::NONE) : m_pool(std::move(pool)), m_closingAction(closingAction)
+		{
+			// Creates an empty InternedFileWrapper object that interns into 'pool'
+		}
+		explicit InternedFileWrapper(const std::string & filename, FileCloseAction closingAction = FileCloseAction::NONE) : m_pool(std::make_shared<StringPool>()), m_filename(filename), m_closingAction(closingAction)
+		{
+			// Opens and loads a file into memory
+			loadFromFile(filename);
+		}
+		explicit InternedFileWrapper(const FileWrapper & file) : m_pool(std::make_shared<StringPool>()), m_filename(file.getFilename()), m_closingAction(FileCloseAction::NONE)
+		{
+			// Interns the contents of a FileWrapper object. The closing action is not copied, so the
+			// file isn't written twice when both objects are destroyed.
+			m_contents.reserve(file.size());
+			for (const std::string & i : file.getContents())
+			{
+				m_contents.push_back(m_pool->intern(i));
+			}
+		}
+		InternedFileWrapper(const InternedFileWrapper & rhs) : m_pool(std::make_shared<StringPool>()), m_filename(rhs.m_filename), m_closingAction(rhs.m_closingAction)
+		{
+			// Copies the lines of one InternedFileWrapper object to another. The copy gets a pool of its
+			// own holding only the lines in use, so it can be used on another thread than 'rhs'.
+			copyLines(rhs);
+		}
+		InternedFileWrapper(const InternedFileWrapper & rhs, std::shared_ptr<StringPool> pool) : m_pool(std::move(pool)), m_filename(rhs.m_filename), m_closingAction(rhs.m_closingAction)
+		{
+			// Copies the lines of one InternedFileWrapper object to another that interns into 'pool'.
+			// Passing rhs.getPool() shares the pool with 'rhs', and then the lines aren't copied at all.
+			copyLines(rhs);
+		}
+		InternedFileWrapper(InternedFileWrapper && rhs) : m_pool(std::move(rhs.m_pool)), m_contents(std::move(rhs.m_contents)), m_filename(std::move(rhs.m_filename)), m_closingAction(rhs.m_closingAction)
+		{
+			// Move constructor. The pool moves with the lines and 'rhs' is left with an empty pool, so the two
+			// don't share one. rhs is left with no closing action so it can't overwrite the file with nothing.
+			rhs.m_pool = std::make_shared<StringPool>();
+			rhs.m_closingAction = FileCloseAction::NONE;
+		}
+		// Destructor
+		~InternedFileWrapper()
+		{
+			switch (m_closingAction)
+			{
+			case FileCloseAction::OUTPUT:
+			{
+				outputToFile();
+				break;
+			}
+			case FileCloseAction::APPEND:
+			{
+				appendToFile();
+				break;
+			}
+			default:
+			{
+				break;
+			}
+			}
+		}
+		// Accessors
+		const std::string & getLine(std::size_t index) const
+		{
+			// Returns a line in the file if it exists. Otherwise returns a blank string.
+			return index < size() ? *m_contents[index] : emptyLine();
+		}
+		const std::string & getFirstLine() const
+		{
+			// If the file has a first line, returns it. Otherwise returns a blank string.
+			return getLine(0);
+		}
+		const std::string & getLastLine() const
+		{
+			// If the file has a last line, returns it. Otherwise returns a blank string.
+			return size() ? *m_contents.back() : emptyLine();
+		}
+		std::string_view    getLineView(std::size_t index) const
+		{
+			// Returns a view of a line in the file if it exists. Otherwise returns an empty view.
+			return getLine(index);
+		}
+		TransformView<LineView<ConstIterator>, FWPF::DereferenceLine> lines() const
+		{
+			// Returns a lazy view of every line in the file. See LineViews.hpp.
+			return LineView<ConstIterator>(m_contents.cbegin(), m_contents.cend()).transform(FWPF::DereferenceLine());
+		}
+		const std::string & getFilename() const
+		{
+			// Returns the name of the file associated with the object
+			return m_filename;
+		}
+		FileCloseAction     getClosingAction() const
+		{
+			// Returns the action that will occur upon destruction
+			return m_closingAction;
+		}
+		const std::shared_ptr<StringPool> & getPool() const
+		{
+			// Returns the pool the lines are interned in
+			return m_pool;
+		}
+		InternStatistics    getStatistics() const
+		{
+			// Reports how much memory deduplication saves compared to storing every line separately
+			InternStatistics result;
+			result.lineCount = size();
+			result.uniqueLineCount = countUniqueLines();
+			result.logicalBytes = size() * sizeof(std::string);
+			for (const std::string * i : m_contents)
+			{
+				result.logicalBytes += FWPF::heapBytes(*i);
+			}
+			result.storedBytes = size() * sizeof(const std::string *) + m_pool->getStoredBytes();
+			result.savedBytes = result.logicalBytes > result.storedBytes ? result.logicalBytes - result.storedBytes : 0;
+			return result;
+		}
+		FileWrapper         toFileWrapper() const
+		{
+			// Returns the lines as an ordinary FileWrapper object
+			FileWrapper result;
+			result.setFilename(m_filename);
+			lines().appendTo(result);
+			return result;
+		}
+		// Mutators
+		void setFilename(const std::string & filename)
+		{
+			// Sets the name of the file associated with the object to the string 'filename'
+			m_filename = filename;
+		}
+		void setClosingAction(FileCloseAction closingAction)
+		{
+			// Changes the closing action of the object to the one specified by 'closingAction'
+			m_closingAction = closingAction;
+		}
+		void setLine(std::size_t index, std::string_view str)
+		{
+			// Points line[index] at the pooled copy of 'str'
+			if (index < size())
+			{
+				m_contents[index] = m_pool->intern(str);
+			}
+		}
+		void appendLine(std::string_view str)
+		{
+			// Places a line at the end of the file
+			m_contents.push_back(m_pool->intern(str));
+		}
+		void emplaceLine(std::string_view str)
+		{
+			// Places a line at the end of the file. Provided so views can append to either kind of file.
+			appendLine(str);
+		}
+		void appendToLine(std::size_t index, std::string_view str)
+		{
+			// Append the contents of str to the indexth line of the file
+			if (index < size())
+			{
+				std::string line(*m_contents[index]);
+				line.append(str);
+				m_contents[index] = m_pool->intern(line);
+			}
+		}
+		void prependLine(std::string_view str)
+		{
+			// Inserts a line at the beginning of the file
+			m_contents.insert(m_contents.begin(), m_pool->intern(str));
+		}
+		void prependToLine(std::size_t index, std::string_view str)
+		{
+			// Prepend the contents of str to the indexth line of the file
+			if (index < size())
+			{
+				std::string line(str);
+				line.append(*m_contents[index]);
+				m_contents[index] = m_pool->intern(line);
+			}
+		}
+		void insertLine(std::size_t index, std::string_view str)
+		{
+			// Inserts a line before the given index
+			if (index < size())
+			{
+				m_contents.insert(m_contents.begin() + index, m_pool->intern(str));
+			}
+		}
+		void removeLine(std::size_t index)
+		{
+			// Removes a line from the file. Its text stays in the pool until compact() is called.
+			if (index < size())
+			{
+				m_contents.erase(m_contents.begin() + index);
+			}
+		}
+		void removeLines(std::size_t lowerBound, std::size_t upperBound)
+		{
+			// Removes the lines in [lowerBound, upperBound]
+			FWPF::validateBounds(lowerBound, upperBound);
+			if (lowerBound < size())
+			{
+				m_contents.erase(m_contents.begin() + lowerBound, m_contents.begin() + 1 + std::min(upperBound, size() - 1));
+			}
+		}
+		void clearContents()
+		{
+			// Erases every line in the file. The pool keeps their strings until compact() is called.
+			m_contents.clear();
+		}
+		void compact()
+		{
+			// Moves the lines into a fresh pool holding only the strings still in use. Other objects
+			// that shared the old pool keep it, and no longer share a pool with this object.
+			std::shared_ptr<StringPool> pool = std::make_shared<StringPool>();
+			for (const std::string * & i : m_contents)
+			{
+				i = pool->intern(*i);
+			}
+			m_pool = std::move(pool);
+		}
+		// Utilities
+		bool        empty() const
+		{
+			// Returns true if empty, otherwise returns false.
+			return m_contents.empty();
+		}
+		std::size_t size() const
+		{
+			// Returns the number of lines held by the object
+			return m_contents.size();
+		}
+		std::size_t lineSize(std::size_t index) const
+		{
+			// Returns the size of a line in the file if the line exists, otherwise returns 0
+			return index < size() ? m_contents[index]->size() : 0;
+		}
+		bool        linesAreEqual(std::size_t lhs, std::size_t rhs) const
+		{
+			// Returns true if both lines exist and hold the same text. Costs one pointer comparison.
+			return lhs < size() && rhs < size() && m_contents[lhs] == m_contents[rhs];
+		}
+		std::size_t countUniqueLines() const
+		{
+			// Returns the number of distinct lines in the file, comparing lines by address
+			File sorted(m_contents);
+			std::sort(sorted.begin(), sorted.end());
+			return std::unique(sorted.begin(), sorted.end()) - sorted.begin();
+		}
+		void        loadFromFile()
+		{
+			// Clears the contents of the object, then loads in the data from the file specified by m_filename
+			loadFromFile(m_filename);
+		}
+		void        loadFromFile(const std::string & filename)
+		{
+			// Clears the contents of the object, then loads in the data from the file specified by 'filename'
+			clearContents();
+			loadFromFileAndAppend(filename);
+		}
+		void        loadFromFileAndAppend(const std::string & filename)
+		{
+			// Loads the data from the file specified by 'filename' and appends it to the current lines.
+			// Lines that are already in the pool cost no allocation.
+			FWPF::forEachLineInFile(filename, [this](std::string_view line)
+			{
+				m_contents.push_back(m_pool->intern(line));
+			});
+		}
+		void        outputToStream(std::ostream & ostr) const
+		{
+			// Output the contents of the file to a std::ostream if the stream is valid
+			lines().outputToStream(ostr);
+		}
+		void        outputToFile() const
+		{
+			// Clears the file specified by m_filename, then outputs the lines to it
+			lines().outputToFile(m_filename);
+		}
+		void        outputToFile(const std::string & filename) const
+		{
+			// Clears the file specified by 'filename', then outputs the lines to it
+			lines().outputToFile(filename);
+		}
+		void        appendToFile() const
+		{
+			// Appends the lines to the file specified by m_filename
+			lines().appendToFile(m_filename);
+		}
+		void        appendToFile(const std::string & filename) const
+		{
+			// Appends the lines to the file specified by 'filename'
+			lines().appendToFile(filename);
+		}
+		// Iterators
+		ConstIterator cbegin() const
+		{
+			// Return a const iterator to the pointer to the first line
+			return m_contents.cbegin();
+		}
+		ConstIterator cend() const
+		{
+			// Return a const iterator past the pointer to the last line
+			return m_contents.cend();
+		}
+		// Overloaded Operators
+		InternedFileWrapper & operator =  (const InternedFileWrapper & rhs)
+		{
+			// Copy assignment operator. As with the copy constructor, the lines are copied into a new pool.
+			if (this != &rhs)
+			{
+				m_pool = std::make_shared<StringPool>();
+				copyLines(rhs);
+				m_filename = rhs.m_filename;
+				m_closingAction = rhs.m_closingAction;
+			}
+			return *this;
+		}
+		InternedFileWrapper & operator =  (InternedFileWrapper && rhs)
+		{
+			// Move assignment operator. rhs is left with an empty pool and no closing action.
+			if (this != &rhs)
+			{
+				m_pool = std::move(rhs.m_pool);
+				m_contents = std::move(rhs.m_contents);
+				m_filename = std::move(rhs.m_filename);
+				m_closingAction = rhs.m_closingAction;
+				rhs.m_pool = std::make_shared<StringPool>();
+				rhs.m_contents.clear();
+				rhs.m_closingAction = FileCloseAction::NONE;
+			}
+			return *this;
+		}
+		bool                  operator == (const InternedFileWrapper & rhs) const
+		{
+			// Returns true if all the components are equal. Lines from a shared pool are compared by address.
+			if (size() != rhs.size() || m_filename != rhs.m_filename || m_closingAction != rhs.m_closingAction)
+			{
+				return false;
+			}
+			if (m_pool == rhs.m_pool)
+			{
+				return m_contents == rhs.m_contents;
+			}
+			return std::equal(m_contents.begin(), m_contents.end(), rhs.m_contents.begin(), [](const std::string * left, const std::string * right)
+			{
+				return *left == *right;
+			});
+		}
+		bool                  operator != (const InternedFileWrapper & rhs) const
+		{
+			// Returns true if any of the components are not equal
+			return !(*this == rhs);
+		}
+		const std::string &   operator [] (std::size_t index) const
+		{
+			// Doesn't perform any bounds checking, leaves that to the container
+			return *m_contents.at(index);
+		}
+	private:
+		void copyLines(const InternedFileWrapper & rhs)
+		{
+			// Points the lines at rhs's lines as interned in this object's pool
+			if (m_pool == rhs.m_pool)
+			{
+				m_contents = rhs.m_contents;
+				return;
+			}
+			m_contents.clear();
+			m_contents.reserve(rhs.size());
+			for (const std::string * i : rhs.m_contents)
+			{
+				m_contents.push_back(m_pool->intern(*i));
+			}
+		}
+		static const std::string & emptyLine()
+		{
+			static const std::string empty;
+			return empty;
+		}
+	};
+}
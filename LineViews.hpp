@@ -0,0 +1,397 @@
+#pragma once
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+
+#include "CommonFunctions.hpp"
+
+namespace sp
+{
+	// Lazy views over a range of lines. Nothing is copied or evaluated until the view is iterated,
+	// and each step (slice, filter, transform) only wraps the view before it, so chains such as
+	// file.lines().slice(10, 20).filter(isComment).transform(removeLeadingSpaces) cost nothing until used.
+	// A view refers to the lines it was made from; it is invalidated by anything that would
+	// invalidate an iterator into those lines.
+	namespace FWPF // FileWrapperPrivateFunctions
+	{
+		struct StringViewOf
+		{
+			// Turns a line into a std::string_view of it, for views that should hand out views
+			template <typename StringType>
+			std::string_view operator () (const StringType & str) const
+			{
+				return str;
+			}
+		};
+	}
+
+	template <typename BaseType>
+	class SliceView;
+	template <typename BaseType, typename PredicateType>
+	class FilterView;
+	template <typename BaseType, typename FunctionType>
+	class TransformView;
+
+	template <typename Derived>
+	class LineViewInterface
+	{
+	public:
+		// Composition
+		SliceView<Derived> slice(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Returns a view of the lines at positions [lowerBound, upperBound] of this view
+			return SliceView<Derived>(derived(), lowerBound, upperBound);
+		}
+		template <typename PredicateType>
+		FilterView<Derived, PredicateType> filter(PredicateType predicate) const
+		{
+			// Returns a view of the lines for which predicate(line) == true
+			return FilterView<Derived, PredicateType>(derived(), std::move(predicate));
+		}
+		template <typename FunctionType>
+		TransformView<Derived, FunctionType> transform(FunctionType function) const
+		{
+			// Returns a view of function(line) for each line
+			return TransformView<Derived, FunctionType>(derived(), std::move(function));
+		}
+		// Utilities
+		bool        empty() const
+		{
+			// Returns true if the view has no lines
+			return !(derived().begin() != derived().end());
+		}
+		std::size_t count() const
+		{
+			// Returns the number of lines in the view. Evaluates the whole view.
+			std::size_t result = 0;
+			for (auto iterator = derived().begin(); iterator != derived().end(); ++iterator)
+			{
+				++result;
+			}
+			return result;
+		}
+		template <typename ContainerType = std::vector<std::string>>
+		ContainerType collect() const
+		{
+			// Evaluates the view and returns its lines as a new container
+			ContainerType result;
+			for (auto iterator = derived().begin(); iterator != derived().end(); ++iterator)
+			{
+				result.emplace_back(*iterator);
+			}
+			return result;
+		}
+		template <typename FileType>
+		void        appendTo(FileType & file) const
+		{
+			// Evaluates the view and appends each line to 'file' (e.g. a FileWrapper). Lines produced by
+			// a transform are moved into the file rather than copied.
+			for (auto iterator = derived().begin(); iterator != derived().end(); ++iterator)
+			{
+				file.emplaceLine(*iterator);
+			}
+		}
+		void        outputToStream(std::ostream & ostr) const
+		{
+			// Evaluates the view and writes each line to 'ostr' if the stream is valid
+			for (auto iterator = derived().begin(); iterator != derived().end() && ostr.good(); ++iterator)
+			{
+				ostr << *iterator << '\n';
+			}
+		}
+		void        outputToFile(const std::string & filename) const
+		{
+			// Clears the file 'filename', then writes the lines of the view to it
+			std::fstream file(filename, std::ios::out);
+			if (file.is_open())
+			{
+				outputToStream(file);
+			}
+		}
+		void        appendToFile(const std::string & filename) const
+		{
+			// Appends the lines of the view to the file 'filename'
+			std::fstream file(filename, std::ios::out | std::ios::app);
+			if (file.is_open())
+			{
+				outputToStream(file);
+			}
+		}
+	private:
+		const Derived & derived() const
+		{
+			return static_cast<const Derived &>(*this);
+		}
+	};
+
+	template <typename IteratorType>
+	class LineView final : public LineViewInterface<LineView<IteratorType>>
+	{
+	private:
+		IteratorType m_first;
+		IteratorType m_last;
+	public:
+		typedef IteratorType iterator;
+
+		LineView(IteratorType first, IteratorType last) : m_first(first), m_last(last)
+		{
+			// Creates a view of the lines in [first, last)
+		}
+		IteratorType begin() const
+		{
+			return m_first;
+		}
+		IteratorType end() const
+		{
+			return m_last;
+		}
+		std::size_t  size() const
+		{
+			// Returns the number of lines in the view
+			return static_cast<std::size_t>(std::distance(m_first, m_last));
+		}
+		std::size_t  count() const
+		{
+			return size();
+		}
+		decltype(auto) operator [] (std::size_t index) const
+		{
+			// Doesn't perform any bounds checking
+			return *std::next(m_first, index);
+		}
+		LineView     slice(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Returns the lines at positions [lowerBound, upperBound] without wrapping the view
+			FWPF::validateBounds(lowerBound, upperBound);
+			std::size_t total = size();
+			lowerBound = std::min(lowerBound, total);
+			upperBound = upperBound < total ? upperBound + 1 : total;
+			return LineView(std::next(m_first, lowerBound), std::next(m_first, upperBound));
+		}
+	};
+
+	template <typename BaseType>
+	class SliceView final : public LineViewInterface<SliceView<BaseType>>
+	{
+	private:
+		typedef decltype(std::declval<const BaseType &>().begin()) BaseIterator;
+
+		BaseType    m_base;
+		std::size_t m_lowerBound;
+		std::size_t m_upperBound;
+	public:
+		class iterator
+		{
+		private:
+			BaseIterator m_current;
+			BaseIterator m_end;
+			std::size_t  m_remaining;
+		public:
+			typedef std::forward_iterator_tag                                      iterator_category;
+			typedef decltype(*std::declval<BaseIterator &>())                      reference;
+			typedef std::remove_cv_t<std::remove_reference_t<reference>>           value_type;
+			typedef std::ptrdiff_t                                                 difference_type;
+			typedef void                                                           pointer;
+
+			iterator(BaseIterator current, BaseIterator end, std::size_t remaining) : m_current(current), m_end(end), m_remaining(remaining)
+			{
+			}
+			reference  operator *  () const
+			{
+				return *m_current;
+			}
+			iterator & operator ++ ()
+			{
+				++m_current;
+				--m_remaining;
+				return *this;
+			}
+			iterator   operator ++ (int)
+			{
+				iterator result = *this;
+				++*this;
+				return result;
+			}
+			bool       operator == (const iterator & rhs) const
+			{
+				return done() || rhs.done() ? done() == rhs.done() : m_current == rhs.m_current;
+			}
+			bool       operator != (const iterator & rhs) const
+			{
+				return !(*this == rhs);
+			}
+		private:
+			bool       done() const
+			{
+				return m_remaining == 0 || m_current == m_end;
+			}
+		};
+
+		SliceView(const BaseType & base, std::size_t lowerBound, std::size_t upperBound) : m_base(base), m_lowerBound(lowerBound), m_upperBound(upperBound)
+		{
+			// Creates a view of the lines at positions [lowerBound, upperBound] of 'base'
+			FWPF::validateBounds(m_lowerBound, m_upperBound);
+		}
+		iterator begin() const
+		{
+			BaseIterator current = m_base.begin();
+			BaseIterator last = m_base.end();
+			for (std::size_t i = 0; i < m_lowerBound && current != last; ++i)
+			{
+				++current;
+			}
+			std::size_t remaining = m_upperBound - m_lowerBound;
+			return iterator(current, last, remaining == std::size_t(-1) ? remaining : remaining + 1);
+		}
+		iterator end() const
+		{
+			return iterator(m_base.end(), m_base.end(), 0);
+		}
+	};
+
+	template <typename BaseType, typename PredicateType>
+	class FilterView final : public LineViewInterface<FilterView<BaseType, PredicateType>>
+	{
+	private:
+		typedef decltype(std::declval<const BaseType &>().begin()) BaseIterator;
+
+		BaseType      m_base;
+		PredicateType m_predicate;
+	public:
+		class iterator
+		{
+		private:
+			BaseIterator          m_current;
+			BaseIterator          m_end;
+			const PredicateType * m_predicate;
+		public:
+			typedef std::forward_iterator_tag                                      iterator_category;
+			typedef decltype(*std::declval<BaseIterator &>())                      reference;
+			typedef std::remove_cv_t<std::remove_reference_t<reference>>           value_type;
+			typedef std::ptrdiff_t                                                 difference_type;
+			typedef void                                                           pointer;
+
+			iterator(BaseIterator current, BaseIterator end, const PredicateType * predicate) : m_current(current), m_end(end), m_predicate(predicate)
+			{
+				skip();
+			}
+			reference  operator *  () const
+			{
+				return *m_current;
+			}
+			iterator & operator ++ ()
+			{
+				++m_current;
+				skip();
+				return *this;
+			}
+			iterator   operator ++ (int)
+			{
+				iterator result = *this;
+				++*this;
+				return result;
+			}
+			bool       operator == (const iterator & rhs) const
+			{
+				return m_current == rhs.m_current;
+			}
+			bool       operator != (const iterator & rhs) const
+			{
+				return !(m_current == rhs.m_current);
+			}
+		private:
+			void       skip()
+			{
+				// Moves forward to the next line accepted by the predicate
+				while (m_current != m_end && !(*m_predicate)(*m_current))
+				{
+					++m_current;
+				}
+			}
+		};
+
+		FilterView(const BaseType & base, PredicateType predicate) : m_base(base), m_predicate(std::move(predicate))
+		{
+			// Creates a view of the lines of 'base' for which predicate(line) == true
+		}
+		iterator begin() const
+		{
+			return iterator(m_base.begin(), m_base.end(), &m_predicate);
+		}
+		iterator end() const
+		{
+			return iterator(m_base.end(), m_base.end(), &m_predicate);
+		}
+	};
+
+	template <typename BaseType, typename FunctionType>
+	class TransformView final : public LineViewInterface<TransformView<BaseType, FunctionType>>
+	{
+	private:
+		typedef decltype(std::declval<const BaseType &>().begin()) BaseIterator;
+
+		BaseType     m_base;
+		FunctionType m_function;
+	public:
+		class iterator
+		{
+		private:
+			BaseIterator         m_current;
+			const FunctionType * m_function;
+		public:
+			typedef std::input_iterator_tag                                                             iterator_category;
+			typedef decltype(std::declval<const FunctionType &>()(*std::declval<BaseIterator &>()))    reference;
+			typedef std::remove_cv_t<std::remove_reference_t<reference>>                                value_type;
+			typedef std::ptrdiff_t                                                                      difference_type;
+			typedef void                                                                                pointer;
+
+			iterator(BaseIterator current, const FunctionType * function) : m_current(current), m_function(function)
+			{
+			}
+			reference  operator *  () const
+			{
+				// The function is called every time the iterator is dereferenced
+				return (*m_function)(*m_current);
+			}
+			iterator & operator ++ ()
+			{
+				++m_current;
+				return *this;
+			}
+			iterator   operator ++ (int)
+			{
+				iterator result = *this;
+				++m_current;
+				return result;
+			}
+			bool       operator == (const iterator & rhs) const
+			{
+				return m_current == rhs.m_current;
+			}
+			bool       operator != (const iterator & rhs) const
+			{
+				return !(m_current == rhs.m_current);
+			}
+		};
+
+		TransformView(const BaseType & base, FunctionType function) : m_base(base), m_function(std::move(function))
+		{
+			// Creates a view of function(line) for each line of 'base'
+		}
+		iterator begin() const
+		{
+			return iterator(m_base.begin(), &m_function);
+		}
+		iterator end() const
+		{
+			return iterator(m_base.end(), &m_function);
+		}
+	};
+}
@@ -0,0 +1,716 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <cmath>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "CompactNumericFile.hpp"
+
+namespace fileFunctions
+{
+	enum class AccessPattern
+	{
+		NORMAL, // No particular order
+		SEQUENTIAL, // Mostly front to back, so the kernel can read ahead aggressively and drop pages behind
+		RANDOM, // Scattered, so reading ahead would be wasted
+		WILL_NEED // All of it soon, so start reading it in now
+	};
+
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		// A read-only, shared memory mapping of a whole file. Every process that maps the same file shares the
+		// same pages of the page cache, so the data is only held in memory once.
+		class MappedRegion
+		{
+		private:
+			const char * data;
+			std::size_t  length;
+#if defined(_WIN32)
+			HANDLE       mapping;
+#endif
+		public:
+			MappedRegion() : data(nullptr), length(0)
+#if defined(_WIN32)
+				, mapping(nullptr)
+#endif
+			{
+			}
+			MappedRegion(const MappedRegion &) = delete;
+			MappedRegion(MappedRegion && rhs) noexcept : MappedRegion()
+			{
+				swap(rhs);
+			}
+			~MappedRegion()
+			{
+				unmap();
+			}
+			MappedRegion & operator = (const MappedRegion &) = delete;
+			MappedRegion & operator = (MappedRegion && rhs) noexcept
+			{
+				MappedRegion moved(std::move(rhs));
+				swap(moved);
+				return *this;
+			}
+			bool map(const std::string & filePath)
+			{
+				// Maps the file 'filePath', replacing any previous mapping. Returns false if the file couldn't be
+				// opened or mapped, or is empty.
+				unmap();
+#if defined(_WIN32)
+				HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+				if (file == INVALID_HANDLE_VALUE)
+				{
+					return false;
+				}
+				LARGE_INTEGER size;
+				if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+				{
+					mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+					if (mapping)
+					{
+						data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+						length = data ? static_cast<std::size_t>(size.QuadPart) : 0;
+					}
+				}
+				CloseHandle(file);
+				if (!data && mapping)
+				{
+					CloseHandle(mapping);
+					mapping = nullptr;
+				}
+#else
+				int file = ::open(filePath.c_str(), O_RDONLY);
+				if (file < 0)
+				{
+					return false;
+				}
+				struct stat status;
+				if (::fstat(file, &status) == 0 && status.st_size > 0)
+				{
+					void * mapped = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+					if (mapped != MAP_FAILED)
+					{
+						data = static_cast<const char *>(mapped);
+						length = static_cast<std::size_t>(status.st_size);
+					}
+				}
+				::close(file); // The mapping keeps the file open
+#endif
+				return data != nullptr;
+			}
+			void unmap()
+			{
+				if (data)
+				{
+#if defined(_WIN32)
+					UnmapViewOfFile(data);
+					CloseHandle(mapping);
+					mapping = nullptr;
+#else
+					::munmap(const_cast<char *>(data), length);
+#endif
+				}
+				data = nullptr;
+				length = 0;
+			}
+			void advise(AccessPattern pattern) const
+			{
+				// Passes the expected access pattern on to the kernel. Only a hint, and ignored on Windows.
+#if !defined(_WIN32)
+				if (data)
+				{
+					int advice = pattern == AccessPattern::SEQUENTIAL ? MADV_SEQUENTIAL : pattern == AccessPattern::RANDOM ? MADV_RANDOM : pattern == AccessPattern::WILL_NEED ? MADV_WILLNEED : MADV_NORMAL;
+					::madvise(const_cast<char *>(data), length, advice);
+				}
+#else
+				(void)pattern;
+#endif
+			}
+			const char * begin() const
+			{
+				return data;
+			}
+			std::size_t  size() const
+			{
+				return length;
+			}
+			void         swap(MappedRegion & rhs) noexcept
+			{
+				std::swap(data, rhs.data);
+				std::swap(length, rhs.length);
+#if defined(_WIN32)
+				std::swap(mapping, rhs.mapping);
+#endif
+			}
+		};
+	}
+
+	// A read-only view of a binary file written by NumericFile::outputToBinaryFile (a .npy matrix or the
+	// ragged format, see NumericBinary.hpp). The file is memory-mapped rather than loaded, so opening it is
+	// immediate whatever its size, pages are read in from the page cache as they're touched, and processes
+	// viewing the same file share one copy of it. Lines are handed out as spans into the mapping.
+	// Only the header is checked on opening, not the offsets of the lines of a ragged file: offsets past the
+	// values are taken as the end of them and a line whose offsets are out of order reads as empty, so no
+	// line reaches outside the mapping.
+	// The values must be stored in the byte order of the host and, for .npy files, in C order.
+	class MappedNumericFile
+	{
+	private:
+		NFPF::MappedRegion    region;
+		const double *        values;
+		const std::uint64_t * rowOffsets; // Null for .npy files, whose lines all hold 'columns' values
+		std::size_t           rowCount;
+		std::size_t           columns;
+		std::size_t           totalValues;
+		std::string           fileName;
+	public:
+		// Constructors
+		MappedNumericFile         () : values(nullptr), rowOffsets(nullptr), rowCount(0), columns(0), totalValues(0)
+		{
+			// Create an empty MappedNumericFile object
+		}
+		explicit MappedNumericFile(const std::string & filePath, AccessPattern pattern = AccessPattern::SEQUENTIAL) : MappedNumericFile()
+		{
+			// Creates a MappedNumericFile object that views the file 'filePath'
+			open(filePath, pattern);
+		}
+		MappedNumericFile         (const MappedNumericFile &) = delete;
+		MappedNumericFile         (MappedNumericFile && rhs) noexcept : region(std::move(rhs.region)), values(rhs.values), rowOffsets(rhs.rowOffsets), rowCount(rhs.rowCount), columns(rhs.columns), totalValues(rhs.totalValues), fileName(std::move(rhs.fileName))
+		{
+			rhs.reset();
+		}
+		MappedNumericFile & operator = (const MappedNumericFile &) = delete;
+		MappedNumericFile & operator = (MappedNumericFile && rhs) noexcept
+		{
+			if (this != &rhs)
+			{
+				region = std::move(rhs.region);
+				values = rhs.values;
+				rowOffsets = rhs.rowOffsets;
+				rowCount = rhs.rowCount;
+				columns = rhs.columns;
+				totalValues = rhs.totalValues;
+				fileName = std::move(rhs.fileName);
+				rhs.reset();
+			}
+			return *this;
+		}
+		// Opening and closing
+		bool        open      (const std::string & filePath, AccessPattern pattern = AccessPattern::SEQUENTIAL)
+		{
+			// Maps the file 'filePath', closing any file viewed so far. Returns false, leaving the view empty,
+			// if the file couldn't be mapped or isn't a float64 file in one of the formats of NumericBinary.hpp.
+			close();
+			if (!region.map(filePath) || !readLayout())
+			{
+				close();
+				return false;
+			}
+			fileName = filePath;
+			region.advise(pattern);
+			return true;
+		}
+		void        close     ()
+		{
+			// Unmaps the file and empties the view
+			region.unmap();
+			reset();
+		}
+		bool        isOpen    () const
+		{
+			return region.begin() != nullptr;
+		}
+		void        advise    (AccessPattern pattern) const
+		{
+			// Tells the kernel how the data is about to be read, e.g. SEQUENTIAL before a scan of the contents
+			region.advise(pattern);
+		}
+		// Getters
+		std::string     getFileName     () const
+		{
+			return fileName;
+		}
+		double          getEntry        (std::size_t line, std::size_t index) const
+		{
+			// Returns the value at (line, index), or 0 if it doesn't exist
+			return index < lineSize(line) ? values[lineOffset(line) + index] : 0;
+		}
+		NumericLine     getLine         (std::size_t line) const
+		{
+			// Returns a copy of a line in the file, or an empty NumericLine if it doesn't exist
+			ConstNumericRow row = getLineView(line);
+			return NumericLine(row.begin(), row.end());
+		}
+		ConstNumericRow getLineView     (std::size_t line) const
+		{
+			// Returns a view of a line in the mapping, or an empty view if the line doesn't exist
+			return line < size() ? ConstNumericRow(values + lineOffset(line), lineSize(line)) : ConstNumericRow();
+		}
+		ConstNumericRow getValues       () const
+		{
+			// Returns a view of every value in the file, one line after the other
+			return ConstNumericRow(values, totalValues);
+		}
+		std::string     getLineAsString (std::size_t line, const NumericFormat & format = NumericFormat()) const
+		{
+			// Returns a line in the file as a string, its values written in 'format'
+			ConstNumericRow row = getLineView(line);
+			std::string result;
+			NFPF::appendFormattedValues(result, row.begin(), row.end(), format);
+			return result;
+		}
+		std::size_t     size            () const
+		{
+			// Returns the number of lines in the file
+			return rowCount;
+		}
+		std::size_t     lineSize        (std::size_t line) const
+		{
+			// Returns the size of a line in the file if it exists, otherwise returns 0
+			if (line >= size())
+			{
+				return 0;
+			}
+			if (!rowOffsets)
+			{
+				return columns;
+			}
+			std::size_t end = static_cast<std::size_t>(std::min<std::uint64_t>(rowOffsets[line + 1], totalValues));
+			return end > lineOffset(line) ? end - lineOffset(line) : 0;
+		}
+		std::size_t     valueCount      () const
+		{
+			// Returns the number of values in the file
+			return totalValues;
+		}
+		bool            isRectangular   () const
+		{
+			// Returns true for .npy files, whose lines all have the same length
+			return rowOffsets == nullptr;
+		}
+		// Output
+		void        outputToStream(std::ostream & ostr, const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Outputs the contents of the file to a std::ostream, in the same format as NumericFile
+			NFPF::writeRows(ostr, size(), [this](std::size_t line) { return getLineView(line); }, format, mode);
+		}
+		// Statistics. Lines that don't exist are ignored, and anything computed over no values is 0.
+		double computeSumOfLine                  (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::SUM>(lineRange(line), 0, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeSumOfLines                 (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::SUM>(linesRange(lowerBound, upperBound), 0, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeSumOfLines                 (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::SUM>(linesRange(lowerBound, upperBound), 0, mode, execution);
+		}
+		double computeSumOfContents              (SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::SUM>(getValues(), 0, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeSumOfContents              (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::SUM>(getValues(), 0, mode, execution);
+		}
+		double computeAbsoluteSumOfLine          (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::ABSOLUTE_SUM>(lineRange(line), 0, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAbsoluteSumOfLines         (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::ABSOLUTE_SUM>(linesRange(lowerBound, upperBound), 0, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAbsoluteSumOfLines         (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::ABSOLUTE_SUM>(linesRange(lowerBound, upperBound), 0, mode, execution);
+		}
+		double computeAbsoluteSumOfContents      (SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::ABSOLUTE_SUM>(getValues(), 0, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAbsoluteSumOfContents      (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return reduce<NFPF::ReductionType::ABSOLUTE_SUM>(getValues(), 0, mode, execution);
+		}
+		double computeAverageOfLine              (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::averageOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAverageOfLines             (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::averageOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAverageOfLines             (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::averageOfRanges(&range, &range + 1, mode, execution);
+		}
+		double computeAverageOfContents          (SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::averageOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAverageOfContents          (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::averageOfRanges(&range, &range + 1, mode, execution);
+		}
+		double computeAbsoluteAverageOfLine      (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::absoluteAverageOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAbsoluteAverageOfLines     (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::absoluteAverageOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAbsoluteAverageOfLines     (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::absoluteAverageOfRanges(&range, &range + 1, mode, execution);
+		}
+		double computeAbsoluteAverageOfContents  (SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::absoluteAverageOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeAbsoluteAverageOfContents  (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::absoluteAverageOfRanges(&range, &range + 1, mode, execution);
+		}
+		double computeVarianceOfLine             (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::varianceOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeVarianceOfLines            (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::varianceOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeVarianceOfLines            (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::varianceOfRanges(&range, &range + 1, mode, execution);
+		}
+		double computeVarianceOfContents         (SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::varianceOfRanges(&range, &range + 1, mode, ExecutionMode::SEQUENTIAL);
+		}
+		double computeVarianceOfContents         (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::varianceOfRanges(&range, &range + 1, mode, execution);
+		}
+		double computeStandardDeviationOfLine    (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfLine(line, mode));
+		}
+		double computeStandardDeviationOfLines   (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfLines(lowerBound, upperBound, mode));
+		}
+		double computeStandardDeviationOfLines   (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfLines(lowerBound, upperBound, execution, mode));
+		}
+		double computeStandardDeviationOfContents(SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfContents(mode));
+		}
+		double computeStandardDeviationOfContents(ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			return std::sqrt(computeVarianceOfContents(execution, mode));
+		}
+		double computeMinimumOfLine              (std::size_t line) const
+		{
+			return reduce<NFPF::ReductionType::MINIMUM>(lineRange(line), 0, SummationMode::STANDARD, ExecutionMode::SEQUENTIAL);
+		}
+		double computeMinimumOfLines             (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return reduce<NFPF::ReductionType::MINIMUM>(linesRange(lowerBound, upperBound), 0, SummationMode::STANDARD, ExecutionMode::SEQUENTIAL);
+		}
+		double computeMinimumOfLines             (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			return reduce<NFPF::ReductionType::MINIMUM>(linesRange(lowerBound, upperBound), 0, SummationMode::STANDARD, execution);
+		}
+		double computeMinimumOfContents          () const
+		{
+			return reduce<NFPF::ReductionType::MINIMUM>(getValues(), 0, SummationMode::STANDARD, ExecutionMode::SEQUENTIAL);
+		}
+		double computeMinimumOfContents          (ExecutionMode execution) const
+		{
+			return reduce<NFPF::ReductionType::MINIMUM>(getValues(), 0, SummationMode::STANDARD, execution);
+		}
+		double computeMaximumOfLine              (std::size_t line) const
+		{
+			return reduce<NFPF::ReductionType::MAXIMUM>(lineRange(line), 0, SummationMode::STANDARD, ExecutionMode::SEQUENTIAL);
+		}
+		double computeMaximumOfLines             (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return reduce<NFPF::ReductionType::MAXIMUM>(linesRange(lowerBound, upperBound), 0, SummationMode::STANDARD, ExecutionMode::SEQUENTIAL);
+		}
+		double computeMaximumOfLines             (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			return reduce<NFPF::ReductionType::MAXIMUM>(linesRange(lowerBound, upperBound), 0, SummationMode::STANDARD, execution);
+		}
+		double computeMaximumOfContents          () const
+		{
+			return reduce<NFPF::ReductionType::MAXIMUM>(getValues(), 0, SummationMode::STANDARD, ExecutionMode::SEQUENTIAL);
+		}
+		double computeMaximumOfContents          (ExecutionMode execution) const
+		{
+			return reduce<NFPF::ReductionType::MAXIMUM>(getValues(), 0, SummationMode::STANDARD, execution);
+		}
+		NumericSummary computeSummaryOfLine              (std::size_t line) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::summariseRanges(&range, &range + 1, ExecutionMode::SEQUENTIAL);
+		}
+		NumericSummary computeSummaryOfLines             (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::summariseRanges(&range, &range + 1, ExecutionMode::SEQUENTIAL);
+		}
+		NumericSummary computeSummaryOfLines             (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::summariseRanges(&range, &range + 1, execution);
+		}
+		NumericSummary computeSummaryOfContents          () const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::summariseRanges(&range, &range + 1, ExecutionMode::SEQUENTIAL);
+		}
+		NumericSummary computeSummaryOfContents          (ExecutionMode execution) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::summariseRanges(&range, &range + 1, execution);
+		}
+		NumericColumnSummary computeColumnSummaryOfLines   (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return columnSummaryOf(lowerBound, upperBound, ExecutionMode::SEQUENTIAL);
+		}
+		NumericColumnSummary computeColumnSummaryOfLines   (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			return columnSummaryOf(lowerBound, upperBound, execution);
+		}
+		NumericColumnSummary computeColumnSummaryOfContents() const
+		{
+			return columnSummaryOf(0, std::numeric_limits<std::size_t>::max(), ExecutionMode::SEQUENTIAL);
+		}
+		NumericColumnSummary computeColumnSummaryOfContents(ExecutionMode execution) const
+		{
+			return columnSummaryOf(0, std::numeric_limits<std::size_t>::max(), execution);
+		}
+		double computeQuantileOfLine             (std::size_t line, double quantile) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::quantileOfRanges(&range, &range + 1, quantile);
+		}
+		double computeQuantileOfLines            (std::size_t lowerBound, std::size_t upperBound, double quantile) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::quantileOfRanges(&range, &range + 1, quantile);
+		}
+		double computeQuantileOfContents         (double quantile) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::quantileOfRanges(&range, &range + 1, quantile);
+		}
+		double computeMedianOfLine               (std::size_t line) const
+		{
+			return computeQuantileOfLine(line, 0.5);
+		}
+		double computeMedianOfLines              (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			return computeQuantileOfLines(lowerBound, upperBound, 0.5);
+		}
+		double computeMedianOfContents           () const
+		{
+			return computeQuantileOfContents(0.5);
+		}
+		QuantileSketch computeQuantileSketchOfLines   (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::sketchRanges(&range, &range + 1, ExecutionMode::SEQUENTIAL);
+		}
+		QuantileSketch computeQuantileSketchOfLines   (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::sketchRanges(&range, &range + 1, execution);
+		}
+		QuantileSketch computeQuantileSketchOfContents() const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::sketchRanges(&range, &range + 1, ExecutionMode::SEQUENTIAL);
+		}
+		QuantileSketch computeQuantileSketchOfContents(ExecutionMode execution) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::sketchRanges(&range, &range + 1, execution);
+		}
+		NumericHistogram computeHistogramOfLine    (std::size_t line, NumericHistogram histogram) const
+		{
+			ConstNumericRow range = lineRange(line);
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfLines   (std::size_t lowerBound, std::size_t upperBound, NumericHistogram histogram) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfLines   (std::size_t lowerBound, std::size_t upperBound, NumericHistogram histogram, ExecutionMode execution) const
+		{
+			ConstNumericRow range = linesRange(lowerBound, upperBound);
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram), execution);
+		}
+		NumericHistogram computeHistogramOfContents(NumericHistogram histogram) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfContents(NumericHistogram histogram, ExecutionMode execution) const
+		{
+			ConstNumericRow range = getValues();
+			return NFPF::histogramOfRanges(&range, &range + 1, std::move(histogram), execution);
+		}
+	private:
+		void            reset           ()
+		{
+			values = nullptr;
+			rowOffsets = nullptr;
+			rowCount = 0;
+			columns = 0;
+			totalValues = 0;
+			fileName.clear();
+		}
+		bool            readLayout      ()
+		{
+			// Finds the values and line offsets in the mapping, checking that the header agrees with the file size
+			const char * data = region.begin();
+			std::size_t length = region.size();
+			if (!NFPF::hostIsLittleEndian() || length < 8)
+			{
+				return false;
+			}
+			std::size_t dataOffset;
+			if (std::memcmp(data, NFPF::raggedMagic, 8) == 0)
+			{
+				std::uint64_t counts[2];
+				if (length < 24)
+				{
+					return false;
+				}
+				std::memcpy(counts, data + 8, sizeof(counts));
+				if (counts[0] >= length / 8 || counts[1] > length / 8 - counts[0] || 24 + 8 * (counts[0] + 1 + counts[1]) > length)
+				{
+					return false;
+				}
+				rowOffsets = reinterpret_cast<const std::uint64_t *>(data + 24);
+				rowCount = static_cast<std::size_t>(counts[0]);
+				totalValues = static_cast<std::size_t>(counts[1]);
+				if (rowOffsets[0] != 0 || rowOffsets[rowCount] != counts[1]) // The offsets in between are clamped as they're used
+				{
+					return false;
+				}
+				dataOffset = 24 + 8 * (rowCount + 1);
+			}
+			else
+			{
+				if (length < 12 || std::memcmp(data, NFPF::npyMagic, 6) != 0 || data[6] < 1 || data[6] > 3)
+				{
+					return false;
+				}
+				const unsigned char * lengthBytes = reinterpret_cast<const unsigned char *>(data + 8);
+				std::size_t headerLength = data[6] == 1 ? lengthBytes[0] | (std::size_t(lengthBytes[1]) << 8) : lengthBytes[0] | (std::size_t(lengthBytes[1]) << 8) | (std::size_t(lengthBytes[2]) << 16) | (std::size_t(lengthBytes[3]) << 24);
+				std::size_t headerStart = data[6] == 1 ? 10 : 12;
+				NFPF::NpyHeader header;
+				if (headerStart + headerLength > length || !NFPF::parseNpyHeader(std::string(data + headerStart, headerLength), header) || !header.littleEndian)
+				{
+					return false;
+				}
+				rowCount = header.shape.size() == 2 ? header.shape[0] : 1;
+				columns = header.shape.empty() ? 1 : header.shape.back();
+				if (header.fortranOrder && rowCount > 1 && columns > 1)
+				{
+					return false;
+				}
+				dataOffset = headerStart + headerLength;
+				std::size_t rowValues = header.shape.size() == 2 ? std::max<std::size_t>(columns, 1) : columns; // As readBinaryNumericFile checks
+				if (rowValues && rowCount > (length - dataOffset) / 8 / rowValues)
+				{
+					return false;
+				}
+				totalValues = rowCount * columns;
+			}
+			if (dataOffset % alignof(double) != 0)
+			{
+				return false;
+			}
+			values = reinterpret_cast<const double *>(data + dataOffset);
+			return true;
+		}
+		std::size_t     lineOffset      (std::size_t line) const
+		{
+			return rowOffsets ? static_cast<std::size_t>(std::min<std::uint64_t>(rowOffsets[line], totalValues)) : line * columns;
+		}
+		ConstNumericRow lineRange       (std::size_t line) const
+		{
+			return getLineView(line);
+		}
+		ConstNumericRow linesRange      (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Lines [lowerBound, upperBound] are next to each other, so their values form one range
+			FWPF::validateBounds(lowerBound, upperBound);
+			if (lowerBound >= size())
+			{
+				return ConstNumericRow();
+			}
+			upperBound = std::min(upperBound, size() - 1);
+			std::size_t first = lineOffset(lowerBound);
+			std::size_t last = lineOffset(upperBound) + lineSize(upperBound);
+			return ConstNumericRow(values + first, last > first ? last - first : 0);
+		}
+		NumericColumnSummary columnSummaryOf(std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			FWPF::validateBounds(lowerBound, upperBound);
+			if (lowerBound >= size())
+			{
+				return NumericColumnSummary();
+			}
+			upperBound = std::min(upperBound, size() - 1);
+			return NFPF::summariseColumns(upperBound + 1 - lowerBound, [this, lowerBound](std::size_t i)
+			{
+				return getLineView(lowerBound + i);
+			}, execution);
+		}
+		template <NFPF::ReductionType Type>
+		static double   reduce          (ConstNumericRow range, double parameter, SummationMode mode, ExecutionMode execution)
+		{
+			return NFPF::reduceRanges<Type>(&range, &range + 1, parameter, mode, execution);
+		}
+	};
+}
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace fileFunctions
+{
+	// Binary files for NumericFile and CompactNumericFile. Saving picks one of two formats, and loading
+	// recognises both from their first bytes. Everything is little-endian.
+	//
+	// Files whose lines all have the same length are saved as NumPy .npy version 1.0 files, which
+	// numpy.load reads as a float64 array of shape (lines, values per line):
+	//     "\x93NUMPY" 0x01 0x00, a uint16 header length, then the header, a Python dict literal such as
+	//     "{'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }" padded with spaces and ended with '\n'
+	//     so that the data starts at a multiple of 64 bytes, then the values, one line after the other.
+	// Loading also accepts .npy versions 2.0 and 3.0, big-endian float64 ('>f8'), Fortran order, and
+	// one-dimensional arrays, which become a single line.
+	//
+	// Any other file is saved in the ragged format, laid out like CompactNumericFile. So are files of
+	// nothing but empty lines, since a .npy array with no columns has no data to check its rows against:
+	//     offset 0   "\x93NUMRAG" 0x01   magic string and version
+	//     offset 8   uint64              number of lines R
+	//     offset 16  uint64              number of values N
+	//     offset 24  uint64[R + 1]       row offsets: line i is values[offsets[i]] to values[offsets[i + 1] - 1]
+	//     then       float64[N]          the values
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		const char        npyMagic[]            = "\x93NUMPY";
+		const char        raggedMagic[]         = "\x93NUMRAG\x01";
+		const std::size_t binaryBufferSize      = std::size_t(1) << 16; // In values
+
+		inline bool hostIsLittleEndian()
+		{
+			const std::uint16_t one = 1;
+			unsigned char first;
+			std::memcpy(&first, &one, 1);
+			return first == 1;
+		}
+
+		template <typename T>
+		T swapBytes(T value)
+		{
+			unsigned char bytes[sizeof(T)];
+			std::memcpy(bytes, &value, sizeof(T));
+			std::reverse(bytes, bytes + sizeof(T));
+			std::memcpy(&value, bytes, sizeof(T));
+			return value;
+		}
+
+		template <typename T>
+		void swapBytes(T * data, std::size_t count)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				data[i] = swapBytes(data[i]);
+			}
+		}
+
+		template <typename T>
+		void writeLittleEndian(std::ostream & ostr, const T * data, std::size_t count)
+		{
+			// Writes 'count' values, swapping their bytes first on big-endian hosts
+			if (hostIsLittleEndian())
+			{
+				ostr.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(count * sizeof(T)));
+				return;
+			}
+			std::vector<T> swapped(data, data + count);
+			swapBytes(swapped.data(), count);
+			ostr.write(reinterpret_cast<const char *>(swapped.data()), static_cast<std::streamsize>(count * sizeof(T)));
+		}
+
+		template <typename T>
+		bool readValues(std::istream & istr, T * data, std::size_t count, bool littleEndian)
+		{
+			// Reads 'count' values with a single read, swapping their bytes if they aren't in host order
+			if (count && !istr.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(count * sizeof(T))))
+			{
+				return false;
+			}
+			if (littleEndian != hostIsLittleEndian())
+			{
+				swapBytes(data, count);
+			}
+			return true;
+		}
+
+		inline std::string makeNpyHeader(std::size_t rows, std::size_t columns)
+		{
+			// Returns the magic string, version, header length and header of a version 1.0 .npy file
+			std::string dictionary = "{'descr': '<f8', 'fortran_order': False, 'shape': (" + std::to_string(rows) + ", " + std::to_string(columns) + "), }";
+			std::size_t unpadded = 10 + dictionary.size() + 1;
+			dictionary.append((64 - unpadded % 64) % 64, ' ');
+			dictionary.push_back('\n');
+			std::uint16_t length = static_cast<std::uint16_t>(dictionary.size());
+			unsigned char lengthBytes[2] = {static_cast<unsigned char>(length & 0xFF), static_cast<unsigned char>(length >> 8)};
+			std::string header(npyMagic, 6);
+			header.push_back('\x01');
+			header.push_back('\x00');
+			header.append(reinterpret_cast<const char *>(lengthBytes), 2);
+			return header + dictionary;
+		}
+
+		struct NpyHeader
+		{
+			bool                     littleEndian = true;
+			bool                     fortranOrder = false;
+			std::vector<std::size_t> shape;
+		};
+
+		inline bool parseNpyHeader(const std::string & dictionary, NpyHeader & header)
+		{
+			// Reads 'descr', 'fortran_order' and 'shape' from the header dict. Only float64 data is accepted.
+			auto valueOf = [&dictionary](const char * key) -> std::size_t
+			{
+				std::size_t position = dictionary.find(key);
+				if (position == std::string::npos)
+				{
+					return std::string::npos;
+				}
+				position = dictionary.find(':', position + std::strlen(key));
+				return position == std::string::npos ? position : dictionary.find_first_not_of(' ', position + 1);
+			};
+			std::size_t descr = valueOf("'descr'");
+			std::size_t fortran = valueOf("'fortran_order'");
+			std::size_t shape = valueOf("'shape'");
+			if (descr == std::string::npos || fortran == std::string::npos || shape == std::string::npos || dictionary[shape] != '(')
+			{
+				return false;
+			}
+			std::string type = dictionary.substr(descr, 5);
+			if (type != "'<f8'" && type != "'>f8'")
+			{
+				return false;
+			}
+			header.littleEndian = type[1] == '<';
+			header.fortranOrder = dictionary.compare(fortran, 4, "True") == 0;
+			std::size_t close = dictionary.find(')', shape);
+			if (close == std::string::npos)
+			{
+				return false;
+			}
+			const char * position = dictionary.data() + shape + 1;
+			const char * end = dictionary.data() + close;
+			while (position < end)
+			{
+				if (*position >= '0' && *position <= '9')
+				{
+					char * parsed;
+					header.shape.push_back(static_cast<std::size_t>(std::strtoull(position, &parsed, 10)));
+					position = parsed;
+				}
+				else
+				{
+					++position;
+				}
+			}
+			return header.shape.size() <= 2;
+		}
+
+		template <typename RowFunctionType>
+		bool writeBinaryNumericFile(const std::string & filePath, std::size_t rowCount, const RowFunctionType & getRow)
+		{
+			// Saves rows [0, rowCount) in whichever format above fits. getRow(i) returns something with begin(),
+			// end() and size(). Returns false if the file couldn't be written.
+			std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			std::size_t columns = rowCount ? getRow(0).size() : 0;
+			bool rectangular = true;
+			std::size_t valueCount = 0;
+			for (std::size_t i = 0; i < rowCount; ++i)
+			{
+				rectangular = rectangular && getRow(i).size() == columns;
+				valueCount += getRow(i).size();
+			}
+			std::vector<std::uint64_t> offsets;
+			if (rectangular && (columns || rowCount == 0))
+			{
+				std::string header = makeNpyHeader(rowCount, columns);
+				file.write(header.data(), static_cast<std::streamsize>(header.size()));
+			}
+			else
+			{
+				std::uint64_t counts[2] = {rowCount, valueCount};
+				file.write(raggedMagic, 8);
+				writeLittleEndian(file, counts, 2);
+				offsets.reserve(std::min(rowCount + 1, binaryBufferSize));
+				std::uint64_t offset = 0;
+				offsets.push_back(offset);
+				for (std::size_t i = 0; i < rowCount; ++i)
+				{
+					offset += getRow(i).size();
+					offsets.push_back(offset);
+					if (offsets.size() == binaryBufferSize)
+					{
+						writeLittleEndian(file, offsets.data(), offsets.size());
+						offsets.clear();
+					}
+				}
+				writeLittleEndian(file, offsets.data(), offsets.size());
+			}
+			std::vector<double> buffer;
+			buffer.reserve(binaryBufferSize);
+			for (std::size_t i = 0; i < rowCount && file.good(); ++i)
+			{
+				const auto & row = getRow(i);
+				for (auto j = row.begin(); j != row.end(); ++j)
+				{
+					buffer.push_back(*j);
+					if (buffer.size() == binaryBufferSize)
+					{
+						writeLittleEndian(file, buffer.data(), buffer.size());
+						buffer.clear();
+					}
+				}
+			}
+			writeLittleEndian(file, buffer.data(), buffer.size());
+			return file.good();
+		}
+
+		template <typename OffsetsType, typename ValuesType>
+		bool readBinaryNumericFile(const std::string & filePath, OffsetsType & rowOffsets, ValuesType & values)
+		{
+			// Loads a file in either format into compressed-row form: rowOffsets gets one entry per line plus
+			// a final one, values every value. Returns false if the file couldn't be opened, isn't in one of
+			// the formats above or is shorter than its header says.
+			std::ifstream file(filePath, std::ios::in | std::ios::binary | std::ios::ate);
+			std::uint64_t fileSize = file.is_open() ? static_cast<std::uint64_t>(file.tellg()) : 0;
+			char magic[8];
+			if (!file.is_open() || !file.seekg(0) || !file.read(magic, 8))
+			{
+				return false;
+			}
+			if (std::memcmp(magic, raggedMagic, 8) == 0)
+			{
+				std::uint64_t counts[2];
+				if (!readValues(file, counts, 2, true) || counts[0] >= fileSize / 8 || counts[1] > fileSize / 8 - counts[0])
+				{
+					return false;
+				}
+				std::vector<std::uint64_t> offsets(static_cast<std::size_t>(counts[0]) + 1);
+				if (!readValues(file, offsets.data(), offsets.size(), true) || offsets.front() != 0 || offsets.back() != counts[1] || !std::is_sorted(offsets.begin(), offsets.end()))
+				{
+					return false;
+				}
+				rowOffsets.assign(offsets.begin(), offsets.end());
+				values.resize(static_cast<std::size_t>(counts[1]));
+				return readValues(file, values.data(), values.size(), true);
+			}
+			if (std::memcmp(magic, npyMagic, 6) != 0 || magic[6] < 1 || magic[6] > 3)
+			{
+				return false;
+			}
+			unsigned char lengthBytes[4] = {0, 0, 0, 0};
+			if (!file.read(reinterpret_cast<char *>(lengthBytes), magic[6] == 1 ? 2 : 4))
+			{
+				return false;
+			}
+			std::size_t headerLength = lengthBytes[0] | (std::size_t(lengthBytes[1]) << 8) | (std::size_t(lengthBytes[2]) << 16) | (std::size_t(lengthBytes[3]) << 24);
+			if (headerLength > fileSize - static_cast<std::uint64_t>(file.tellg()))
+			{
+				return false;
+			}
+			std::string dictionary(headerLength, '\0');
+			NpyHeader header;
+			if (!file.read(dictionary.data(), static_cast<std::streamsize>(headerLength)) || !parseNpyHeader(dictionary, header))
+			{
+				return false;
+			}
+			std::size_t rows = header.shape.empty() ? 1 : header.shape.size() == 1 ? 1 : header.shape[0];
+			std::size_t columns = header.shape.empty() ? 1 : header.shape.back();
+			// The rows of a two-dimensional array are checked against the data left even if they have no
+			// columns, counting one value each, so the row offsets below can't be made arbitrarily large.
+			// A one-dimensional array is always one line.
+			std::size_t rowValues = header.shape.size() == 2 ? std::max<std::size_t>(columns, 1) : columns;
+			if (rowValues && rows > (fileSize - static_cast<std::uint64_t>(file.tellg())) / 8 / rowValues)
+			{
+				return false;
+			}
+			values.resize(rows * columns);
+			if (!readValues(file, values.data(), values.size(), header.littleEndian))
+			{
+				return false;
+			}
+			if (header.fortranOrder && rows > 1 && columns > 1)
+			{
+				// Column-major on disk, so transpose into lines
+				std::vector<double> columnMajor(values.begin(), values.end());
+				for (std::size_t i = 0; i < rows; ++i)
+				{
+					for (std::size_t j = 0; j < columns; ++j)
+					{
+						values[i * columns + j] = columnMajor[j * rows + i];
+					}
+				}
+			}
+			rowOffsets.resize(rows + 1);
+			for (std::size_t i = 0; i <= rows; ++i)
+			{
+				rowOffsets[i] = i * columns;
+			}
+			return true;
+		}
+	}
+}
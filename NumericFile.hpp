@@ -4,18 +4,38 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <deque>
 #include <algorithm>
 #include <functional>
 #include <string>
 #include <numeric>
+#include <cmath>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
 
 #include "FileCloseAction.hpp"
 #include "CommonFunctions.hpp"
+#include "ParallelFunctions.hpp"
+#include "NumericKernels.hpp"
+#include "NumericSummary.hpp"
+#include "NumericFormat.hpp"
+#include "NumericBinary.hpp"
+#include "NumericSort.hpp"
+#include "NumericQuantiles.hpp"
+#include "NumericHistogram.hpp"
 
 namespace fileFunctions
 {
+	using sp::FileCloseAction;
+	using sp::ExecutionMode;
+	namespace FWPF = sp::FWPF;
+
 	typedef std::deque<double> NumericLine;
 
 	typedef std::deque<NumericLine>::iterator               NumericFileIterator;
@@ -28,53 +48,323 @@ namespace fileFunctions
 	typedef NumericLine::reverse_iterator       ReverseNumericLineIterator;
 	typedef NumericLine::const_reverse_iterator ConstReverseNumericLineIterator;
 
-	class NumericFile
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		// The bulk text parser. Values are separated by spaces, tabs, commas or semicolons, and every '\n'
+		// ends a line ('\r' is treated as a separator, so Windows line endings work too). Values are parsed
+		// with std::from_chars. The parser reports what it finds to a sink providing:
+		//     void appendValue(double)  - a value on the current line
+		//     void endLine()            - the end of the current line
+		//     void invalidToken()       - a token that isn't a number, which is skipped
+		inline bool isNumericSeparator(char ch)
+		{
+			return ch == ' ' || ch == '\t' || ch == '\r' || ch == ',' || ch == ';' || ch == '\n';
+		}
+
+		template <typename SinkType>
+		void parseNumericToken(const char * first, const char * last, SinkType & sink)
+		{
+			if (*first == '+' && last - first > 1)
+			{
+				++first;
+			}
+			double value;
+			std::from_chars_result result = std::from_chars(first, last, value);
+			if (result.ec == std::errc() && result.ptr == last)
+			{
+				sink.appendValue(value);
+			}
+			else if (result.ec == std::errc::result_out_of_range && result.ptr == last)
+			{
+				sink.appendValue(std::strtod(std::string(first, last).c_str(), nullptr)); // Rare, let strtod pick between +-HUGE_VAL and 0
+			}
+			else
+			{
+				sink.invalidToken();
+			}
+		}
+
+		template <typename SinkType>
+		void parseNumericText(const char * first, const char * last, SinkType & sink)
+		{
+			// Parses [first, last), calling sink.endLine() for every '\n' in it. A line that isn't terminated by
+			// a '\n' is reported without the final endLine(), so text can be fed in pieces split on line boundaries.
+			const char * tokenStart = nullptr;
+			const char * current = first;
+#ifdef SP_FORMATTING_SIMD
+			// Separators are found a block at a time, as bit masks, and tokens are the runs of zero bits
+			namespace FFPF = sp::FFPF;
+			const std::uint32_t fullMask = static_cast<std::uint32_t>((std::uint64_t(1) << FFPF::blockSize) - 1);
+			const FFPF::Block spaces = FFPF::splat(' ');
+			const FFPF::Block tabs = FFPF::splat('\t');
+			const FFPF::Block returns = FFPF::splat('\r');
+			const FFPF::Block commas = FFPF::splat(',');
+			const FFPF::Block semicolons = FFPF::splat(';');
+			const FFPF::Block newlines = FFPF::splat('\n');
+			for (; static_cast<std::size_t>(last - current) >= FFPF::blockSize; current += FFPF::blockSize)
+			{
+				FFPF::Block block = FFPF::loadBlock(current);
+				std::uint32_t newlineMask = FFPF::moveMask(FFPF::equal(block, newlines));
+				std::uint32_t separatorMask = newlineMask | FFPF::moveMask(FFPF::bitOr(
+					FFPF::bitOr(FFPF::equal(block, spaces), FFPF::equal(block, tabs)),
+					FFPF::bitOr(FFPF::bitOr(FFPF::equal(block, returns), FFPF::equal(block, commas)), FFPF::equal(block, semicolons))));
+				std::uint32_t position = 0;
+				while (position < FFPF::blockSize)
+				{
+					if (tokenStart)
+					{
+						std::uint32_t rest = separatorMask >> position;
+						if (!rest)
+						{
+							break; // The token carries on into the next block
+						}
+						position += FFPF::countTrailingZeros(rest);
+						parseNumericToken(tokenStart, current + position, sink);
+						tokenStart = nullptr;
+					}
+					else
+					{
+						std::uint32_t rest = (~separatorMask & fullMask) >> position;
+						std::uint32_t next = rest ? position + FFPF::countTrailingZeros(rest) : static_cast<std::uint32_t>(FFPF::blockSize);
+						std::uint32_t range = (next == 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << next) - 1) & ~((std::uint32_t(1) << position) - 1);
+						for (std::uint32_t lines = newlineMask & range; lines; lines &= lines - 1)
+						{
+							sink.endLine();
+						}
+						if (next == FFPF::blockSize)
+						{
+							break;
+						}
+						tokenStart = current + next;
+						position = next;
+					}
+				}
+			}
+#endif
+			for (; current != last; ++current)
+			{
+				if (isNumericSeparator(*current))
+				{
+					if (tokenStart)
+					{
+						parseNumericToken(tokenStart, current, sink);
+						tokenStart = nullptr;
+					}
+					if (*current == '\n')
+					{
+						sink.endLine();
+					}
+				}
+				else if (!tokenStart)
+				{
+					tokenStart = current;
+				}
+			}
+			if (tokenStart)
+			{
+				parseNumericToken(tokenStart, last, sink);
+			}
+		}
+
+		struct ParsedNumericLines
+		{
+			// Lines parsed by one thread, stored flat: line i holds values[lineEnds[i - 1]] to values[lineEnds[i] - 1]
+			std::vector<double>      values;
+			std::vector<std::size_t> lineEnds;
+			std::size_t              invalidTokens = 0;
+
+			void appendValue(double value)
+			{
+				values.push_back(value);
+			}
+			void endLine()
+			{
+				lineEnds.push_back(values.size());
+			}
+			void invalidToken()
+			{
+				++invalidTokens;
+			}
+		};
+
+		template <typename FunctionType>
+		bool parseNumericLines(const char * data, std::size_t length, bool lastBlock, ExecutionMode mode, std::vector<ParsedNumericLines> & parsed, std::size_t & invalidTokens, const FunctionType & function)
+		{
+			// Parses [data, data + length), which must end at the end of a line unless it's the last block of
+			// the file, and calls function(const double * first, const double * last) for every line, in order.
+			// With mode == PARALLEL the text is split across threads at line boundaries. If function returns
+			// a bool, returning false stops the calls, and then so does this function by returning false.
+			const std::size_t minimumChunkSize = 1 << 20;
+			std::size_t chunkCount = FWPF::getChunkCount(length, mode, minimumChunkSize);
+			std::vector<std::size_t> bounds(1, 0);
+			for (std::size_t i = 1; i < chunkCount; ++i)
+			{
+				const char * newline = static_cast<const char *>(std::memchr(data + std::max(bounds.back(), length * i / chunkCount), '\n', length - std::max(bounds.back(), length * i / chunkCount)));
+				if (newline)
+				{
+					bounds.push_back(newline + 1 - data);
+				}
+			}
+			bounds.push_back(length);
+			parsed.resize(bounds.size() - 1);
+			FWPF::parallelForChunks(parsed.size(), parsed.size(), [&parsed, &bounds, data](std::size_t, std::size_t first, std::size_t last)
+			{
+				for (std::size_t i = first; i < last; ++i)
+				{
+					ParsedNumericLines & lines = parsed[i];
+					lines.values.clear();
+					lines.lineEnds.clear();
+					lines.invalidTokens = 0;
+					parseNumericText(data + bounds[i], data + bounds[i + 1], lines);
+				}
+			});
+			if (lastBlock && length && data[length - 1] != '\n')
+			{
+				parsed.back().endLine(); // The file doesn't end with a newline
+			}
+			for (const ParsedNumericLines & i : parsed)
+			{
+				invalidTokens += i.invalidTokens;
+				std::size_t lineStart = 0;
+				for (std::size_t j : i.lineEnds)
+				{
+					if constexpr (std::is_same_v<decltype(function(i.values.data(), i.values.data())), bool>)
+					{
+						if (!function(i.values.data() + lineStart, i.values.data() + j))
+						{
+							return false;
+						}
+					}
+					else
+					{
+						function(i.values.data() + lineStart, i.values.data() + j);
+					}
+					lineStart = j;
+				}
+			}
+			return true;
+		}
+
+		template <typename FunctionType>
+		bool forEachParsedNumericLine(const std::string & filePath, ExecutionMode mode, const FunctionType & function)
+		{
+			// Reads the file 'filePath' in large blocks, parses each block (split across threads at line
+			// boundaries if mode == PARALLEL) and calls function(const double * first, const double * last)
+			// for every line, in order. Returns false if the file couldn't be opened or held tokens that
+			// aren't numbers.
+			std::ifstream file(filePath, std::ios::in | std::ios::binary);
+			if (!file.is_open())
+			{
+				return false;
+			}
+			std::vector<char> buffer(std::clamp<std::size_t>(FWPF::getFileSize(filePath) + 1, std::size_t(1) << 16, std::size_t(64) << 20));
+			std::vector<ParsedNumericLines> parsed;
+			std::size_t carried = 0; // Bytes of an unfinished line kept at the front of the buffer
+			std::size_t invalidTokens = 0;
+			while (true)
+			{
+				if (carried == buffer.size())
+				{
+					buffer.resize(buffer.size() * 2);
+				}
+				file.read(buffer.data() + carried, buffer.size() - carried);
+				std::size_t end = carried + static_cast<std::size_t>(file.gcount());
+				bool lastBlock = !file;
+				const char * data = buffer.data();
+				// Only whole lines are parsed, the rest is carried over to the next block
+				std::size_t parseEnd = end;
+				if (!lastBlock)
+				{
+					while (parseEnd && data[parseEnd - 1] != '\n')
+					{
+						--parseEnd;
+					}
+				}
+				parseNumericLines(data, parseEnd, lastBlock, mode, parsed, invalidTokens, function);
+				if (lastBlock)
+				{
+					break;
+				}
+				carried = end - parseEnd;
+				std::memmove(buffer.data(), data + parseEnd, carried);
+			}
+			return invalidTokens == 0;
+		}
+	}
+
+	// Every line, and the list of lines, is allocated by 'Allocator'. NumericFile uses the default
+	// allocator; pmr::NumericFile takes a std::pmr::memory_resource, so a file can be loaded into
+	// e.g. a std::pmr::monotonic_buffer_resource and released all at once.
+	template <class Allocator = std::allocator<double>>
+	class BasicNumericFile
 	{
+	public:
+		typedef Allocator                                                                                          AllocatorType;
+		typedef std::deque<double, Allocator>                                                                      NumericLine;
+		typedef std::deque<NumericLine, typename std::allocator_traits<Allocator>::template rebind_alloc<NumericLine>> Contents;
+
+		typedef typename Contents::iterator               NumericFileIterator;
+		typedef typename Contents::const_iterator         ConstNumericFileIterator;
+		typedef typename Contents::reverse_iterator       ReverseNumericFileIterator;
+		typedef typename Contents::const_reverse_iterator ConstReverseNumericFileIterator;
+
+		typedef typename NumericLine::iterator               NumericLineIterator;
+		typedef typename NumericLine::const_iterator         ConstNumericLineIterator;
+		typedef typename NumericLine::reverse_iterator       ReverseNumericLineIterator;
+		typedef typename NumericLine::const_reverse_iterator ConstReverseNumericLineIterator;
 	private:
-		std::deque<NumericLine> contents;
+		Contents contents;
 		std::string fileName;
 		FileCloseAction closingAction;
 	public:
 		// Constructors
-		NumericFile         () : closingAction(FileCloseAction::NONE)
+		BasicNumericFile         () : closingAction(FileCloseAction::NONE)
 		{
 			// Create an empty NumericFile object
 		}
-		explicit NumericFile(FileCloseAction onClose) : closingAction(onClose)
+		explicit BasicNumericFile(const AllocatorType & allocator) : contents(typename Contents::allocator_type(allocator)), closingAction(FileCloseAction::NONE)
+		{
+			// Create an empty NumericFile object whose lines are allocated by 'allocator'
+		}
+		explicit BasicNumericFile(FileCloseAction onClose, const AllocatorType & allocator = AllocatorType()) : contents(typename Contents::allocator_type(allocator)), closingAction(onClose)
 		{
 			// Create a NumericFile object that is not associated with any files and does not load any data upon creation
 		}
-		explicit NumericFile(const std::string filePath, FileCloseAction onClose = FileCloseAction::NONE) : fileName(filePath), closingAction(onClose)
+		explicit BasicNumericFile(const std::string filePath, FileCloseAction onClose = FileCloseAction::NONE, const AllocatorType & allocator = AllocatorType()) : contents(typename Contents::allocator_type(allocator)), fileName(filePath), closingAction(onClose)
 		{
 			// Creates a NumericFile object that is associated with a file and loads data upon creation
 			loadFromFile(filePath);
 		}
-		NumericFile         (NumericFileIterator first, NumericFileIterator last) : contents(first, last), closingAction(FileCloseAction::NONE)
+		BasicNumericFile         (NumericFileIterator first, NumericFileIterator last, const AllocatorType & allocator = AllocatorType()) : contents(first, last, typename Contents::allocator_type(allocator)), closingAction(FileCloseAction::NONE)
 		{
 			// Creates a NumericFile from an iterator range
 		}
-		NumericFile         (ConstNumericFileIterator first, ConstNumericFileIterator last) : contents(first, last), closingAction(FileCloseAction::NONE)
+		BasicNumericFile         (ConstNumericFileIterator first, ConstNumericFileIterator last, const AllocatorType & allocator = AllocatorType()) : contents(first, last, typename Contents::allocator_type(allocator)), closingAction(FileCloseAction::NONE)
 		{
 			// Creates a NumericFile from an iterator range
 		}
-		NumericFile         (ReverseNumericFileIterator first, ReverseNumericFileIterator last) : contents(first, last), closingAction(FileCloseAction::NONE)
+		BasicNumericFile         (ReverseNumericFileIterator first, ReverseNumericFileIterator last, const AllocatorType & allocator = AllocatorType()) : contents(first, last, typename Contents::allocator_type(allocator)), closingAction(FileCloseAction::NONE)
 		{
 			// Creates a NumericFile from an iterator range
 		}
-		NumericFile         (ConstReverseNumericFileIterator first, ConstReverseNumericFileIterator last) : contents(first, last), closingAction(FileCloseAction::NONE)
+		BasicNumericFile         (ConstReverseNumericFileIterator first, ConstReverseNumericFileIterator last, const AllocatorType & allocator = AllocatorType()) : contents(first, last, typename Contents::allocator_type(allocator)), closingAction(FileCloseAction::NONE)
 		{
 			// Creates a NumericFile from an iterator range
 		}
-		NumericFile         (const NumericFile & rhs) : contents(rhs.contents), fileName(rhs.fileName), closingAction(rhs.closingAction)
+		BasicNumericFile         (const BasicNumericFile & rhs) : contents(rhs.contents), fileName(rhs.fileName), closingAction(rhs.closingAction)
 		{
 			// Copy constructor
 		}
-		NumericFile         (NumericFile && rhs) : contents(std::move(rhs.contents)), fileName(std::move(rhs.fileName)), closingAction(std::move(rhs.closingAction))
+		BasicNumericFile         (const BasicNumericFile & rhs, const AllocatorType & allocator) : contents(rhs.contents, typename Contents::allocator_type(allocator)), fileName(rhs.fileName), closingAction(rhs.closingAction)
+		{
+			// Copy constructor that allocates the copy with 'allocator'
+		}
+		BasicNumericFile         (BasicNumericFile && rhs) : contents(std::move(rhs.contents)), fileName(std::move(rhs.fileName)), closingAction(std::move(rhs.closingAction))
 		{
 			// Move constructor
 		}
 		// Destructor
-		~NumericFile()
+		~BasicNumericFile()
 		{
 			// Perform an action based on the value of closingAction
 			switch (closingAction)
@@ -100,29 +390,25 @@ namespace fileFunctions
 		NumericLine                            getLine                 (std::size_t line) const
 		{
 			// Returns the line at (line) if it exists, otherwise returns an empty NumericLine
-			return (line < size()) ? contents.at(line) : NumericLine();
+			return (line < size()) ? contents.at(line) : NumericLine(contents.get_allocator());
+		}
+		const NumericLine &                    getLineView             (std::size_t line) const
+		{
+			// Returns a reference to the line at (line) if it exists, otherwise a reference to an empty NumericLine
+			static const NumericLine emptyLine;
+			return (line < size()) ? contents[line] : emptyLine;
 		}
-		std::string                            getLineAsString         (std::size_t line) const
+		std::string                            getLineAsString         (std::size_t line, const NumericFormat & format = NumericFormat()) const
 		{
-			// Returns a line in the file as a string
+			// Returns a line in the file as a string, its values written in 'format'
+			std::string result;
 			if (line < size())
 			{
-				std::string result;
-				std::stringstream stream;
-				for (unsigned int i = 0; i < lineSize(line) - 1; ++i)
-				{
-					stream << contents.at(line).at(i) << " ";
-				}
-				if (lineSize(line))
-				{
-					stream << contents.at(line).at(lineSize(line) - 1);
-				};
-				std::getline(stream, result);
-				return result;
+				NFPF::appendFormattedValues(result, contents[line].cbegin(), contents[line].cend(), format);
 			}
-			return "";
+			return result;
 		}
-		const std::deque<NumericLine> &        getFileContents         () const
+		const Contents &                       getFileContents         () const
 		{
 			// Returns the content of the file as a deque of NumericLines
 			return contents;
@@ -132,6 +418,16 @@ namespace fileFunctions
 			// Returns the fileName associated with the NumericFile
 			return fileName;
 		}
+		std::string_view                       getFileNameView         () const
+		{
+			// Returns a view of the fileName associated with the NumericFile
+			return fileName;
+		}
+		AllocatorType                          getAllocator            () const
+		{
+			// Returns the allocator used for the lines of the file
+			return AllocatorType(contents.get_allocator());
+		}
 		FileCloseAction                        getClosingAction        () const
 		{
 			// Returns the closing action
@@ -226,11 +522,21 @@ namespace fileFunctions
 			// Appends a line to the file
 			contents.push_back(line);
 		}
+		void appendLineToFile     (NumericLine && line)
+		{
+			// Appends a line to the file, taking over the storage of 'line'
+			contents.push_back(std::move(line));
+		}
 		void prependLineToFile    (const NumericLine & line)
 		{
 			// Prepends a line to the file
 			contents.push_front(line);
 		}
+		void prependLineToFile    (NumericLine && line)
+		{
+			// Prepends a line to the file, taking over the storage of 'line'
+			contents.push_front(std::move(line));
+		}
 		void insertLineInFile     (std::size_t line, const NumericLine & numericLine)
 		{
 			// Inserts a line into the file if possible
@@ -239,6 +545,14 @@ namespace fileFunctions
 				contents.insert(contents.begin() + line, numericLine);
 			}
 		}
+		void insertLineInFile     (std::size_t line, NumericLine && numericLine)
+		{
+			// Inserts a line into the file if possible, taking over the storage of 'numericLine'
+			if (line < size())
+			{
+				contents.insert(contents.begin() + line, std::move(numericLine));
+			}
+		}
 		void removeEntry          (std::size_t line, std::size_t index)
 		{
 			// Removes an entry from the file if it exists
@@ -339,7 +653,7 @@ namespace fileFunctions
 			// Clears the contents of the file, then loads the contents of the file 'fileName'
 			std::fstream file(fileName, std::ios::in);
 			clearContents();
-			contents.push_back(NumericLine());
+			contents.emplace_back();
 			if (file.is_open())
 			{
 				double buffer;
@@ -348,7 +662,7 @@ namespace fileFunctions
 					contents.at(size() - 1).push_back(buffer);
 					if (file.peek() == '\n')
 					{
-						contents.push_back(NumericLine());
+						contents.emplace_back();
 					}
 				}
 			}
@@ -358,7 +672,7 @@ namespace fileFunctions
 			// Clears the contents of the file, then loads the contents of the file 'filePath'
 			std::fstream file(filePath, std::ios::in);
 			clearContents();
-			contents.push_back(NumericLine());
+			contents.emplace_back();
 			if (file.is_open())
 			{
 				double buffer;
@@ -367,7 +681,7 @@ namespace fileFunctions
 					contents.at(size() - 1).push_back(buffer);
 					if (file.peek() == '\n')
 					{
-						contents.push_back(NumericLine());
+						contents.emplace_back();
 					}
 				}
 			}
@@ -376,7 +690,7 @@ namespace fileFunctions
 		{
 			// Loads the contents of the file 'fileName' and appends them to the current contents
 			std::fstream file(fileName, std::ios::in);
-			contents.push_back(NumericLine());
+			contents.emplace_back();
 			if (file.is_open())
 			{
 				double buffer;
@@ -385,7 +699,7 @@ namespace fileFunctions
 					contents.at(size() - 1).push_back(buffer);
 					if (file.peek() == '\n')
 					{
-						contents.push_back(NumericLine());
+						contents.emplace_back();
 					}
 				}
 			}
@@ -394,7 +708,7 @@ namespace fileFunctions
 		{
 			// Loads the contents of the file 'filePath' and appends them to the current contents
 			std::fstream file(filePath, std::ios::in);
-			contents.push_back(NumericLine());
+			contents.emplace_back();
 			if (file.is_open())
 			{
 				double buffer;
@@ -403,537 +717,582 @@ namespace fileFunctions
 					contents.at(size() - 1).push_back(buffer);
 					if (file.peek() == '\n')
 					{
-						contents.push_back(NumericLine());
+						contents.emplace_back();
 					}
 				}
 			}
 		}
-		void        outputToStream                  (std::ostream & ostr) const
+		bool        bulkLoadFromFile                (ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Clears the contents of the file, then loads the contents of the file 'fileName' with the bulk parser
+			clearContents();
+			return bulkLoadLines(fileName, mode);
+		}
+		bool        bulkLoadFromFile                (const std::string & filePath, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Clears the contents of the file, then loads the contents of the file 'filePath' with the bulk parser.
+			// Unlike loadFromFile, every line of text becomes exactly one line (blank lines included), values
+			// may also be separated by commas or semicolons, and tokens that aren't numbers are skipped
+			// rather than ending the load. Returns false if the file couldn't be opened or had such tokens.
+			clearContents();
+			return bulkLoadLines(filePath, mode);
+		}
+		bool        bulkLoadFromFileAndAppend       (ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Loads the contents of the file 'fileName' with the bulk parser and appends them to the current contents
+			return bulkLoadLines(fileName, mode);
+		}
+		bool        bulkLoadFromFileAndAppend       (const std::string & filePath, ExecutionMode mode = ExecutionMode::SEQUENTIAL)
+		{
+			// Loads the contents of the file 'filePath' with the bulk parser and appends them to the current contents
+			return bulkLoadLines(filePath, mode);
+		}
+		bool        loadFromBinaryFile              (const std::string & filePath)
 		{
-			// Outputs the contents of the file to a std::ostream
-			for (NumericLine i : contents)
+			// Clears the contents of the file, then loads the binary file 'filePath' (see NumericBinary.hpp).
+			// Returns false, leaving the file empty, if 'filePath' couldn't be read or isn't in either format.
+			std::vector<std::size_t> rowOffsets;
+			std::vector<double> values;
+			clearContents();
+			if (!NFPF::readBinaryNumericFile(filePath, rowOffsets, values))
 			{
-				for (double j : i)
-				{
-					if (ostr.good())
-					{
-						ostr << j << " ";
-					}
-				}
-				ostr << std::endl;
+				return false;
 			}
+			for (std::size_t i = 0; i + 1 < rowOffsets.size(); ++i)
+			{
+				contents.emplace_back(values.begin() + rowOffsets[i], values.begin() + rowOffsets[i + 1]);
+			}
+			return true;
+		}
+		bool        outputToBinaryFile              (const std::string & filePath) const
+		{
+			// Saves the contents of the file to 'filePath' as a .npy file if every line has the same, non-zero length,
+			// otherwise in the ragged format (see NumericBinary.hpp). Returns false if the file couldn't be written.
+			return NFPF::writeBinaryNumericFile(filePath, size(), [this](std::size_t line) -> const NumericLine & { return contents[line]; });
+		}
+		void        outputToStream                  (std::ostream & ostr, const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
+		{
+			// Outputs the contents of the file to a std::ostream, one line per line of values, the values written in
+			// 'format'. With mode == PARALLEL, lines are formatted on several threads and still written in order.
+			NFPF::writeRows(ostr, size(), [this](std::size_t line) -> const NumericLine & { return contents[line]; }, format, mode);
 		}
-		void        outputToFile                    () const
+		void        outputToFile                    (const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
 		{
 			// Outputs the contents of the file to the file 'fileName'
-			std::fstream file(fileName, std::ios::out);
-			for (NumericLine i : contents)
-			{
-				for (double j : i)
-				{
-					if (file.is_open())
-					{
-						file << j << " ";
-					}
-				}
-				if (file.is_open())
-				{
-					file << std::endl;
-				}
-			}
+			outputToFile(fileName, format, mode);
 		}
-		void        outputToFile                    (const std::string & filePath) const
+		void        outputToFile                    (const std::string & filePath, const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
 		{
 			// Outputs the contents of the file to the file 'filePath'
 			std::fstream file(filePath, std::ios::out);
-			for (NumericLine i : contents)
+			if (file.is_open())
 			{
-				for (double j : i)
-				{
-					if (file.is_open())
-					{
-						file << j << " ";
-					}
-				}
-				if (file.is_open())
-				{
-					file << std::endl;
-				}
+				outputToStream(file, format, mode);
 			}
 		}
-		void        appendToFile                    () const
+		void        appendToFile                    (const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
 		{
 			// Appends the contents of the file to the file 'fileName'
-			std::fstream file(fileName, std::ios::out | std::ios::app);
-			for (NumericLine i : contents)
-			{
-				for (double j : i)
-				{
-					if (file.is_open())
-					{
-						file << j << " ";
-					}
-				}
-				if (file.is_open())
-				{
-					file << std::endl;
-				}
-			}
+			appendToFile(fileName, format, mode);
 		}
-		void        appendToFile                    (const std::string & filePath) const
+		void        appendToFile                    (const std::string & filePath, const NumericFormat & format = NumericFormat(), ExecutionMode mode = ExecutionMode::SEQUENTIAL) const
 		{
 			// Appends the contents of the file to the file 'filePath'
 			std::fstream file(filePath, std::ios::out | std::ios::app);
-			for (NumericLine i : contents)
+			if (file.is_open())
 			{
-				for (double j : i)
-				{
-					if (file.is_open())
-					{
-						file << j << " ";
-					}
-				}
-				if (file.is_open())
-				{
-					file << std::endl;
-				}
+				outputToStream(file, format, mode);
 			}
 		}
-		void        applyFunctionToEntry            (std::size_t line, std::size_t index, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToEntry            (std::size_t line, std::size_t index, const FunctionType & function)
 		{
 			// Applies a function that takes a double and returns a double to an entry in the file
 			if (line < size() && index < lineSize(line))
 			{
-				contents.at(line).at(index) = function(contents.at(line).at(index));
+				contents[line][index] = function(contents[line][index]);
 			}
 		}
-		void        applyFunctionToEntries          (std::size_t line, std::size_t lowerBound, std::size_t upperBound, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToEntries          (std::size_t line, std::size_t lowerBound, std::size_t upperBound, const FunctionType & function)
 		{
 			// Applies a function that takes a double and returns a double to a set of entries in a line in the file
 			if (line < size())
 			{
 				FWPF::validateBounds(lowerBound, upperBound);
-				for (unsigned int i = lowerBound; i <= upperBound && i < lineSize(line); ++i)
+				NumericLine & current = contents[line];
+				for (std::size_t i = lowerBound; i <= upperBound && i < current.size(); ++i)
 				{
-					contents.at(line).at(i) = function(contents.at(line).at(i));
+					current[i] = function(current[i]);
 				}
 			}
 		}
-		void        applyFunctionToEntryInLines     (std::size_t entry, std::size_t lowerBound, std::size_t upperBound, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToEntryInLines     (std::size_t entry, std::size_t lowerBound, std::size_t upperBound, const FunctionType & function)
 		{
 			// Applies a function that takes a double and returns a double to an entry in a set of lines
 			FWPF::validateBounds(lowerBound, upperBound);
-			for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
+			for (std::size_t i = lowerBound; i <= upperBound && i < size(); ++i)
 			{
 				if (entry < lineSize(i))
 				{
-					contents.at(i).at(entry) = function(contents.at(i).at(entry));
+					contents[i][entry] = function(contents[i][entry]);
 				}
 			}
 		}
-		void        applyFunctionToEntriesInLines   (std::size_t lowerEntry, std::size_t upperEntry, std::size_t lowerBound, std::size_t upperBound, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToEntriesInLines   (std::size_t lowerEntry, std::size_t upperEntry, std::size_t lowerBound, std::size_t upperBound, const FunctionType & function)
 		{
 			// Applies a function that takes a double and returns a double to a set of entries in a set of lines
 			FWPF::validateBounds(lowerEntry, upperEntry);
 			FWPF::validateBounds(lowerBound, upperBound);
-			for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
+			for (std::size_t i = lowerBound; i <= upperBound && i < size(); ++i)
 			{
-				for (unsigned int j = lowerEntry; j <= upperEntry && j < lineSize(i); ++j)
+				NumericLine & current = contents[i];
+				for (std::size_t j = lowerEntry; j <= upperEntry && j < current.size(); ++j)
 				{
-					contents.at(i).at(j) = function(contents.at(i).at(j));
+					current[j] = function(current[j]);
 				}
 			}
 		}
-		void        applyFunctionToEntryInContents  (std::size_t index, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToEntryInContents  (std::size_t index, const FunctionType & function)
 		{
 			// Applies a function to a single entry in each line of the file
 			for (NumericLine & i : contents)
 			{
 				if (index < i.size())
 				{
-					i.at(index) = function(i.at(index));
+					i[index] = function(i[index]);
 				}
 			}
 		}
-		void        applyFunctionToEntriesInContents(std::size_t lowerBound, std::size_t upperBound, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToEntriesInContents(std::size_t lowerBound, std::size_t upperBound, const FunctionType & function)
 		{
 			// Applies a function to a set of entries in each line of the file
 			FWPF::validateBounds(lowerBound, upperBound);
-			for (unsigned int i = 0; i < size(); ++i)
+			for (NumericLine & i : contents)
 			{
-				for (unsigned int j = lowerBound; j <= upperBound && j < lineSize(i); ++j)
+				for (std::size_t j = lowerBound; j <= upperBound && j < i.size(); ++j)
 				{
-					contents.at(i).at(j) = function(contents.at(i).at(j));
+					i[j] = function(i[j]);
 				}
 			}
 		}
-		void        applyFunctionToLine             (std::size_t line, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToLine             (std::size_t line, const FunctionType & function)
 		{
 			// Applies a function that takes a double and returns a double to each entry in a line in the file
 			if (line < size())
 			{
-				for (double & i : contents.at(line))
-				{
-					i = function(i);
-				}
+				std::transform(contents[line].begin(), contents[line].end(), contents[line].begin(), function);
 			}
 		}
-		void        applyFunctionToLines            (std::size_t lowerBound, std::size_t upperBound, const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToLines            (std::size_t lowerBound, std::size_t upperBound, const FunctionType & function)
 		{
 			// Applies a function that takes a double and returns a double to each entry in a set of lines in the file
 			FWPF::validateBounds(lowerBound, upperBound);
-			for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
+			for (std::size_t i = lowerBound; i <= upperBound && i < size(); ++i)
 			{
-				for (double & j : contents.at(i))
-				{
-					j = function(j);
-				}
+				std::transform(contents[i].begin(), contents[i].end(), contents[i].begin(), function);
 			}
 		}
-		void        applyFunctionToContents         (const std::function<double (double)> & function)
+		template <typename FunctionType>
+		void        applyFunctionToContents         (const FunctionType & function)
 		{
 			// Applies a function that takes a double and returns a double to every entry in the file
 			for (NumericLine & i : contents)
 			{
-				for (double & j : i)
-				{
-					j = function(j);
-				}
+				std::transform(i.begin(), i.end(), i.begin(), function);
 			}
 		}
-		void        sortLine                        (std::size_t line, const std::function<bool (double, double)> & predicate = std::less<double>())
+		template <typename PredicateType = std::less<double>>
+		void        sortLine                        (std::size_t line, const PredicateType & predicate = PredicateType())
 		{
-			// Sorts a line in the file
+			// Sorts a line in the file. The default ascending order uses a radix sort and puts NaNs last.
+			sortLine(line, ExecutionMode::SEQUENTIAL, predicate);
+		}
+		template <typename PredicateType = std::less<double>>
+		void        sortLine                        (std::size_t line, ExecutionMode execution, const PredicateType & predicate = PredicateType())
+		{
+			// Sorts a line in the file, splitting a long line across threads when execution == PARALLEL
 			if (line < size())
 			{
-				std::sort(contents.at(line).begin(), contents.at(line).end(), predicate);
+				std::vector<double> buffer;
+				NFPF::sortNumericLine(contents[line], predicate, execution, buffer);
 			}
 		}
-		void        sortLines                       (std::size_t lowerBound, std::size_t upperBound, const std::function<bool (double, double)> & predicate = std::less<double>())
+		template <typename PredicateType = std::less<double>>
+		void        sortLines                       (std::size_t lowerBound, std::size_t upperBound, const PredicateType & predicate = PredicateType())
 		{
 			// Sorts a set of lines in the file, sorting each line individually and independently from the other lines
-			FWPF::validateBounds(lowerBound, upperBound);
-			for (unsigned int i = lowerBound; i < size() && i <= upperBound; ++i)
-			{
-				std::sort(contents.at(i).begin(), contents.at(i).end(), predicate);
-			}
+			sortLines(lowerBound, upperBound, ExecutionMode::SEQUENTIAL, predicate);
 		}
-		void        sortContents                    (const std::function<bool (double, double)> & predicate = std::less<double>())
+		template <typename PredicateType = std::less<double>>
+		void        sortLines                       (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, const PredicateType & predicate = PredicateType())
 		{
-			// Sorts every line in the file, sorting each line individually and independently from the other lines
-			for (NumericLine & i : contents)
-			{
-				std::sort(i.begin(), i.end(), predicate);
-			}
+			// Sorts a set of lines in the file, sorting lines concurrently when execution == PARALLEL
+			NFPF::sortNumericLines(contents.begin() + (rangeBegin(lowerBound, upperBound) - contents.cbegin()), contents.begin() + (rangeEnd(lowerBound, upperBound) - contents.cbegin()), predicate, execution);
 		}
-		// Computational Utilities
-		double computeValueFromLine                     (std::size_t line, const std::function<double (const std::deque<double> &)> & function) const
+		template <typename PredicateType = std::less<double>>
+		void        sortContents                    (const PredicateType & predicate = PredicateType())
 		{
-			// Computes a value from a line in the file using a function that takes a deque of doubles and returns a double
-			return line < size() ? function(contents.at(line)) : 0;
+			// Sorts every line in the file, sorting each line individually and independently from the other lines
+			sortContents(ExecutionMode::SEQUENTIAL, predicate);
 		}
-		template <class T>
-		double computeValueFromLine                     (std::size_t line, const std::function<double (const std::deque<double> &, const T &)> & function, const T & parameterOne) const
+		template <typename PredicateType = std::less<double>>
+		void        sortContents                    (ExecutionMode execution, const PredicateType & predicate = PredicateType())
 		{
-			// Computes a value from a line in the file using a function that takes a deque of doubles and another parameter and returns a double
-			return line < size() ? function(contents.at(line), parameterOne) : 0;
+			// Sorts every line in the file, sorting lines concurrently when execution == PARALLEL
+			NFPF::sortNumericLines(contents.begin(), contents.end(), predicate, execution);
 		}
-		template <class T, class U>
-		double computeValueFromLine                     (std::size_t line, const std::function<double (const std::deque<double> &, const T &, const U &)> & function, const T & parameterOne, const U & parameterTwo) const
+		template <typename PredicateType = std::less<double>>
+		void        sortLinesByEntry                (std::size_t index, std::size_t lowerBound, std::size_t upperBound, const PredicateType & predicate = PredicateType())
 		{
-			// Computes a value from a line in the file using a function that takes a deque of doubles and two parameters and returns a double
-			return line < size() ? function(contents.at(line), parameterOne, parameterTwo) : 0;
+			// Reorders the lines [lowerBound, upperBound] by their index-th entries, keeping the order of lines with equal entries.
+			// Lines without an index-th entry go after the others.
+			NFPF::sortNumericLinesByEntry(contents.begin() + (rangeBegin(lowerBound, upperBound) - contents.cbegin()), contents.begin() + (rangeEnd(lowerBound, upperBound) - contents.cbegin()), index, predicate);
 		}
-		double computeValueFromLineUsingIteratorFunction(std::size_t line, const std::function<double (ConstNumericLineIterator, ConstNumericLineIterator)> & function) const
+		template <typename PredicateType = std::less<double>>
+		void        sortContentsByEntry             (std::size_t index, const PredicateType & predicate = PredicateType())
 		{
-			// Computes a value from a line in the file using a function that takes two iterators and returns a double
-			return line < size() ? function(contents.at(line).cbegin(), contents.at(line).cend()) : 0;
+			// Reorders the lines of the file by their index-th entries, as sortLinesByEntry does
+			NFPF::sortNumericLinesByEntry(contents.begin(), contents.end(), index, predicate);
 		}
-		template <class T>
-		double computeValueFromLineUsingIteratorFunction(std::size_t line, const std::function<double (ConstNumericLineIterator, ConstNumericLineIterator, const T &)> & function, const T & parameterOne) const
+		// Computational Utilities
+		template <typename FunctionType, typename... Args>
+		double computeValueFromLine                     (std::size_t line, const FunctionType & function, const Args &... args) const
 		{
-			// Computes a value from a line in the file using a function that takes two iterators and another parameter and returns a double
-			return line < size() ? function(contents.at(line).cbegin(), contents.at(line).cend(), parameterOne) : 0;
+			// Computes a value from a line in the file using a function that takes a deque of doubles, followed by 'args', and returns a double
+			return line < size() ? static_cast<double>(function(contents[line], args...)) : 0;
 		}
-		template <class T, class U>
-		double computeValueFromLineUsingIteratorFunction(std::size_t line, const std::function<double (ConstNumericLineIterator, ConstNumericLineIterator, const T &, const U &)> & function, const T & parameterOne, const U & parameterTwo) const
+		template <typename FunctionType, typename... Args>
+		double computeValueFromLineUsingIteratorFunction(std::size_t line, const FunctionType & function, const Args &... args) const
 		{
-			// Computes a value from a line in the file using a function that takes two iterators and another parameter and returns a double
-			return line < size() ? function(contents.at(line).cbegin(), contents.at(line).cend(), parameterOne, parameterTwo) : 0;
+			// Computes a value from a line in the file using a function that takes two iterators, followed by 'args', and returns a double
+			return line < size() ? static_cast<double>(function(contents[line].cbegin(), contents[line].cend(), args...)) : 0;
 		}
-		double computeSumOfLine                         (std::size_t line) const
+		double computeSumOfLine                         (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the sum of the contents of a line in the file
-			return line < size() ? std::accumulate(contents.at(line).begin(), contents.at(line).end(), 0.0) : 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::SUM>(rangeBegin(line, line), rangeEnd(line, line), 0, mode);
 		}
-		double computeSumOfLines                        (std::size_t lowerBound, std::size_t upperBound) const
+		double computeSumOfLines                        (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the sum of a set of lines in the file
-			FWPF::validateBounds(lowerBound, upperBound);
-			double sum = 0;
-			for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
-			{
-				sum += std::accumulate(contents.at(i).begin(), contents.at(i).end(), 0.0);
-			}
-			return sum;
+			return NFPF::reduceRanges<NFPF::ReductionType::SUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), 0, mode);
 		}
-		double computeSumOfContents                     () const
+		double computeSumOfLines                        (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the sum of a set of lines in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::SUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), 0, mode, execution);
+		}
+		double computeSumOfContents                     (SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the sum of the contents of the file
-			double sum = 0;
-			for (NumericLine i : contents)
-			{
-				sum += std::accumulate(i.begin(), i.end(), 0.0);
-			}
-			return sum;
+			return NFPF::reduceRanges<NFPF::ReductionType::SUM>(contents.cbegin(), contents.cend(), 0, mode);
+		}
+		double computeSumOfContents                     (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the sum of the contents of the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::SUM>(contents.cbegin(), contents.cend(), 0, mode, execution);
 		}
-		double computeAbsoluteSumOfLine                 (std::size_t line) const
+		double computeAbsoluteSumOfLine                 (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes sum(abs(elements)) in line (line)
-			if (line < size())
-			{
-				double sum = 0;
-				for (unsigned int i = 0; i < lineSize(line); ++i)
-				{
-					sum += std::abs(contents.at(line).at(i));
-				}
-				return sum;
-			}
-			return 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::ABSOLUTE_SUM>(rangeBegin(line, line), rangeEnd(line, line), 0, mode);
 		}
-		double computeAbsoluteSumOfLines                (std::size_t lowerBound, std::size_t upperBound) const
+		double computeAbsoluteSumOfLines                (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes sum(abs(elements)) in range[lowerBound, upperBound]
-			FWPF::validateBounds(lowerBound, upperBound);
-			if (lowerBound < size())
-			{
-				double sum = 0;
-				for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
-				{
-					for (unsigned int j = 0; j < lineSize(i); ++j)
-					{
-						sum += std::abs(contents.at(i).at(j));
-					}
-				}
-				return sum;
-			}
-			return 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::ABSOLUTE_SUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), 0, mode);
+		}
+		double computeAbsoluteSumOfLines                (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes sum(abs(elements)) in range[lowerBound, upperBound], splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::ABSOLUTE_SUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), 0, mode, execution);
 		}
-		double computeAbsoluteSumOfContents             () const
+		double computeAbsoluteSumOfContents             (SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes sum(abs(element)) for every element in the file
-			double sum = 0;
-			for (NumericLine i : contents)
-			{
-				for (double j : i)
-				{
-					sum += std::abs(j);
-				}
-			}
-			return sum;
+			return NFPF::reduceRanges<NFPF::ReductionType::ABSOLUTE_SUM>(contents.cbegin(), contents.cend(), 0, mode);
 		}
-		double computeAverageOfLine                     (std::size_t line) const
+		double computeAbsoluteSumOfContents             (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes sum(abs(element)) for every element in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::ABSOLUTE_SUM>(contents.cbegin(), contents.cend(), 0, mode, execution);
+		}
+		double computeAverageOfLine                     (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the average of a line in the file
-			return lineSize(line) ? std::accumulate(contents.at(line).begin(), contents.at(line).end(), 0.0) / lineSize(line) : 0;
+			return NFPF::averageOfRanges(rangeBegin(line, line), rangeEnd(line, line), mode);
 		}
-		double computeAverageOfLines                    (std::size_t lowerBound, std::size_t upperBound) const
+		double computeAverageOfLines                    (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the average of a set of lines in the file
-			FWPF::validateBounds(lowerBound, upperBound);
-			double sum = 0;
-			std::size_t numElems = 0;
-			for (unsigned int i = lowerBound; i <= upperBound; ++i)
-			{
-				sum += std::accumulate(contents.at(i).begin(), contents.at(i).end(), 0.0);
-				numElems += lineSize(i);
-			}
-			return numElems ? sum / numElems : 0;
+			return NFPF::averageOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), mode);
 		}
-		double computeAverageOfContents                 () const
+		double computeAverageOfLines                    (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the average of a set of lines in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::averageOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), mode, execution);
+		}
+		double computeAverageOfContents                 (SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the average of all the data in the file
-			double sum = 0;
-			std::size_t numElems = 0;
-			for (unsigned int i = 0; i < size(); ++i)
-			{
-				sum += std::accumulate(contents.at(i).begin(), contents.at(i).end(), 0.0);
-				numElems += lineSize(i);
-			}
-			return numElems ? sum / numElems : 0;
+			return NFPF::averageOfRanges(contents.cbegin(), contents.cend(), mode);
+		}
+		double computeAverageOfContents                 (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the average of all the data in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::averageOfRanges(contents.cbegin(), contents.cend(), mode, execution);
 		}
-		double computeAbsoluteAverageOfLine             (std::size_t line) const
+		double computeAbsoluteAverageOfLine             (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the absolute average of the line (line)
-			return line < size() ? (lineSize(line) ? computeAbsoluteSumOfLine(line) / lineSize(line) : 0) : 0;
+			return NFPF::absoluteAverageOfRanges(rangeBegin(line, line), rangeEnd(line, line), mode);
 		}
-		double computeAbsoluteAverageOfLines            (std::size_t lowerBound, std::size_t upperBound) const
+		double computeAbsoluteAverageOfLines            (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the absolute average of the lines in the range [lowerBound, upperBound]
-			FWPF::validateBounds(lowerBound, upperBound);
-			std::size_t numElems;
-			for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
-			{
-				numElems += lineSize(i);
-			}
-			return numElems ? computeAbsoluteSumOfLines(lowerBound, upperBound) / numElems : 0;
+			return NFPF::absoluteAverageOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), mode);
 		}
-		double computeAbsoluteAverageOfContents         () const
+		double computeAbsoluteAverageOfLines            (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the absolute average of the lines in the range [lowerBound, upperBound], splitting the work across threads when execution == PARALLEL
+			return NFPF::absoluteAverageOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), mode, execution);
+		}
+		double computeAbsoluteAverageOfContents         (SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the absolute average of the lines in the file
-			std::size_t numElems;
-			for (unsigned int i = 0; i < size(); ++i)
-			{
-				numElems += lineSize(i);
-			}
-			return numElems ? computeAbsoluteSumOfContents() / numElems : 0;
+			return NFPF::absoluteAverageOfRanges(contents.cbegin(), contents.cend(), mode);
+		}
+		double computeAbsoluteAverageOfContents         (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the absolute average of the lines in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::absoluteAverageOfRanges(contents.cbegin(), contents.cend(), mode, execution);
 		}
-		double computeVarianceOfLine                    (std::size_t line) const
+		double computeVarianceOfLine                    (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the variance of a line in the file
-			if (line < size())
-			{
-				if (lineSize(line))
-				{
-					double mean = computeAverageOfLine(line);
-					double sumOfSquares = 0;
-					for (double i : contents.at(line))
-					{
-						sumOfSquares += (i - mean) * (i - mean);
-					}
-					return sumOfSquares / lineSize(line);
-				}
-				return 0;
-			}
-			return 0;
+			return NFPF::varianceOfRanges(rangeBegin(line, line), rangeEnd(line, line), mode);
 		}
-		double computeVarianceOfLines                   (std::size_t lowerBound, std::size_t upperBound) const
+		double computeVarianceOfLines                   (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the variance of a set of lines in the file
-			FWPF::validateBounds(lowerBound, upperBound);
-			double mean = computeAverageOfLines(lowerBound, upperBound);
-			double sumOfSquares = 0;
-			std::size_t numElems = 0;
-			for (unsigned int i = lowerBound; i <= upperBound && i < size(); ++i)
-			{
-				for (unsigned int j = 0; j < lineSize(i); ++j)
-				{
-					sumOfSquares += (contents.at(i).at(j) - mean) * (contents.at(i).at(j) - mean);
-				}
-				numElems += lineSize(i);
-			}
-			return numElems ? sumOfSquares / numElems : 0;
+			return NFPF::varianceOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), mode);
+		}
+		double computeVarianceOfLines                   (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the variance of a set of lines in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::varianceOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), mode, execution);
 		}
-		double computeVarianceOfContents                () const
+		double computeVarianceOfContents                (SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the variance of the data in the file
-			double mean = computeAverageOfContents();
-			double sumOfSquares = 0;
-			std::size_t numElems = 0;
-			for (unsigned int i = 0; i < size(); ++i)
-			{
-				for (unsigned int j = 0; j < lineSize(i); ++j)
-				{
-					sumOfSquares += (contents.at(i).at(j) - mean) * (contents.at(i).at(j) - mean);
-				}
-				numElems += lineSize(i);
-			}
-			return numElems ? sumOfSquares / numElems : 0;
+			return NFPF::varianceOfRanges(contents.cbegin(), contents.cend(), mode);
 		}
-		double computeStandardDeviationOfLine           (std::size_t line) const
+		double computeVarianceOfContents                (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the variance of the data in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::varianceOfRanges(contents.cbegin(), contents.cend(), mode, execution);
+		}
+		double computeStandardDeviationOfLine           (std::size_t line, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the standard deviation of a line in the file
-			return std::sqrt(computeVarianceOfLine(line));
+			return std::sqrt(computeVarianceOfLine(line, mode));
 		}
-		double computeStandardDeviationOfLines          (std::size_t lowerBound, std::size_t upperBound) const
+		double computeStandardDeviationOfLines          (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the standard deviation of a set of lines in the file
-			return std::sqrt(computeVarianceOfLines(lowerBound, upperBound));
+			return std::sqrt(computeVarianceOfLines(lowerBound, upperBound, mode));
 		}
-		double computeStandardDeviationOfContents       () const
+		double computeStandardDeviationOfLines          (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the standard deviation of a set of lines in the file, splitting the work across threads when execution == PARALLEL
+			return std::sqrt(computeVarianceOfLines(lowerBound, upperBound, execution, mode));
+		}
+		double computeStandardDeviationOfContents       (SummationMode mode = SummationMode::STANDARD) const
 		{
 			// Computes the standard deviation of the data in the file
-			return std::sqrt(computeVarianceOfContents());
+			return std::sqrt(computeVarianceOfContents(mode));
+		}
+		double computeStandardDeviationOfContents       (ExecutionMode execution, SummationMode mode = SummationMode::STANDARD) const
+		{
+			// Computes the standard deviation of the data in the file, splitting the work across threads when execution == PARALLEL
+			return std::sqrt(computeVarianceOfContents(execution, mode));
 		}
 		double computeMinimumOfLine                     (std::size_t line) const
 		{
 			// Returns the minimum value in the line (line)
-			return line < size() ? *std::min_element(contents.at(line).begin(), contents.at(line).end()) : 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::MINIMUM>(rangeBegin(line, line), rangeEnd(line, line));
 		}
 		double computeMinimumOfLines                    (std::size_t lowerBound, std::size_t upperBound) const
 		{
 			// Compute the minimum value in the range [lowerBound, upperBound]
-			FWPF::validateBounds(lowerBound, upperBound);
-			if (lowerBound < size())
-			{
-				double minimum = *std::min_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end());
-				++lowerBound;
-				while (lowerBound <= upperBound && lowerBound < size())
-				{
-					minimum = std::min(minimum, *std::min_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end()));
-					++lowerBound;
-				}
-				return minimum;
-			}
-			return 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::MINIMUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound));
+		}
+		double computeMinimumOfLines                    (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			// Compute the minimum value in the range [lowerBound, upperBound], splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::MINIMUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), 0, SummationMode::STANDARD, execution);
 		}
 		double computeMinimumOfContents                 () const
 		{
 			// Compute the minimum value in the file
-			std::size_t lowerBound = 0;
-			std::size_t upperBound = size();
-			if (lowerBound < upperBound)
-			{
-				double minimum = *std::min_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end());
-				++lowerBound;
-				while (lowerBound != upperBound)
-				{
-					minimum = std::min(minimum, *std::min_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end()));
-					++lowerBound;
-				}
-				return minimum;
-			}
-			return 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::MINIMUM>(contents.cbegin(), contents.cend());
+		}
+		double computeMinimumOfContents                 (ExecutionMode execution) const
+		{
+			// Compute the minimum value in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::MINIMUM>(contents.cbegin(), contents.cend(), 0, SummationMode::STANDARD, execution);
 		}
 		double computeMaximumOfLine                     (std::size_t line) const
 		{
 			// Returns the maximum value in the line (line)
-			return line < size() ? *std::max_element(contents.at(line).begin(), contents.at(line).end()) : 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::MAXIMUM>(rangeBegin(line, line), rangeEnd(line, line));
 		}
 		double computeMaximumOfLines                    (std::size_t lowerBound, std::size_t upperBound) const
 		{
 			// Compute the maximum value in the range [lowerBound, upperBound]
-			FWPF::validateBounds(lowerBound, upperBound);
-			if (lowerBound < size())
-			{
-				double maximum = *std::max_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end());
-				++lowerBound;
-				while (lowerBound <= upperBound && lowerBound < size())
-				{
-					maximum = std::max(maximum, *std::max_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end()));
-					++lowerBound;
-				}
-				return maximum;
-			}
-			return 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::MAXIMUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound));
+		}
+		double computeMaximumOfLines                    (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			// Compute the maximum value in the range [lowerBound, upperBound], splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::MAXIMUM>(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), 0, SummationMode::STANDARD, execution);
 		}
 		double computeMaximumOfContents                 () const
 		{
 			// Compute the maximum value in the file
-			std::size_t lowerBound = 0;
-			std::size_t upperBound = size();
-			if (lowerBound < upperBound)
-			{
-				double maximum = *std::max_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end());
-				++lowerBound;
-				while (lowerBound != upperBound)
-				{
-					maximum = std::max(maximum, *std::max_element(contents.at(lowerBound).begin(), contents.at(lowerBound).end()));
-					++lowerBound;
-				}
-				return maximum;
-			}
-			return 0;
+			return NFPF::reduceRanges<NFPF::ReductionType::MAXIMUM>(contents.cbegin(), contents.cend());
+		}
+		double computeMaximumOfContents                 (ExecutionMode execution) const
+		{
+			// Compute the maximum value in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::reduceRanges<NFPF::ReductionType::MAXIMUM>(contents.cbegin(), contents.cend(), 0, SummationMode::STANDARD, execution);
+		}
+		NumericSummary computeSummaryOfLine             (std::size_t line) const
+		{
+			// Computes every statistic above for a line in the file in one pass
+			return NFPF::summariseRanges(rangeBegin(line, line), rangeEnd(line, line));
+		}
+		NumericSummary computeSummaryOfLines            (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Computes every statistic above for the range [lowerBound, upperBound] in one pass
+			return NFPF::summariseRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound));
+		}
+		NumericSummary computeSummaryOfLines            (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			// Computes every statistic above for the range [lowerBound, upperBound] in one pass, splitting the work across threads when execution == PARALLEL
+			return NFPF::summariseRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), execution);
+		}
+		NumericSummary computeSummaryOfContents         () const
+		{
+			// Computes every statistic above for the file in one pass
+			return NFPF::summariseRanges(contents.cbegin(), contents.cend());
+		}
+		NumericSummary computeSummaryOfContents         (ExecutionMode execution) const
+		{
+			// Computes every statistic above for the file in one pass, splitting the work across threads when execution == PARALLEL
+			return NFPF::summariseRanges(contents.cbegin(), contents.cend(), execution);
+		}
+		NumericColumnSummary computeColumnSummaryOfLines   (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Computes every statistic above for each column (the index-th entry of every line) of the range [lowerBound, upperBound] in one pass over the lines
+			return columnSummaryOf(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), ExecutionMode::SEQUENTIAL);
+		}
+		NumericColumnSummary computeColumnSummaryOfLines   (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			// Computes every statistic above for each column of the range [lowerBound, upperBound], splitting the work across threads when execution == PARALLEL
+			return columnSummaryOf(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), execution);
+		}
+		NumericColumnSummary computeColumnSummaryOfContents() const
+		{
+			// Computes every statistic above for each column of the file in one pass over the lines
+			return columnSummaryOf(contents.cbegin(), contents.cend(), ExecutionMode::SEQUENTIAL);
+		}
+		NumericColumnSummary computeColumnSummaryOfContents(ExecutionMode execution) const
+		{
+			// Computes every statistic above for each column of the file, splitting the work across threads when execution == PARALLEL
+			return columnSummaryOf(contents.cbegin(), contents.cend(), execution);
+		}
+		double computeQuantileOfLine                    (std::size_t line, double quantile) const
+		{
+			// Computes the quantile-th quantile (0 being the minimum, 0.5 the median and 1 the maximum) of a line in the file, ignoring NaNs
+			return NFPF::quantileOfRanges(rangeBegin(line, line), rangeEnd(line, line), quantile);
+		}
+		double computeQuantileOfLines                   (std::size_t lowerBound, std::size_t upperBound, double quantile) const
+		{
+			// Computes the quantile-th quantile of a set of lines in the file, ignoring NaNs
+			return NFPF::quantileOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), quantile);
+		}
+		double computeQuantileOfContents                (double quantile) const
+		{
+			// Computes the quantile-th quantile of all the data in the file, ignoring NaNs
+			return NFPF::quantileOfRanges(contents.cbegin(), contents.cend(), quantile);
+		}
+		double computeMedianOfLine                      (std::size_t line) const
+		{
+			// Computes the median of a line in the file, ignoring NaNs
+			return computeQuantileOfLine(line, 0.5);
+		}
+		double computeMedianOfLines                     (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Computes the median of a set of lines in the file, ignoring NaNs
+			return computeQuantileOfLines(lowerBound, upperBound, 0.5);
+		}
+		double computeMedianOfContents                  () const
+		{
+			// Computes the median of all the data in the file, ignoring NaNs
+			return computeQuantileOfContents(0.5);
+		}
+		QuantileSketch computeQuantileSketchOfLines     (std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Builds an approximate sketch of the distribution of a set of lines in the file, from which any number of quantiles can be read
+			return NFPF::sketchRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound));
+		}
+		QuantileSketch computeQuantileSketchOfLines     (std::size_t lowerBound, std::size_t upperBound, ExecutionMode execution) const
+		{
+			// Builds an approximate sketch of the distribution of a set of lines in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::sketchRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), execution);
+		}
+		QuantileSketch computeQuantileSketchOfContents  () const
+		{
+			// Builds an approximate sketch of the distribution of all the data in the file
+			return NFPF::sketchRanges(contents.cbegin(), contents.cend());
+		}
+		QuantileSketch computeQuantileSketchOfContents  (ExecutionMode execution) const
+		{
+			// Builds an approximate sketch of the distribution of all the data in the file, splitting the work across threads when execution == PARALLEL
+			return NFPF::sketchRanges(contents.cbegin(), contents.cend(), execution);
+		}
+		NumericHistogram computeHistogramOfLine         (std::size_t line, NumericHistogram histogram) const
+		{
+			// Counts the values of a line in the file into the bins of 'histogram', adding to its counts
+			return NFPF::histogramOfRanges(rangeBegin(line, line), rangeEnd(line, line), std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfLines        (std::size_t lowerBound, std::size_t upperBound, NumericHistogram histogram) const
+		{
+			// Counts the values of a set of lines in the file into the bins of 'histogram', adding to its counts
+			return NFPF::histogramOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfLines        (std::size_t lowerBound, std::size_t upperBound, NumericHistogram histogram, ExecutionMode execution) const
+		{
+			// Counts the values of a set of lines in the file into the bins of 'histogram', splitting the work across threads when execution == PARALLEL
+			return NFPF::histogramOfRanges(rangeBegin(lowerBound, upperBound), rangeEnd(lowerBound, upperBound), std::move(histogram), execution);
+		}
+		NumericHistogram computeHistogramOfContents     (NumericHistogram histogram) const
+		{
+			// Counts all the data in the file into the bins of 'histogram', adding to its counts
+			return NFPF::histogramOfRanges(contents.cbegin(), contents.cend(), std::move(histogram));
+		}
+		NumericHistogram computeHistogramOfContents     (NumericHistogram histogram, ExecutionMode execution) const
+		{
+			// Counts all the data in the file into the bins of 'histogram', splitting the work across threads when execution == PARALLEL
+			return NFPF::histogramOfRanges(contents.cbegin(), contents.cend(), std::move(histogram), execution);
 		}
 		// Iterators
 		NumericFileIterator             begin  ()
@@ -977,7 +1336,7 @@ namespace fileFunctions
 			return contents.crend();
 		}
 		// Overloaded Operators
-		NumericFile &       operator =  (const NumericFile & rhs)
+		BasicNumericFile &  operator =  (const BasicNumericFile & rhs)
 		{
 			// Assignment operator
 			contents = rhs.getFileContents();
@@ -985,7 +1344,7 @@ namespace fileFunctions
 			closingAction = rhs.getClosingAction();
 			return *this;
 		}
-		NumericFile &       operator =  (NumericFile && rhs)
+		BasicNumericFile &  operator =  (BasicNumericFile && rhs)
 		{
 			// Move assignment operator
 			contents = std::move(rhs.getFileContents());
@@ -993,12 +1352,12 @@ namespace fileFunctions
 			closingAction = std::move(rhs.getClosingAction());
 			return *this;
 		}
-		bool                operator == (const NumericFile & rhs) const
+		bool                operator == (const BasicNumericFile & rhs) const
 		{
 			// Equivalence operator
 			return contents == rhs.getFileContents() && fileName == rhs.getFileName() && closingAction == rhs.getClosingAction();
 		}
-		bool                operator != (const NumericFile & rhs) const
+		bool                operator != (const BasicNumericFile & rhs) const
 		{
 			// Inequivalence operator
 			return contents != rhs.getFileContents() || fileName != rhs.getFileName() || closingAction != rhs.getClosingAction();
@@ -1008,10 +1367,50 @@ namespace fileFunctions
 			// Subscript operator
 			return contents.at(line);
 		}
-		NumericLine         operator [] (std::size_t line)
+		NumericLine &       operator [] (std::size_t line)
 		{
 			// Subscript operator
 			return contents.at(line);
 		}
+	private:
+		ConstNumericFileIterator lineIterator(std::size_t line) const
+		{
+			// Returns an iterator to a line, or to the end if it doesn't exist
+			return contents.cbegin() + std::min(line, size());
+		}
+		ConstNumericFileIterator rangeBegin(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Returns an iterator to the first of the lines [lowerBound, upperBound] that exist
+			FWPF::validateBounds(lowerBound, upperBound);
+			return lineIterator(lowerBound);
+		}
+		ConstNumericFileIterator rangeEnd(std::size_t lowerBound, std::size_t upperBound) const
+		{
+			// Returns an iterator past the last of the lines [lowerBound, upperBound] that exist
+			FWPF::validateBounds(lowerBound, upperBound);
+			return upperBound < size() ? contents.cbegin() + upperBound + 1 : contents.cend();
+		}
+		static NumericColumnSummary columnSummaryOf(ConstNumericFileIterator first, ConstNumericFileIterator last, ExecutionMode execution)
+		{
+			return NFPF::summariseColumns(static_cast<std::size_t>(last - first), [first](std::size_t i) -> const NumericLine &
+			{
+				return first[i];
+			}, execution);
+		}
+		bool bulkLoadLines(const std::string & filePath, ExecutionMode mode)
+		{
+			// Appends the lines of the file 'filePath', read by NFPF::forEachParsedNumericLine
+			return NFPF::forEachParsedNumericLine(filePath, mode, [this](const double * first, const double * last)
+			{
+				contents.emplace_back(first, last);
+			});
+		}
 	};
-}
\ No newline at end of file
+
+	typedef BasicNumericFile<> NumericFile;
+
+	namespace pmr
+	{
+		typedef BasicNumericFile<std::pmr::polymorphic_allocator<double>> NumericFile;
+	}
+}
@@ -0,0 +1,326 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <future>
+#include <limits>
+#include <fstream>
+#include <type_traits>
+
+#include "CompactNumericFile.hpp"
+
+namespace fileFunctions
+{
+	// Statistics over a numeric text file that is read and parsed a block at a time instead of being loaded,
+	// so memory use is bounded by the block size whatever the size of the file. While one block is parsed
+	// (across threads with ExecutionMode::PARALLEL) the next is already being read on another thread.
+	// The file is read again by every call; computing over a range of lines stops reading after the range.
+	//
+	// The results have the same bits as the same compute functions of NumericFile on the loaded file, except
+	// for the variance and standard deviation, which are taken from the single-pass NumericSummary rather
+	// than computed in two passes, so they equal NumericFile::computeSummaryOf*().getVariance(). Exact quantiles
+	// would need every value at once, so only the bounded-memory QuantileSketch is offered, built in one piece.
+	// The compute functions return 0 if the file can't be read; good() tells that apart from a real 0.
+	class NumericFileStream
+	{
+	private:
+		std::string   fileName;
+		ExecutionMode executionMode;
+		std::size_t   blockSize;
+		bool          succeeded;
+	public:
+		explicit NumericFileStream(const std::string & filePath, ExecutionMode mode = ExecutionMode::SEQUENTIAL, std::size_t bufferSize = std::size_t(16) << 20) : fileName(filePath), executionMode(mode), blockSize(std::max<std::size_t>(bufferSize, 1 << 12)), succeeded(true)
+		{
+			// Creates a NumericFileStream over the file 'filePath'. Up to two blocks of 'bufferSize' bytes,
+			// plus the values parsed from one of them, are held at a time.
+		}
+		std::string getFileName() const
+		{
+			return fileName;
+		}
+		bool        good       () const
+		{
+			// Returns false if the last pass over the file couldn't open it or found tokens that aren't numbers
+			return succeeded;
+		}
+		template <typename FunctionType>
+		bool        forEachLine(const FunctionType & function)
+		{
+			// Calls function(ConstNumericRow) for every line of the file, in order. If function returns a bool,
+			// returning false stops the pass. Returns good().
+			readLines([&function](const double * first, const double * last)
+			{
+				ConstNumericRow row(first, static_cast<std::size_t>(last - first));
+				if constexpr (std::is_same_v<decltype(function(row)), bool>)
+				{
+					return function(row);
+				}
+				else
+				{
+					function(row);
+					return true;
+				}
+			});
+			return succeeded;
+		}
+		template <typename... AccumulatorTypes>
+		bool        accumulate (AccumulatorTypes &... accumulators)
+		{
+			// Calls accumulator.add(first, last) on each accumulator (a NumericSummary, for instance) with the
+			// values of every line, in order, in one pass over the file. Returns good().
+			readLines([&accumulators...](const double * first, const double * last)
+			{
+				(accumulators.add(first, last), ...);
+				return true;
+			});
+			return succeeded;
+		}
+		// Statistics. Lines that don't exist are ignored, and anything computed over no values is 0.
+		double computeSumOfLine                  (std::size_t line, SummationMode mode = SummationMode::STANDARD)
+		{
+			return reduceLines<NFPF::ReductionType::SUM>(line, line, mode);
+		}
+		double computeSumOfLines                 (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD)
+		{
+			return reduceLines<NFPF::ReductionType::SUM>(lowerBound, upperBound, mode);
+		}
+		double computeSumOfContents              (SummationMode mode = SummationMode::STANDARD)
+		{
+			return reduceLines<NFPF::ReductionType::SUM>(0, std::numeric_limits<std::size_t>::max(), mode);
+		}
+		double computeAbsoluteSumOfLine          (std::size_t line, SummationMode mode = SummationMode::STANDARD)
+		{
+			return reduceLines<NFPF::ReductionType::ABSOLUTE_SUM>(line, line, mode);
+		}
+		double computeAbsoluteSumOfLines         (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD)
+		{
+			return reduceLines<NFPF::ReductionType::ABSOLUTE_SUM>(lowerBound, upperBound, mode);
+		}
+		double computeAbsoluteSumOfContents      (SummationMode mode = SummationMode::STANDARD)
+		{
+			return reduceLines<NFPF::ReductionType::ABSOLUTE_SUM>(0, std::numeric_limits<std::size_t>::max(), mode);
+		}
+		double computeAverageOfLine              (std::size_t line, SummationMode mode = SummationMode::STANDARD)
+		{
+			return averageOfLines<NFPF::ReductionType::SUM>(line, line, mode);
+		}
+		double computeAverageOfLines             (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD)
+		{
+			return averageOfLines<NFPF::ReductionType::SUM>(lowerBound, upperBound, mode);
+		}
+		double computeAverageOfContents          (SummationMode mode = SummationMode::STANDARD)
+		{
+			return averageOfLines<NFPF::ReductionType::SUM>(0, std::numeric_limits<std::size_t>::max(), mode);
+		}
+		double computeAbsoluteAverageOfLine      (std::size_t line, SummationMode mode = SummationMode::STANDARD)
+		{
+			return averageOfLines<NFPF::ReductionType::ABSOLUTE_SUM>(line, line, mode);
+		}
+		double computeAbsoluteAverageOfLines     (std::size_t lowerBound, std::size_t upperBound, SummationMode mode = SummationMode::STANDARD)
+		{
+			return averageOfLines<NFPF::ReductionType::ABSOLUTE_SUM>(lowerBound, upperBound, mode);
+		}
+		double computeAbsoluteAverageOfContents  (SummationMode mode = SummationMode::STANDARD)
+		{
+			return averageOfLines<NFPF::ReductionType::ABSOLUTE_SUM>(0, std::numeric_limits<std::size_t>::max(), mode);
+		}
+		double computeVarianceOfLine             (std::size_t line)
+		{
+			return summariseLines(line, line).getVariance();
+		}
+		double computeVarianceOfLines            (std::size_t lowerBound, std::size_t upperBound)
+		{
+			return summariseLines(lowerBound, upperBound).getVariance();
+		}
+		double computeVarianceOfContents         ()
+		{
+			return summariseLines(0, std::numeric_limits<std::size_t>::max()).getVariance();
+		}
+		double computeStandardDeviationOfLine    (std::size_t line)
+		{
+			return summariseLines(line, line).getStandardDeviation();
+		}
+		double computeStandardDeviationOfLines   (std::size_t lowerBound, std::size_t upperBound)
+		{
+			return summariseLines(lowerBound, upperBound).getStandardDeviation();
+		}
+		double computeStandardDeviationOfContents()
+		{
+			return summariseLines(0, std::numeric_limits<std::size_t>::max()).getStandardDeviation();
+		}
+		double computeMinimumOfLine              (std::size_t line)
+		{
+			return reduceLines<NFPF::ReductionType::MINIMUM>(line, line, SummationMode::STANDARD);
+		}
+		double computeMinimumOfLines             (std::size_t lowerBound, std::size_t upperBound)
+		{
+			return reduceLines<NFPF::ReductionType::MINIMUM>(lowerBound, upperBound, SummationMode::STANDARD);
+		}
+		double computeMinimumOfContents          ()
+		{
+			return reduceLines<NFPF::ReductionType::MINIMUM>(0, std::numeric_limits<std::size_t>::max(), SummationMode::STANDARD);
+		}
+		double computeMaximumOfLine              (std::size_t line)
+		{
+			return reduceLines<NFPF::ReductionType::MAXIMUM>(line, line, SummationMode::STANDARD);
+		}
+		double computeMaximumOfLines             (std::size_t lowerBound, std::size_t upperBound)
+		{
+			return reduceLines<NFPF::ReductionType::MAXIMUM>(lowerBound, upperBound, SummationMode::STANDARD);
+		}
+		double computeMaximumOfContents          ()
+		{
+			return reduceLines<NFPF::ReductionType::MAXIMUM>(0, std::numeric_limits<std::size_t>::max(), SummationMode::STANDARD);
+		}
+		NumericSummary computeSummaryOfLine              (std::size_t line)
+		{
+			return summariseLines(line, line);
+		}
+		NumericSummary computeSummaryOfLines             (std::size_t lowerBound, std::size_t upperBound)
+		{
+			return summariseLines(lowerBound, upperBound);
+		}
+		NumericSummary computeSummaryOfContents          ()
+		{
+			return summariseLines(0, std::numeric_limits<std::size_t>::max());
+		}
+		QuantileSketch computeQuantileSketchOfLines      (std::size_t lowerBound, std::size_t upperBound, std::size_t accuracy = QuantileSketch::defaultAccuracy)
+		{
+			QuantileSketch sketch(accuracy);
+			forEachLineIn(lowerBound, upperBound, [&sketch](const double * first, const double * last)
+			{
+				sketch.add(first, last);
+			});
+			return sketch;
+		}
+		QuantileSketch computeQuantileSketchOfContents   (std::size_t accuracy = QuantileSketch::defaultAccuracy)
+		{
+			return computeQuantileSketchOfLines(0, std::numeric_limits<std::size_t>::max(), accuracy);
+		}
+		NumericHistogram computeHistogramOfLines         (std::size_t lowerBound, std::size_t upperBound, NumericHistogram histogram)
+		{
+			forEachLineIn(lowerBound, upperBound, [&histogram](const double * first, const double * last)
+			{
+				histogram.add(first, last);
+			});
+			return histogram;
+		}
+		NumericHistogram computeHistogramOfContents      (NumericHistogram histogram)
+		{
+			return computeHistogramOfLines(0, std::numeric_limits<std::size_t>::max(), std::move(histogram));
+		}
+	private:
+		template <typename FunctionType>
+		void           forEachLineIn (std::size_t lowerBound, std::size_t upperBound, const FunctionType & function)
+		{
+			// Calls function(first, last) for lines [lowerBound, upperBound] and stops reading after them
+			FWPF::validateBounds(lowerBound, upperBound);
+			std::size_t line = 0;
+			readLines([&](const double * first, const double * last)
+			{
+				if (line >= lowerBound)
+				{
+					function(first, last);
+				}
+				return line++ < upperBound;
+			});
+		}
+		template <NFPF::ReductionType Type>
+		double         reduceLines   (std::size_t lowerBound, std::size_t upperBound, SummationMode mode)
+		{
+			NFPF::StreamingReduction<Type> reduction(0, mode);
+			forEachLineIn(lowerBound, upperBound, [&reduction](const double * first, const double * last)
+			{
+				reduction.push(first, last);
+			});
+			return reduction.finish();
+		}
+		template <NFPF::ReductionType Type>
+		double         averageOfLines(std::size_t lowerBound, std::size_t upperBound, SummationMode mode)
+		{
+			NFPF::StreamingReduction<Type> reduction(0, mode);
+			forEachLineIn(lowerBound, upperBound, [&reduction](const double * first, const double * last)
+			{
+				reduction.push(first, last);
+			});
+			std::size_t count = reduction.size();
+			double sum = reduction.finish();
+			return count ? sum / count : 0;
+		}
+		NumericSummary summariseLines(std::size_t lowerBound, std::size_t upperBound)
+		{
+			NFPF::StreamingSummary summary;
+			forEachLineIn(lowerBound, upperBound, [&summary](const double * first, const double * last)
+			{
+				summary.push(first, last);
+			});
+			return summary.finish();
+		}
+		template <typename FunctionType>
+		void           readLines     (const FunctionType & function)
+		{
+			// The pass itself. Two buffers take turns: while the whole lines of one are parsed and handed to
+			// function(first, last), which returns false to stop, the other is filled by a reader thread,
+			// starting with the unfinished line carried over from the first.
+			std::ifstream file(fileName, std::ios::in | std::ios::binary);
+			if (!file.is_open())
+			{
+				succeeded = false;
+				return;
+			}
+			auto readInto = [&file](char * data, std::size_t size) -> std::size_t
+			{
+				file.read(data, static_cast<std::streamsize>(size));
+				return static_cast<std::size_t>(file.gcount());
+			};
+			std::vector<char> buffers[2] = {std::vector<char>(blockSize), std::vector<char>(blockSize)};
+			std::vector<NFPF::ParsedNumericLines> parsed;
+			std::size_t invalidTokens = 0;
+			std::size_t current = 0;
+			std::size_t end = readInto(buffers[0].data(), blockSize);
+			bool lastBlock = !file;
+			while (true)
+			{
+				std::vector<char> & data = buffers[current];
+				std::size_t parseEnd = end;
+				if (!lastBlock)
+				{
+					while (parseEnd && data[parseEnd - 1] != '\n')
+					{
+						--parseEnd;
+					}
+					if (parseEnd == 0)
+					{
+						// Not even one whole line fits, so make room for more of it
+						data.resize(data.size() * 2);
+						end += readInto(data.data() + end, data.size() - end);
+						lastBlock = !file;
+						continue;
+					}
+				}
+				std::vector<char> & next = buffers[1 - current];
+				std::size_t carried = end - parseEnd;
+				std::future<std::size_t> reading;
+				if (!lastBlock)
+				{
+					next.resize(std::max(next.size(), data.size()));
+					std::copy(data.begin() + parseEnd, data.begin() + end, next.begin());
+					reading = std::async(std::launch::async, readInto, next.data() + carried, next.size() - carried);
+				}
+				bool continuing = NFPF::parseNumericLines(data.data(), parseEnd, lastBlock, executionMode, parsed, invalidTokens, function);
+				if (lastBlock)
+				{
+					break;
+				}
+				end = carried + reading.get(); // Waits for the reader, even when stopping
+				lastBlock = !file;
+				if (!continuing)
+				{
+					break;
+				}
+				current = 1 - current;
+			}
+			succeeded = invalidTokens == 0;
+		}
+	};
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <charconv>
+#include <algorithm>
+#include <iterator>
+
+#include "ParallelFunctions.hpp"
+
+namespace fileFunctions
+{
+	enum class NumericNotation
+	{
+		SHORTEST, // The fewest digits that read back as the same double
+		FIXED, // A fixed number of digits after the decimal point
+		SCIENTIFIC // d.ddde+xx with a fixed number of digits after the decimal point
+	};
+
+	// How NumericFile and CompactNumericFile write values: the notation, the precision used by FIXED and
+	// SCIENTIFIC, and the character written between two values on a line. Values are formatted with
+	// std::to_chars, so the output doesn't depend on the locale or on any stream settings. The precision is
+	// kept within [0, 1074]; no double has more digits than that after the decimal point.
+	class NumericFormat
+	{
+	private:
+		NumericNotation notation;
+		int             precision;
+		char            separator;
+	public:
+		NumericFormat(NumericNotation valueNotation = NumericNotation::SHORTEST, int valuePrecision = 6, char valueSeparator = ' ') : notation(valueNotation), precision(std::clamp(valuePrecision, 0, 1074)), separator(valueSeparator)
+		{
+		}
+		static NumericFormat shortest  (char valueSeparator = ' ')
+		{
+			return NumericFormat(NumericNotation::SHORTEST, 0, valueSeparator);
+		}
+		static NumericFormat fixed     (int valuePrecision, char valueSeparator = ' ')
+		{
+			return NumericFormat(NumericNotation::FIXED, valuePrecision, valueSeparator);
+		}
+		static NumericFormat scientific(int valuePrecision, char valueSeparator = ' ')
+		{
+			return NumericFormat(NumericNotation::SCIENTIFIC, valuePrecision, valueSeparator);
+		}
+		NumericNotation getNotation () const
+		{
+			return notation;
+		}
+		int             getPrecision() const
+		{
+			return precision;
+		}
+		char            getSeparator() const
+		{
+			return separator;
+		}
+		std::size_t     getMaximumLength() const
+		{
+			// Returns the most characters a single value can take: DBL_MAX in fixed notation has 309 digits
+			// before the point, and any notation needs room for the sign, the point and the exponent
+			switch (notation)
+			{
+			case NumericNotation::FIXED:
+				return 320 + static_cast<std::size_t>(precision);
+			case NumericNotation::SCIENTIFIC:
+				return 16 + static_cast<std::size_t>(precision);
+			default:
+				return 32;
+			}
+		}
+		char *          format(char * first, char * last, double value) const
+		{
+			// Writes 'value' to [first, last), which must hold getMaximumLength() characters, and returns the end
+			switch (notation)
+			{
+			case NumericNotation::FIXED:
+				return std::to_chars(first, last, value, std::chars_format::fixed, precision).ptr;
+			case NumericNotation::SCIENTIFIC:
+				return std::to_chars(first, last, value, std::chars_format::scientific, precision).ptr;
+			default:
+				return std::to_chars(first, last, value).ptr;
+			}
+		}
+	};
+
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		const std::size_t outputBufferSize = std::size_t(1) << 20;
+
+		template <typename IteratorType>
+		void appendFormattedValues(std::string & output, IteratorType first, IteratorType last, const NumericFormat & format)
+		{
+			// Appends the values of [first, last) to 'output', separated by the separator of 'format'.
+			// Values are formatted into a local buffer that is appended whenever it's nearly full.
+			char buffer[4096];
+			char * position = buffer;
+			std::size_t length = format.getMaximumLength() + 1;
+			for (IteratorType i = first; i != last; ++i)
+			{
+				if (static_cast<std::size_t>(buffer + sizeof(buffer) - position) < length)
+				{
+					output.append(buffer, position);
+					position = buffer;
+				}
+				if (i != first)
+				{
+					*position++ = format.getSeparator();
+				}
+				position = format.format(position, buffer + sizeof(buffer), *i);
+			}
+			output.append(buffer, position);
+		}
+
+		template <typename RowFunctionType>
+		void writeRows(std::ostream & ostr, std::size_t rowCount, const RowFunctionType & getRow, const NumericFormat & format, sp::ExecutionMode mode)
+		{
+			// Writes rows [0, rowCount) to 'ostr', each followed by '\n'. getRow(i) returns something with begin(),
+			// end() and size(). The rows are formatted into large buffers, a round of consecutive rows at a time; with
+			// mode == PARALLEL each round is split between threads, and the buffers are still written in order.
+			std::vector<std::string> buffers(1);
+			std::size_t row = 0;
+			while (row < rowCount && ostr.good())
+			{
+				std::size_t roundEnd = row;
+				std::size_t values = 0;
+				std::size_t valueLimit = outputBufferSize / 8 * (mode == sp::ExecutionMode::PARALLEL ? sp::getThreadCount() : 1);
+				while (roundEnd < rowCount && values < valueLimit)
+				{
+					values += getRow(roundEnd).size() + 1;
+					++roundEnd;
+				}
+				std::size_t chunkCount = sp::FWPF::getChunkCount(roundEnd - row, mode, 16);
+				if (buffers.size() < chunkCount)
+				{
+					buffers.resize(chunkCount);
+				}
+				sp::FWPF::parallelForChunks(roundEnd - row, chunkCount, [&](std::size_t chunk, std::size_t first, std::size_t last)
+				{
+					std::string & buffer = buffers[chunk];
+					buffer.clear();
+					for (std::size_t i = row + first; i < row + last; ++i)
+					{
+						const auto & current = getRow(i);
+						appendFormattedValues(buffer, current.begin(), current.end(), format);
+						buffer.push_back('\n');
+					}
+				});
+				for (std::size_t i = 0; i < chunkCount; ++i)
+				{
+					ostr.write(buffers[i].data(), static_cast<std::streamsize>(buffers[i].size()));
+				}
+				row = roundEnd;
+			}
+		}
+	}
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <utility>
+#include <cmath>
+
+#include "NumericKernels.hpp"
+
+namespace fileFunctions
+{
+	enum class HistogramBinning
+	{
+		FIXED_WIDTH, // Bins of equal width between two edges
+		EXPLICIT_EDGES, // Bins between given edges
+		LOGARITHMIC // Bins of equal width in log(value) between two positive edges
+	};
+
+	// Counts of values in bins. Bin i holds the values in [edge i, edge i + 1), except that the last bin also
+	// holds the upper edge, as numpy.histogram does. Values below the first edge, above the last one and NaNs
+	// are counted apart rather than dropped. Values are binned in blocks: the bin of every value of a block
+	// is worked out first, with selects rather than branches (fixed and logarithmic bins by scaling, explicit
+	// edges by a binary search of a fixed number of steps), in loops the compiler can vectorise where the
+	// logarithm doesn't get in the way, and then counted. The counts are kept in four interleaved copies,
+	// so that runs of values in the same bin don't wait on each other's increments. Histograms with the same
+	// bins merge by adding their counts, so they can be built on different threads or over different parts
+	// of a file and combined in any order.
+	class NumericHistogram
+	{
+	private:
+		static constexpr std::size_t lanes     = 4; // Interleaved copies of the counts
+		static constexpr std::size_t blockSize = 256;
+
+		HistogramBinning           binning;
+		std::vector<double>        edges;
+		double                     offset; // The first edge, or its log
+		double                     scale; // Bins per unit of value, or of log(value)
+		std::vector<std::uint64_t> counts; // Slot 0 below the bins, slots 1 to getBinCount() the bins, then above and NaN
+	public:
+		static NumericHistogram fixedWidth (double lowerEdge, double upperEdge, std::size_t binCount)
+		{
+			// 'binCount' bins of equal width covering [lowerEdge, upperEdge]
+			if (!(lowerEdge < upperEdge) || binCount == 0 || !std::isfinite(upperEdge - lowerEdge))
+			{
+				throw std::invalid_argument("NumericHistogram::fixedWidth needs finite edges with lowerEdge < upperEdge and at least one bin");
+			}
+			std::vector<double> binEdges(binCount + 1);
+			for (std::size_t i = 0; i <= binCount; ++i)
+			{
+				binEdges[i] = lowerEdge + (upperEdge - lowerEdge) * i / binCount;
+			}
+			binEdges.back() = upperEdge;
+			return NumericHistogram(HistogramBinning::FIXED_WIDTH, std::move(binEdges), lowerEdge, binCount / (upperEdge - lowerEdge));
+		}
+		static NumericHistogram withEdges  (std::vector<double> binEdges)
+		{
+			// Bins between consecutive edges, which must be increasing
+			if (binEdges.size() < 2 || std::adjacent_find(binEdges.begin(), binEdges.end(), [](double lhs, double rhs) { return !(lhs < rhs); }) != binEdges.end())
+			{
+				throw std::invalid_argument("NumericHistogram::withEdges needs at least two strictly increasing edges");
+			}
+			return NumericHistogram(HistogramBinning::EXPLICIT_EDGES, std::move(binEdges), 0, 0);
+		}
+		static NumericHistogram logarithmic(double lowerEdge, double upperEdge, std::size_t binCount)
+		{
+			// 'binCount' bins covering [lowerEdge, upperEdge], each upper edge the same multiple of its lower edge
+			if (!(lowerEdge > 0) || !(lowerEdge < upperEdge) || binCount == 0 || !std::isfinite(upperEdge))
+			{
+				throw std::invalid_argument("NumericHistogram::logarithmic needs finite edges with 0 < lowerEdge < upperEdge and at least one bin");
+			}
+			double logLower = std::log(lowerEdge);
+			double logUpper = std::log(upperEdge);
+			std::vector<double> binEdges(binCount + 1);
+			for (std::size_t i = 0; i <= binCount; ++i)
+			{
+				binEdges[i] = std::exp(logLower + (logUpper - logLower) * i / binCount);
+			}
+			binEdges.front() = lowerEdge;
+			binEdges.back() = upperEdge;
+			return NumericHistogram(HistogramBinning::LOGARITHMIC, std::move(binEdges), logLower, binCount / (logUpper - logLower));
+		}
+		void add(double value)
+		{
+			add(&value, &value + 1);
+		}
+		void add(const double * first, const double * last)
+		{
+			std::uint32_t slots[blockSize];
+			while (first != last)
+			{
+				std::size_t size = std::min(blockSize, static_cast<std::size_t>(last - first));
+				findSlots(first, size, slots);
+				std::uint64_t * count = counts.data();
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					++count[slots[i] * lanes + i % lanes];
+				}
+				first += size;
+			}
+		}
+		template <typename IteratorType>
+		void add(IteratorType first, IteratorType last)
+		{
+			if constexpr (std::is_convertible_v<IteratorType, const double *>)
+			{
+				add(static_cast<const double *>(first), static_cast<const double *>(last));
+			}
+			else
+			{
+				double buffer[blockSize];
+				std::size_t buffered = 0;
+				for (; first != last; ++first)
+				{
+					buffer[buffered++] = static_cast<double>(*first);
+					if (buffered == blockSize)
+					{
+						add(buffer, buffer + buffered);
+						buffered = 0;
+					}
+				}
+				add(buffer, buffer + buffered);
+			}
+		}
+		void merge(const NumericHistogram & rhs)
+		{
+			// Adds the counts of rhs, which must have the same bins
+			if (binning != rhs.binning || edges != rhs.edges)
+			{
+				throw std::invalid_argument("NumericHistogram::merge needs histograms with the same bins");
+			}
+			for (std::size_t i = 0; i < counts.size(); ++i)
+			{
+				counts[i] += rhs.counts[i];
+			}
+		}
+		void clear()
+		{
+			// Zeroes every count, keeping the bins
+			std::fill(counts.begin(), counts.end(), 0);
+		}
+		HistogramBinning            getBinning  () const
+		{
+			return binning;
+		}
+		std::size_t                 getBinCount () const
+		{
+			return edges.size() - 1;
+		}
+		const std::vector<double> & getEdges    () const
+		{
+			// The getBinCount() + 1 edges of the bins
+			return edges;
+		}
+		std::uint64_t               getCount    (std::size_t bin) const
+		{
+			// Returns the number of values in a bin, or 0 if it doesn't exist
+			return bin < getBinCount() ? slotCount(bin + 1) : 0;
+		}
+		std::vector<std::uint64_t>  getCounts   () const
+		{
+			// Returns the number of values in each bin
+			std::vector<std::uint64_t> binCounts(getBinCount());
+			for (std::size_t i = 0; i < binCounts.size(); ++i)
+			{
+				binCounts[i] = slotCount(i + 1);
+			}
+			return binCounts;
+		}
+		std::uint64_t               getUnderflow() const
+		{
+			// The number of values below the first edge
+			return slotCount(0);
+		}
+		std::uint64_t               getOverflow () const
+		{
+			// The number of values above the last edge
+			return slotCount(getBinCount() + 1);
+		}
+		std::uint64_t               getNaNCount () const
+		{
+			return slotCount(getBinCount() + 2);
+		}
+		std::uint64_t               getTotal    () const
+		{
+			// The number of values added, wherever they were counted
+			std::uint64_t total = 0;
+			for (std::uint64_t i : counts)
+			{
+				total += i;
+			}
+			return total;
+		}
+	private:
+		NumericHistogram(HistogramBinning binType, std::vector<double> binEdges, double binOffset, double binScale) : binning(binType), edges(std::move(binEdges)), offset(binOffset), scale(binScale), counts((edges.size() + 2) * lanes, 0)
+		{
+		}
+		std::uint64_t slotCount(std::size_t slot) const
+		{
+			std::uint64_t total = 0;
+			for (std::size_t i = 0; i < lanes; ++i)
+			{
+				total += counts[slot * lanes + i];
+			}
+			return total;
+		}
+		void findSlots(const double * values, std::size_t size, std::uint32_t * slots) const
+		{
+			// Works out the slot of every value. A bin found by scaling is clamped to the bins and then checked
+			// against its edges, since rounding can put a value next to an edge one bin out, so both ways of
+			// binning agree with the edges exactly. The selects at the end take care of the values outside the
+			// bins, the upper edge and NaNs.
+			const std::uint32_t binCount = static_cast<std::uint32_t>(getBinCount());
+			const double lowerEdge = edges.front();
+			const double upperEdge = edges.back();
+			const double lastBin = binCount - 1;
+			switch (binning)
+			{
+			case HistogramBinning::FIXED_WIDTH:
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					double position = (values[i] - offset) * scale;
+					position = position > 0 ? position : 0; // Also turns NaN into 0
+					position = position < lastBin ? position : lastBin;
+					slots[i] = static_cast<std::uint32_t>(position);
+				}
+				correctBins(values, size, slots);
+				break;
+			case HistogramBinning::LOGARITHMIC:
+				for (std::size_t i = 0; i < size; ++i)
+				{
+					double x = values[i];
+					double position = (std::log(x > 0 ? x : lowerEdge) - offset) * scale;
+					position = position > 0 ? position : 0;
+					position = position < lastBin ? position : lastBin;
+					slots[i] = static_cast<std::uint32_t>(position);
+				}
+				correctBins(values, size, slots);
+				break;
+			default:
+				{
+					// Finds the last edge no greater than each value, halving the edges left to search at every step.
+					// Every value takes the same steps, so each step is a loop over the block.
+					const double * edge = edges.data();
+					std::fill(slots, slots + size, 0);
+					for (std::size_t remaining = edges.size(); remaining > 1; remaining -= remaining / 2)
+					{
+						std::uint32_t half = static_cast<std::uint32_t>(remaining / 2);
+						for (std::size_t i = 0; i < size; ++i)
+						{
+							slots[i] = edge[slots[i] + half] <= values[i] ? slots[i] + half : slots[i];
+						}
+					}
+					for (std::size_t i = 0; i < size; ++i)
+					{
+						slots[i] = selectSlot(values[i], slots[i] + 1, lowerEdge, upperEdge, binCount);
+					}
+				}
+				break;
+			}
+		}
+		void correctBins(const double * values, std::size_t size, std::uint32_t * slots) const
+		{
+			// Moves each bin found by scaling one down if its value is below the bin's lower edge, or one up if
+			// the value has reached its upper edge, without leaving the bins, then turns the bins into slots
+			const double * edge = edges.data();
+			const std::uint32_t binCount = static_cast<std::uint32_t>(getBinCount());
+			const double lowerEdge = edges.front();
+			const double upperEdge = edges.back();
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				double x = values[i];
+				std::uint32_t bin = slots[i];
+				double binLower = edge[bin];
+				double binUpper = edge[bin + 1];
+				bin = x < binLower && bin > 0 ? bin - 1 : bin;
+				bin = x >= binUpper && bin + 1 < binCount ? bin + 1 : bin;
+				slots[i] = selectSlot(x, bin + 1, lowerEdge, upperEdge, binCount);
+			}
+		}
+		static std::uint32_t selectSlot(double x, std::uint32_t slot, double lowerEdge, double upperEdge, std::uint32_t binCount)
+		{
+			slot = slot > binCount ? binCount : slot; // The upper edge itself belongs to the last bin
+			slot = x < lowerEdge ? 0 : slot;
+			slot = x > upperEdge ? binCount + 1 : slot;
+			return x != x ? binCount + 2 : slot;
+		}
+	};
+
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		template <typename RangeIteratorType>
+		NumericHistogram histogramOfRanges(RangeIteratorType first, RangeIteratorType last, NumericHistogram histogram, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL)
+		{
+			// Adds the values of the ranges to 'histogram'. With execution == PARALLEL every thread fills its own
+			// copy from a share of the blocks the other reductions use, and the copies are merged at the end.
+			std::vector<std::size_t> offsets = getRangeOffsets(first, last);
+			std::size_t blockCount = (offsets.back() + reductionBlockSize - 1) / reductionBlockSize;
+			std::size_t chunkCount = sp::FWPF::getChunkCount(blockCount, execution, 1);
+			NumericHistogram empty = histogram;
+			empty.clear();
+			std::vector<NumericHistogram> partials(chunkCount, empty);
+			sp::FWPF::parallelForChunks(blockCount, chunkCount, [&](std::size_t chunk, std::size_t firstBlock, std::size_t lastBlock)
+			{
+				NumericHistogram & partial = partials[chunk];
+				for (std::size_t block = firstBlock; block < lastBlock; ++block)
+				{
+					forEachSegmentOfBlock(first, offsets, block, [&partial](auto segmentFirst, auto segmentLast)
+					{
+						partial.add(segmentFirst, segmentLast);
+					});
+				}
+			});
+			for (const NumericHistogram & partial : partials)
+			{
+				histogram.merge(partial);
+			}
+			return histogram;
+		}
+	}
+}
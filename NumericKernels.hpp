@@ -0,0 +1,614 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "ParallelFunctions.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SP_NUMERIC_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace fileFunctions
+{
+	enum class SummationMode
+	{
+		STANDARD, // Eight independent partial sums, added together in a fixed order at the end
+		COMPENSATED // The same, with Kahan compensation in each partial sum, for data whose magnitudes vary widely
+	};
+
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		// Reductions over runs of doubles. Value i always goes to lane i % 8, and the eight lanes are combined
+		// in a fixed order, so a result only depends on the values and their order: the scalar, AVX2 and
+		// AVX-512 versions, picked at runtime from what the processor supports, all return the same bits.
+		// (This assumes the compiler isn't allowed to reassociate or contract floating-point operations,
+		// as with -ffast-math.)
+		enum class KernelLevel
+		{
+			SCALAR,
+			AVX2,
+			AVX512
+		};
+
+		enum class ReductionType
+		{
+			SUM, // sum(x)
+			ABSOLUTE_SUM, // sum(|x|)
+			SQUARED_DEVIATION, // sum((x - parameter)^2)
+			MINIMUM,
+			MAXIMUM
+		};
+
+		const std::size_t laneCount = 8;
+
+		inline KernelLevel getSupportedKernelLevel()
+		{
+			// Returns the widest kernels the processor can run
+#ifdef SP_NUMERIC_DISPATCH
+			static const KernelLevel level = []()
+			{
+				__builtin_cpu_init();
+				if (__builtin_cpu_supports("avx512f"))
+				{
+					return KernelLevel::AVX512;
+				}
+				if (__builtin_cpu_supports("avx2"))
+				{
+					return KernelLevel::AVX2;
+				}
+				return KernelLevel::SCALAR;
+			}();
+			return level;
+#else
+			return KernelLevel::SCALAR;
+#endif
+		}
+
+		inline std::atomic<int> & kernelLevelLimit()
+		{
+			// The widest kernels that may be used, as set by setKernelLevel
+			static std::atomic<int> limit(static_cast<int>(KernelLevel::AVX512));
+			return limit;
+		}
+
+		inline void setKernelLevel(KernelLevel level)
+		{
+			// Limits the kernels used to 'level' (e.g. to compare the paths); levels the processor lacks are never used
+			kernelLevelLimit() = static_cast<int>(level);
+		}
+
+		inline KernelLevel getKernelLevel()
+		{
+			// Returns the kernels in use
+			return static_cast<KernelLevel>(std::min(static_cast<int>(getSupportedKernelLevel()), kernelLevelLimit().load()));
+		}
+
+		struct LaneState
+		{
+			alignas(64) double value[laneCount];
+			alignas(64) double compensation[laneCount];
+		};
+
+		template <ReductionType Type>
+		double reductionIdentity()
+		{
+			if constexpr (Type == ReductionType::MINIMUM)
+			{
+				return std::numeric_limits<double>::infinity();
+			}
+			else if constexpr (Type == ReductionType::MAXIMUM)
+			{
+				return -std::numeric_limits<double>::infinity();
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
+		template <ReductionType Type>
+		void scalarKernel(LaneState & state, const double * data, std::size_t count, double parameter, bool compensated)
+		{
+			// Handles any count. Must start at lane 0, which every caller guarantees.
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				std::size_t lane = i % laneCount;
+				double x = data[i];
+				if constexpr (Type == ReductionType::MINIMUM)
+				{
+					state.value[lane] = x < state.value[lane] ? x : state.value[lane];
+					continue;
+				}
+				else if constexpr (Type == ReductionType::MAXIMUM)
+				{
+					state.value[lane] = x > state.value[lane] ? x : state.value[lane];
+					continue;
+				}
+				else if constexpr (Type == ReductionType::ABSOLUTE_SUM)
+				{
+					x = std::fabs(x);
+				}
+				else if constexpr (Type == ReductionType::SQUARED_DEVIATION)
+				{
+					double deviation = x - parameter;
+					x = deviation * deviation;
+				}
+				if (compensated)
+				{
+					double y = x - state.compensation[lane];
+					double t = state.value[lane] + y;
+					double lost = t - state.value[lane];
+					state.compensation[lane] = lost - y;
+					state.value[lane] = t;
+				}
+				else
+				{
+					state.value[lane] += x;
+				}
+			}
+		}
+
+#ifdef SP_NUMERIC_DISPATCH
+		template <ReductionType Type>
+		__attribute__((target("avx2"))) inline void avx2Step(__m256d x, __m256d & value, __m256d & compensation, __m256d center, bool compensated)
+		{
+			// Adds four values to four lanes
+			if constexpr (Type == ReductionType::MINIMUM)
+			{
+				value = _mm256_min_pd(x, value);
+				return;
+			}
+			else if constexpr (Type == ReductionType::MAXIMUM)
+			{
+				value = _mm256_max_pd(x, value);
+				return;
+			}
+			else if constexpr (Type == ReductionType::ABSOLUTE_SUM)
+			{
+				x = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+			}
+			else if constexpr (Type == ReductionType::SQUARED_DEVIATION)
+			{
+				__m256d deviation = _mm256_sub_pd(x, center);
+				x = _mm256_mul_pd(deviation, deviation);
+			}
+			if (compensated)
+			{
+				__m256d y = _mm256_sub_pd(x, compensation);
+				__m256d t = _mm256_add_pd(value, y);
+				compensation = _mm256_sub_pd(_mm256_sub_pd(t, value), y);
+				value = t;
+			}
+			else
+			{
+				value = _mm256_add_pd(value, x);
+			}
+		}
+
+		template <ReductionType Type>
+		__attribute__((target("avx2"))) void avx2Kernel(LaneState & state, const double * data, std::size_t count, double parameter, bool compensated)
+		{
+			// Lanes 0-3 and 4-7 each live in one register
+			__m256d value0 = _mm256_load_pd(state.value);
+			__m256d value1 = _mm256_load_pd(state.value + 4);
+			__m256d compensation0 = _mm256_load_pd(state.compensation);
+			__m256d compensation1 = _mm256_load_pd(state.compensation + 4);
+			const __m256d center = _mm256_set1_pd(parameter);
+			std::size_t whole = count - count % laneCount;
+			for (std::size_t i = 0; i < whole; i += laneCount)
+			{
+				avx2Step<Type>(_mm256_loadu_pd(data + i), value0, compensation0, center, compensated);
+				avx2Step<Type>(_mm256_loadu_pd(data + i + 4), value1, compensation1, center, compensated);
+			}
+			_mm256_store_pd(state.value, value0);
+			_mm256_store_pd(state.value + 4, value1);
+			_mm256_store_pd(state.compensation, compensation0);
+			_mm256_store_pd(state.compensation + 4, compensation1);
+			scalarKernel<Type>(state, data + whole, count - whole, parameter, compensated);
+		}
+
+		template <ReductionType Type>
+		__attribute__((target("avx512f"))) void avx512Kernel(LaneState & state, const double * data, std::size_t count, double parameter, bool compensated)
+		{
+			// All eight lanes live in one register
+			__m512d value = _mm512_load_pd(state.value);
+			__m512d compensation = _mm512_load_pd(state.compensation);
+			const __m512d center = _mm512_set1_pd(parameter);
+			std::size_t whole = count - count % laneCount;
+			for (std::size_t i = 0; i < whole; i += laneCount)
+			{
+				__m512d x = _mm512_loadu_pd(data + i);
+				if constexpr (Type == ReductionType::MINIMUM)
+				{
+					value = _mm512_mask_min_pd(value, 0xFF, x, value); // The masked form avoids GCC's warning about _mm512_undefined_pd
+					continue;
+				}
+				else if constexpr (Type == ReductionType::MAXIMUM)
+				{
+					value = _mm512_mask_max_pd(value, 0xFF, x, value);
+					continue;
+				}
+				else if constexpr (Type == ReductionType::ABSOLUTE_SUM)
+				{
+					x = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFF)));
+				}
+				else if constexpr (Type == ReductionType::SQUARED_DEVIATION)
+				{
+					__m512d deviation = _mm512_sub_pd(x, center);
+					x = _mm512_mul_pd(deviation, deviation);
+				}
+				if (compensated)
+				{
+					__m512d y = _mm512_sub_pd(x, compensation);
+					__m512d t = _mm512_add_pd(value, y);
+					compensation = _mm512_sub_pd(_mm512_sub_pd(t, value), y);
+					value = t;
+				}
+				else
+				{
+					value = _mm512_add_pd(value, x);
+				}
+			}
+			_mm512_store_pd(state.value, value);
+			_mm512_store_pd(state.compensation, compensation);
+			scalarKernel<Type>(state, data + whole, count - whole, parameter, compensated);
+		}
+#endif
+
+		template <ReductionType Type>
+		void runKernel(LaneState & state, const double * data, std::size_t count, double parameter, bool compensated)
+		{
+#ifdef SP_NUMERIC_DISPATCH
+			switch (getKernelLevel())
+			{
+			case KernelLevel::AVX512:
+				avx512Kernel<Type>(state, data, count, parameter, compensated);
+				return;
+			case KernelLevel::AVX2:
+				avx2Kernel<Type>(state, data, count, parameter, compensated);
+				return;
+			default:
+				break;
+			}
+#endif
+			scalarKernel<Type>(state, data, count, parameter, compensated);
+		}
+
+		template <ReductionType Type>
+		class Reducer
+		{
+			// Feeds values to the kernels in lane order. Contiguous runs go straight to the kernels, anything
+			// else (deque iterators, single values) is gathered into a small buffer first. Everything handed to
+			// a kernel before finish() is a whole number of lane groups, so every value lands in lane i % 8.
+		private:
+			static const std::size_t bufferSize = 256;
+
+			LaneState   state;
+			double      buffer[bufferSize];
+			std::size_t buffered;
+			std::size_t count;
+			double      parameter;
+			bool        compensated;
+		public:
+			explicit Reducer(double reductionParameter = 0, SummationMode mode = SummationMode::STANDARD) : buffered(0), count(0), parameter(reductionParameter), compensated(mode == SummationMode::COMPENSATED)
+			{
+				for (std::size_t i = 0; i < laneCount; ++i)
+				{
+					state.value[i] = reductionIdentity<Type>();
+					state.compensation[i] = 0;
+				}
+			}
+			void push(double value)
+			{
+				buffer[buffered++] = value;
+				++count;
+				if (buffered == bufferSize)
+				{
+					flush();
+				}
+			}
+			void push(const double * first, const double * last)
+			{
+				std::size_t size = static_cast<std::size_t>(last - first);
+				count += size;
+				while (buffered && first != last)
+				{
+					buffer[buffered++] = *first++;
+					if (buffered == bufferSize)
+					{
+						flush();
+					}
+				}
+				std::size_t whole = static_cast<std::size_t>(last - first) - static_cast<std::size_t>(last - first) % laneCount;
+				if (whole)
+				{
+					runKernel<Type>(state, first, whole, parameter, compensated);
+					first += whole;
+				}
+				for (; first != last; ++first)
+				{
+					buffer[buffered++] = *first;
+				}
+			}
+			template <typename IteratorType>
+			void push(IteratorType first, IteratorType last)
+			{
+				if constexpr (std::is_convertible_v<IteratorType, const double *>)
+				{
+					push(static_cast<const double *>(first), static_cast<const double *>(last));
+				}
+				else
+				{
+					for (; first != last; ++first)
+					{
+						push(static_cast<double>(*first));
+					}
+				}
+			}
+			std::size_t size() const
+			{
+				// Returns the number of values pushed so far
+				return count;
+			}
+			double finish()
+			{
+				// Returns the combined result. Sums of nothing are 0; so are the minimum and maximum of nothing.
+				if (buffered)
+				{
+					runKernel<Type>(state, buffer, buffered, parameter, compensated);
+					buffered = 0;
+				}
+				if (count == 0)
+				{
+					return 0;
+				}
+				if constexpr (Type == ReductionType::MINIMUM || Type == ReductionType::MAXIMUM)
+				{
+					double result = state.value[0];
+					for (std::size_t i = 1; i < laneCount; ++i)
+					{
+						double x = state.value[i];
+						result = (Type == ReductionType::MINIMUM ? x < result : x > result) ? x : result;
+					}
+					return result;
+				}
+				else if (compensated)
+				{
+					double sum = 0;
+					double compensation = 0;
+					for (std::size_t i = 0; i < laneCount; ++i)
+					{
+						double y = (state.value[i] - state.compensation[i]) - compensation;
+						double t = sum + y;
+						compensation = (t - sum) - y;
+						sum = t;
+					}
+					return sum;
+				}
+				else
+				{
+					const double * v = state.value;
+					return ((v[0] + v[1]) + (v[2] + v[3])) + ((v[4] + v[5]) + (v[6] + v[7]));
+				}
+			}
+		private:
+			void flush()
+			{
+				runKernel<Type>(state, buffer, buffered, parameter, compensated);
+				buffered = 0;
+			}
+		};
+
+		// Reductions over a sequence of ranges (lines). The values are cut into fixed blocks of
+		// reductionBlockSize values, counted across line boundaries; each block is reduced on its own and
+		// the block results are combined in a fixed binary tree. The blocks only depend on the values, so
+		// the result is the same bits whether the blocks run on one thread or on many, and however many.
+		const std::size_t reductionBlockSize = std::size_t(1) << 16;
+
+		template <typename RangeIteratorType>
+		std::vector<std::size_t> getRangeOffsets(RangeIteratorType first, RangeIteratorType last)
+		{
+			// Returns the index of the first value of every range, followed by the total number of values
+			std::vector<std::size_t> offsets(1, 0);
+			for (; first != last; ++first)
+			{
+				offsets.push_back(offsets.back() + static_cast<std::size_t>(std::distance(std::begin(*first), std::end(*first))));
+			}
+			return offsets;
+		}
+
+		template <typename RangeIteratorType, typename SegmentFunctionType>
+		void forEachSegmentOfBlock(RangeIteratorType first, const std::vector<std::size_t> & offsets, std::size_t block, const SegmentFunctionType & function)
+		{
+			// Calls function(begin, end) for each piece of a line that falls within the block, in order
+			std::size_t position = block * reductionBlockSize;
+			std::size_t end = std::min(position + reductionBlockSize, offsets.back());
+			std::size_t range = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), position) - offsets.begin()) - 1;
+			while (position < end)
+			{
+				auto line = std::next(first, range);
+				std::size_t segmentEnd = std::min(end, offsets[range + 1]);
+				if (segmentEnd > position)
+				{
+					function(std::next(std::begin(*line), position - offsets[range]), std::next(std::begin(*line), segmentEnd - offsets[range]));
+					position = segmentEnd;
+				}
+				++range;
+			}
+		}
+
+		template <typename ResultType, typename CombineFunctionType>
+		ResultType combineBlocks(const std::vector<ResultType> & results, std::size_t first, std::size_t last, const CombineFunctionType & combine)
+		{
+			// Combines results [first, last) in a fixed tree: the two halves first, then each other
+			if (last - first == 1)
+			{
+				return results[first];
+			}
+			std::size_t middle = first + (last - first) / 2;
+			return combine(combineBlocks(results, first, middle, combine), combineBlocks(results, middle, last, combine));
+		}
+
+		template <typename ResultType, typename RangeIteratorType, typename BlockFunctionType, typename CombineFunctionType>
+		ResultType reduceBlocks(RangeIteratorType first, RangeIteratorType last, sp::ExecutionMode execution, const BlockFunctionType & reduceBlock, const CombineFunctionType & combine)
+		{
+			// reduceBlock(forEachSegment) returns the result of a block, calling forEachSegment(function)
+			// to have function(begin, end) called for each of its pieces
+			std::vector<std::size_t> offsets = getRangeOffsets(first, last);
+			std::size_t blockCount = std::max<std::size_t>(1, (offsets.back() + reductionBlockSize - 1) / reductionBlockSize);
+			std::vector<ResultType> results(blockCount);
+			sp::FWPF::parallelForChunks(blockCount, sp::FWPF::getChunkCount(blockCount, execution, 1), [&](std::size_t, std::size_t firstBlock, std::size_t lastBlock)
+			{
+				for (std::size_t block = firstBlock; block < lastBlock; ++block)
+				{
+					results[block] = reduceBlock([&](const auto & function)
+					{
+						forEachSegmentOfBlock(first, offsets, block, function);
+					});
+				}
+			});
+			return combineBlocks(results, 0, blockCount, combine);
+		}
+
+		struct PartialReduction
+		{
+			double      value = 0;
+			std::size_t count = 0;
+		};
+
+		template <ReductionType Type>
+		PartialReduction combinePartialReductions(const PartialReduction & lhs, const PartialReduction & rhs)
+		{
+			if (lhs.count == 0 || rhs.count == 0)
+			{
+				return lhs.count ? lhs : rhs;
+			}
+			PartialReduction combined;
+			combined.count = lhs.count + rhs.count;
+			if constexpr (Type == ReductionType::MINIMUM)
+			{
+				combined.value = rhs.value < lhs.value ? rhs.value : lhs.value;
+			}
+			else if constexpr (Type == ReductionType::MAXIMUM)
+			{
+				combined.value = rhs.value > lhs.value ? rhs.value : lhs.value;
+			}
+			else
+			{
+				combined.value = lhs.value + rhs.value;
+			}
+			return combined;
+		}
+
+		template <ReductionType Type, typename RangeIteratorType>
+		double reduceRanges(RangeIteratorType first, RangeIteratorType last, double parameter = 0, SummationMode summation = SummationMode::STANDARD, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL, std::size_t * count = nullptr)
+		{
+			// Reduces the values of every range (line) in [first, last) as one sequence
+			PartialReduction result = reduceBlocks<PartialReduction>(first, last, execution, [parameter, summation](const auto & forEachSegment)
+			{
+				Reducer<Type> reducer(parameter, summation);
+				forEachSegment([&reducer](auto segmentFirst, auto segmentLast)
+				{
+					reducer.push(segmentFirst, segmentLast);
+				});
+				PartialReduction partial;
+				partial.count = reducer.size();
+				partial.value = reducer.finish();
+				return partial;
+			}, combinePartialReductions<Type>);
+			if (count)
+			{
+				*count = result.count;
+			}
+			return result.value;
+		}
+
+		template <ReductionType Type>
+		class StreamingReduction
+		{
+			// The same reduction as reduceRanges, for values that arrive a run at a time and are never all in
+			// memory: runs are cut into the same fixed blocks, and only one result per block is kept, so the
+			// result has the same bits as reduceRanges over the same values.
+		private:
+			Reducer<Type>                 reducer;
+			std::vector<PartialReduction> blocks;
+			double                        parameter;
+			SummationMode                 summation;
+		public:
+			explicit StreamingReduction(double reductionParameter = 0, SummationMode mode = SummationMode::STANDARD) : reducer(reductionParameter, mode), parameter(reductionParameter), summation(mode)
+			{
+			}
+			void push(const double * first, const double * last)
+			{
+				while (first != last)
+				{
+					std::size_t room = reductionBlockSize - reducer.size();
+					std::size_t taken = std::min(room, static_cast<std::size_t>(last - first));
+					reducer.push(first, first + taken);
+					first += taken;
+					if (reducer.size() == reductionBlockSize)
+					{
+						finishBlock();
+					}
+				}
+			}
+			std::size_t size() const
+			{
+				// Returns the number of values pushed so far
+				return blocks.size() * reductionBlockSize + reducer.size();
+			}
+			double finish()
+			{
+				// Returns the combined result. Nothing more should be pushed afterwards.
+				if (reducer.size() || blocks.empty())
+				{
+					finishBlock();
+				}
+				return combineBlocks(blocks, 0, blocks.size(), combinePartialReductions<Type>).value;
+			}
+		private:
+			void finishBlock()
+			{
+				PartialReduction partial;
+				partial.count = reducer.size();
+				partial.value = reducer.finish();
+				blocks.push_back(partial);
+				reducer = Reducer<Type>(parameter, summation);
+			}
+		};
+
+		template <typename RangeIteratorType>
+		double averageOfRanges(RangeIteratorType first, RangeIteratorType last, SummationMode summation = SummationMode::STANDARD, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL)
+		{
+			std::size_t count = 0;
+			double sum = reduceRanges<ReductionType::SUM>(first, last, 0, summation, execution, &count);
+			return count ? sum / count : 0;
+		}
+
+		template <typename RangeIteratorType>
+		double absoluteAverageOfRanges(RangeIteratorType first, RangeIteratorType last, SummationMode summation = SummationMode::STANDARD, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL)
+		{
+			std::size_t count = 0;
+			double sum = reduceRanges<ReductionType::ABSOLUTE_SUM>(first, last, 0, summation, execution, &count);
+			return count ? sum / count : 0;
+		}
+
+		template <typename RangeIteratorType>
+		double varianceOfRanges(RangeIteratorType first, RangeIteratorType last, SummationMode summation = SummationMode::STANDARD, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL)
+		{
+			// Population variance, in two passes: the mean, then the squared deviations from it
+			std::size_t count = 0;
+			double mean = averageOfRanges(first, last, summation, execution);
+			double sumOfSquares = reduceRanges<ReductionType::SQUARED_DEVIATION>(first, last, mean, summation, execution, &count);
+			return count ? sumOfSquares / count : 0;
+		}
+	}
+}
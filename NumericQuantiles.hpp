@@ -0,0 +1,325 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cmath>
+
+#include "NumericKernels.hpp"
+
+namespace fileFunctions
+{
+	// An approximate summary of the distribution of a set of values in bounded memory: a KLL sketch
+	// (Karnin, Lang and Liberty). Values are kept in levels, each value of level h standing for 2^h of the
+	// values added. When a level fills up it's sorted and every other value of it, starting from the first
+	// or the second at random, moves up a level, so the sketch never holds more than about 3 * accuracy
+	// values however many are added. The rank of any value is then off by about 1.7 / accuracy of the count
+	// at most, with high probability (about 1% with the default accuracy of 200). Sketches of different
+	// values, built on different threads or over different parts of a stream, merge into the sketch of
+	// all of them. The random choices come from a generator with a fixed seed, so the same values added
+	// and merged in the same order always give the same sketch. NaNs are ignored.
+	class QuantileSketch
+	{
+	public:
+		static constexpr std::size_t defaultAccuracy = 200;
+	private:
+		static constexpr std::size_t minimumCapacity = 8; // No level holds fewer values than this before it's compacted
+
+		std::vector<std::vector<double>> levels;
+		std::vector<std::size_t>         capacities; // Of each level, worked out again only when the levels change
+		std::size_t                      accuracy;
+		std::size_t                      count;
+		std::size_t                      retained;
+		std::size_t                      maximumRetained; // The sum of the capacities
+		double                           minimum;
+		double                           maximum;
+		std::uint64_t                    randomState;
+	public:
+		explicit QuantileSketch(std::size_t sketchAccuracy = defaultAccuracy) : levels(1), accuracy(std::max(sketchAccuracy, minimumCapacity)), count(0), retained(0), maximumRetained(0), minimum(std::numeric_limits<double>::infinity()), maximum(-std::numeric_limits<double>::infinity()), randomState(0x9E3779B97F4A7C15)
+		{
+			updateCapacities();
+		}
+		void add(double value)
+		{
+			add(&value, &value + 1);
+		}
+		void add(const double * first, const double * last)
+		{
+			// Adds as many values to level 0 as the sketch has room for, then compacts, and so on
+			while (first != last)
+			{
+				std::vector<double> & bottom = levels.front();
+				std::size_t room = std::max<std::size_t>(maximumRetained > retained ? maximumRetained - retained : 0, 1);
+				const double * end = first + std::min(room, static_cast<std::size_t>(last - first));
+				std::size_t previousSize = bottom.size();
+				for (; first != end; ++first)
+				{
+					if (!std::isnan(*first))
+					{
+						bottom.push_back(*first);
+						minimum = *first < minimum ? *first : minimum;
+						maximum = *first > maximum ? *first : maximum;
+					}
+				}
+				count += bottom.size() - previousSize;
+				retained += bottom.size() - previousSize;
+				compress();
+			}
+		}
+		template <typename IteratorType>
+		void add(IteratorType first, IteratorType last)
+		{
+			if constexpr (std::is_convertible_v<IteratorType, const double *>)
+			{
+				add(static_cast<const double *>(first), static_cast<const double *>(last));
+			}
+			else
+			{
+				double buffer[256];
+				std::size_t buffered = 0;
+				for (; first != last; ++first)
+				{
+					buffer[buffered++] = static_cast<double>(*first);
+					if (buffered == 256)
+					{
+						add(buffer, buffer + buffered);
+						buffered = 0;
+					}
+				}
+				add(buffer, buffer + buffered);
+			}
+		}
+		void merge(const QuantileSketch & rhs)
+		{
+			// Makes this the sketch of its own values and those of rhs. If their accuracies differ, the result
+			// has the lower one, since that's all the values of the less accurate sketch are good for.
+			if (&rhs == this)
+			{
+				QuantileSketch copy(rhs);
+				merge(copy);
+				return;
+			}
+			if (rhs.levels.size() > levels.size() || rhs.accuracy < accuracy)
+			{
+				levels.resize(std::max(levels.size(), rhs.levels.size()));
+				accuracy = std::min(accuracy, rhs.accuracy);
+				updateCapacities();
+			}
+			for (std::size_t i = 0; i < rhs.levels.size(); ++i)
+			{
+				levels[i].insert(levels[i].end(), rhs.levels[i].begin(), rhs.levels[i].end());
+			}
+			count += rhs.count;
+			retained += rhs.retained;
+			minimum = std::min(minimum, rhs.minimum);
+			maximum = std::max(maximum, rhs.maximum);
+			compress();
+		}
+		std::size_t getCount   () const
+		{
+			// The number of values added, NaNs aside
+			return count;
+		}
+		std::size_t getAccuracy() const
+		{
+			return accuracy;
+		}
+		// Everything computed over no values is 0, as with the compute functions of NumericFile
+		double      getMinimum () const
+		{
+			// Exact, as is the maximum
+			return count ? minimum : 0;
+		}
+		double      getMaximum () const
+		{
+			return count ? maximum : 0;
+		}
+		double      getQuantile(double quantile) const
+		{
+			// Returns a value whose rank among the values added is about quantile * getCount(), for a quantile in [0, 1]
+			return getQuantiles(std::vector<double>(1, quantile)).front();
+		}
+		double      getMedian  () const
+		{
+			return getQuantile(0.5);
+		}
+		std::vector<double> getQuantiles(const std::vector<double> & quantiles) const
+		{
+			// Returns getQuantile for each of 'quantiles', sorting the sketch once
+			std::vector<std::pair<double, std::size_t>> items = getWeightedItems();
+			std::vector<double> result(quantiles.size(), 0);
+			for (std::size_t i = 0; i < quantiles.size() && count; ++i)
+			{
+				double quantile = quantiles[i] > 0 ? std::min(quantiles[i], 1.0) : 0.0;
+				if (quantile == 0 || quantile == 1)
+				{
+					result[i] = quantile == 0 ? minimum : maximum;
+					continue;
+				}
+				double rank = quantile * count;
+				std::size_t cumulative = 0;
+				result[i] = items.back().first;
+				for (const std::pair<double, std::size_t> & item : items)
+				{
+					cumulative += item.second;
+					if (cumulative >= rank)
+					{
+						result[i] = item.first;
+						break;
+					}
+				}
+			}
+			return result;
+		}
+		double      getRank    (double value) const
+		{
+			// Returns the approximate fraction of the values added that are no greater than 'value'
+			if (count == 0)
+			{
+				return 0;
+			}
+			std::size_t weight = 0;
+			for (std::size_t i = 0; i < levels.size(); ++i)
+			{
+				for (double item : levels[i])
+				{
+					weight += item <= value ? std::size_t(1) << i : 0;
+				}
+			}
+			return static_cast<double>(weight) / count;
+		}
+	private:
+		void updateCapacities()
+		{
+			// The top level holds 'accuracy' values, and each level below it two thirds as many as the one above
+			capacities.resize(levels.size());
+			maximumRetained = 0;
+			for (std::size_t i = 0; i < levels.size(); ++i)
+			{
+				double scale = std::pow(2.0 / 3.0, static_cast<double>(levels.size() - 1 - i));
+				capacities[i] = std::max(minimumCapacity, static_cast<std::size_t>(std::ceil(accuracy * scale)));
+				maximumRetained += capacities[i];
+			}
+		}
+		bool randomBit()
+		{
+			// xorshift64
+			randomState ^= randomState << 13;
+			randomState ^= randomState >> 7;
+			randomState ^= randomState << 17;
+			return randomState & 1;
+		}
+		void compress()
+		{
+			// Compacts the lowest full level until the sketch is within its size again. While it's too big,
+			// some level is at its capacity or above it.
+			while (retained > maximumRetained)
+			{
+				for (std::size_t i = 0; i < levels.size(); ++i)
+				{
+					if (levels[i].size() >= capacities[i])
+					{
+						compact(i);
+						break;
+					}
+				}
+			}
+		}
+		void compact(std::size_t level)
+		{
+			// Halves a level into the one above, keeping its smallest value behind if it has an odd number
+			if (level + 1 == levels.size())
+			{
+				levels.emplace_back();
+				updateCapacities();
+			}
+			std::vector<double> & items = levels[level];
+			std::vector<double> & above = levels[level + 1];
+			std::sort(items.begin(), items.end());
+			std::size_t kept = items.size() % 2;
+			for (std::size_t i = kept + (randomBit() ? 1 : 0); i < items.size(); i += 2)
+			{
+				above.push_back(items[i]);
+			}
+			retained -= (items.size() - kept) / 2;
+			items.resize(kept);
+		}
+		std::vector<std::pair<double, std::size_t>> getWeightedItems() const
+		{
+			// Returns every value held with its weight, in ascending order
+			std::vector<std::pair<double, std::size_t>> items;
+			items.reserve(retained);
+			for (std::size_t i = 0; i < levels.size(); ++i)
+			{
+				for (double item : levels[i])
+				{
+					items.emplace_back(item, std::size_t(1) << i);
+				}
+			}
+			std::sort(items.begin(), items.end());
+			return items;
+		}
+	};
+
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		inline double selectQuantile(std::vector<double> & values, double quantile)
+		{
+			// Returns the exact quantile of 'values', which mustn't hold NaNs, reordering them. Between two values
+			// it's interpolated linearly, as numpy.quantile does by default: the q-th quantile of n values is
+			// x[h] + (h - floor(h)) * (x[floor(h) + 1] - x[floor(h)]) for h = q * (n - 1), x being sorted.
+			// Only x[floor(h)] and x[floor(h) + 1] are needed, so they're selected in linear time rather than sorted for.
+			if (values.empty())
+			{
+				return 0;
+			}
+			double position = (quantile > 0 ? std::min(quantile, 1.0) : 0.0) * (values.size() - 1);
+			std::size_t lower = static_cast<std::size_t>(position);
+			std::nth_element(values.begin(), values.begin() + lower, values.end());
+			double lowerValue = values[lower];
+			if (position == lower || lower + 1 == values.size())
+			{
+				return lowerValue;
+			}
+			double upperValue = *std::min_element(values.begin() + lower + 1, values.end());
+			return lowerValue == upperValue ? lowerValue : lowerValue + (position - lower) * (upperValue - lowerValue);
+		}
+
+		template <typename RangeIteratorType>
+		double quantileOfRanges(RangeIteratorType first, RangeIteratorType last, double quantile)
+		{
+			// Copies the values of the ranges, NaNs aside, and selects the quantile from the copy
+			std::vector<double> values;
+			values.reserve(getRangeOffsets(first, last).back());
+			for (; first != last; ++first)
+			{
+				std::copy_if(std::begin(*first), std::end(*first), std::back_inserter(values), [](double value) { return !std::isnan(value); });
+			}
+			return selectQuantile(values, quantile);
+		}
+
+		template <typename RangeIteratorType>
+		QuantileSketch sketchRanges(RangeIteratorType first, RangeIteratorType last, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL)
+		{
+			// Sketches the same fixed blocks as the other reductions and merges them in a fixed order, so the
+			// sketch doesn't depend on the number of threads
+			return reduceBlocks<QuantileSketch>(first, last, execution, [](const auto & forEachSegment)
+			{
+				QuantileSketch sketch;
+				forEachSegment([&sketch](auto segmentFirst, auto segmentLast)
+				{
+					sketch.add(segmentFirst, segmentLast);
+				});
+				return sketch;
+			}, [](QuantileSketch lhs, const QuantileSketch & rhs)
+			{
+				lhs.merge(rhs);
+				return lhs;
+			});
+		}
+	}
+}
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "ParallelFunctions.hpp"
+
+namespace fileFunctions
+{
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		// Sorting for NumericFile. Ascending sorts (std::less<double>, the default predicate) use an LSD radix
+		// sort on the bits of the values: flipping the sign bit of positive values and every bit of negative
+		// ones turns IEEE-754 doubles into unsigned integers in the same order, so the keys are sorted 11 bits
+		// at a time, least significant first, in six stable counting passes. Passes whose digit is the same
+		// for every key, such as the top digit of values of similar magnitude, are skipped. NaNs, which have
+		// no place in that order, are moved to the end first, and -0.0 comes before 0.0. Other predicates go
+		// through std::sort. With ExecutionMode::PARALLEL a long run of values is split between threads: each
+		// radix pass counts and scatters a chunk per thread, and other predicates sort a chunk per thread
+		// and merge the chunks in pairs.
+		const std::size_t  radixSortMinimum    = 1024; // Fewer values than this are sorted with std::sort
+		const std::size_t  parallelSortMinimum = std::size_t(1) << 16; // Per thread
+		const unsigned int radixBits           = 11; // 2048 counters per pass stay in the L1 cache
+		const std::size_t  radixSize           = std::size_t(1) << radixBits;
+
+		inline std::uint64_t radixKey(double value)
+		{
+			const std::uint64_t signBit = std::uint64_t(1) << 63;
+			std::uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			return (bits & signBit) ? ~bits : bits | signBit;
+		}
+
+		inline double radixValue(std::uint64_t key)
+		{
+			const std::uint64_t signBit = std::uint64_t(1) << 63;
+			std::uint64_t bits = (key & signBit) ? key ^ signBit : ~key;
+			double value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		inline bool ascendingOrder(double lhs, double rhs)
+		{
+			// The order of the radix sort, as a predicate: NaNs after everything else and -0.0 before 0.0
+			if (std::isnan(lhs) || std::isnan(rhs))
+			{
+				return !std::isnan(lhs) && std::isnan(rhs);
+			}
+			return radixKey(lhs) < radixKey(rhs);
+		}
+
+		template <typename PredicateType>
+		constexpr bool isAscendingPredicate()
+		{
+			return std::is_same_v<PredicateType, std::less<double>> || std::is_same_v<PredicateType, std::less<>>;
+		}
+
+		inline void radixSortKeys(std::vector<std::uint64_t> & keys, std::vector<std::uint64_t> & buffer, sp::ExecutionMode mode)
+		{
+			// Sorts 'keys', using 'buffer' (of the same size) for the passes
+			std::size_t count = keys.size();
+			std::size_t chunkCount = sp::FWPF::getChunkCount(count, mode, parallelSortMinimum);
+			std::vector<std::array<std::size_t, radixSize>> positions(chunkCount);
+			for (unsigned int shift = 0; shift < 64; shift += radixBits)
+			{
+				const std::uint64_t * source = keys.data();
+				std::uint64_t * destination = buffer.data();
+				sp::FWPF::parallelForChunks(count, chunkCount, [&](std::size_t chunk, std::size_t first, std::size_t last)
+				{
+					std::array<std::size_t, radixSize> & histogram = positions[chunk];
+					histogram.fill(0);
+					for (std::size_t i = first; i < last; ++i)
+					{
+						++histogram[(source[i] >> shift) & (radixSize - 1)];
+					}
+				});
+				std::size_t digit = (source[0] >> shift) & (radixSize - 1);
+				std::size_t sameDigit = 0;
+				for (const std::array<std::size_t, radixSize> & histogram : positions)
+				{
+					sameDigit += histogram[digit];
+				}
+				if (sameDigit == count)
+				{
+					continue;
+				}
+				// Each chunk writes the keys of each digit after those of the lower digits and of the earlier chunks
+				std::size_t position = 0;
+				for (std::size_t i = 0; i < radixSize; ++i)
+				{
+					for (std::array<std::size_t, radixSize> & histogram : positions)
+					{
+						std::size_t keysWithDigit = histogram[i];
+						histogram[i] = position;
+						position += keysWithDigit;
+					}
+				}
+				sp::FWPF::parallelForChunks(count, chunkCount, [&](std::size_t chunk, std::size_t first, std::size_t last)
+				{
+					std::array<std::size_t, radixSize> & next = positions[chunk];
+					for (std::size_t i = first; i < last; ++i)
+					{
+						destination[next[(source[i] >> shift) & (radixSize - 1)]++] = source[i];
+					}
+				});
+				keys.swap(buffer);
+			}
+		}
+
+		inline void radixSortValues(double * first, double * last, sp::ExecutionMode mode)
+		{
+			// Sorts [first, last) in ascending order, NaNs last
+			double * numbers = std::partition(first, last, [](double value) { return !std::isnan(value); });
+			std::size_t count = static_cast<std::size_t>(numbers - first);
+			if (count < radixSortMinimum)
+			{
+				std::sort(first, numbers, ascendingOrder);
+				return;
+			}
+			std::vector<std::uint64_t> keys(count);
+			std::vector<std::uint64_t> buffer(count);
+			std::size_t chunkCount = sp::FWPF::getChunkCount(count, mode, parallelSortMinimum);
+			sp::FWPF::parallelForChunks(count, chunkCount, [&](std::size_t, std::size_t chunkFirst, std::size_t chunkLast)
+			{
+				std::transform(first + chunkFirst, first + chunkLast, keys.begin() + chunkFirst, radixKey);
+			});
+			radixSortKeys(keys, buffer, mode);
+			sp::FWPF::parallelForChunks(count, chunkCount, [&](std::size_t, std::size_t chunkFirst, std::size_t chunkLast)
+			{
+				std::transform(keys.begin() + chunkFirst, keys.begin() + chunkLast, first + chunkFirst, radixValue);
+			});
+		}
+
+		template <typename PredicateType>
+		void parallelSortValues(double * first, double * last, const PredicateType & predicate, sp::ExecutionMode mode)
+		{
+			// Sorts a chunk of [first, last) per thread, then merges neighbouring chunks in pairs, every pair of a
+			// round on its own thread, until one is left
+			std::size_t count = static_cast<std::size_t>(last - first);
+			std::size_t chunkCount = sp::FWPF::getChunkCount(count, mode, parallelSortMinimum);
+			if (chunkCount <= 1)
+			{
+				std::sort(first, last, predicate);
+				return;
+			}
+			std::vector<std::size_t> bounds(chunkCount + 1);
+			for (std::size_t i = 0; i <= chunkCount; ++i)
+			{
+				bounds[i] = count * i / chunkCount; // The same chunks as parallelForChunks
+			}
+			sp::FWPF::parallelForChunks(count, chunkCount, [&](std::size_t, std::size_t chunkFirst, std::size_t chunkLast)
+			{
+				std::sort(first + chunkFirst, first + chunkLast, predicate);
+			});
+			std::vector<double> buffer(count);
+			double * source = first;
+			double * destination = buffer.data();
+			while (bounds.size() > 2)
+			{
+				std::size_t pairCount = (bounds.size() - 1) / 2;
+				std::size_t runCount = bounds.size() - 1;
+				sp::FWPF::parallelForChunks(runCount - pairCount, runCount - pairCount, [&](std::size_t pair, std::size_t, std::size_t)
+				{
+					std::size_t runFirst = bounds[2 * pair];
+					if (2 * pair + 1 == runCount)
+					{
+						std::copy(source + runFirst, source + count, destination + runFirst); // An odd run out
+						return;
+					}
+					std::merge(source + runFirst, source + bounds[2 * pair + 1], source + bounds[2 * pair + 1], source + bounds[2 * pair + 2], destination + runFirst, predicate);
+				});
+				std::vector<std::size_t> merged;
+				for (std::size_t i = 0; i < bounds.size(); i += 2)
+				{
+					merged.push_back(bounds[i]);
+				}
+				if (merged.back() != count)
+				{
+					merged.push_back(count);
+				}
+				bounds.swap(merged);
+				std::swap(source, destination);
+			}
+			if (source != first)
+			{
+				std::copy(source, source + count, first);
+			}
+		}
+
+		template <typename PredicateType>
+		void sortValues(double * first, double * last, const PredicateType & predicate, sp::ExecutionMode mode)
+		{
+			if constexpr (isAscendingPredicate<PredicateType>())
+			{
+				radixSortValues(first, last, mode);
+			}
+			else
+			{
+				parallelSortValues(first, last, predicate, mode);
+			}
+		}
+
+		template <typename LineType, typename PredicateType>
+		void sortNumericLine(LineType & line, const PredicateType & predicate, sp::ExecutionMode mode, std::vector<double> & buffer)
+		{
+			// Lines aren't contiguous, so long ones are sorted in 'buffer' and copied back
+			if (line.size() < radixSortMinimum && mode == sp::ExecutionMode::SEQUENTIAL)
+			{
+				if constexpr (isAscendingPredicate<PredicateType>())
+				{
+					std::sort(line.begin(), line.end(), ascendingOrder);
+				}
+				else
+				{
+					std::sort(line.begin(), line.end(), predicate);
+				}
+				return;
+			}
+			buffer.assign(line.begin(), line.end());
+			sortValues(buffer.data(), buffer.data() + buffer.size(), predicate, mode);
+			std::copy(buffer.begin(), buffer.end(), line.begin());
+		}
+
+		template <typename LineIteratorType, typename PredicateType>
+		void sortNumericLines(LineIteratorType first, LineIteratorType last, const PredicateType & predicate, sp::ExecutionMode mode)
+		{
+			// Sorts each line on its own. With mode == PARALLEL the lines are shared out between threads, except
+			// those long enough to be worth splitting, which are then sorted one at a time using every thread.
+			std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+			std::size_t splitLength = mode == sp::ExecutionMode::PARALLEL && sp::getThreadCount() > 1 ? 2 * parallelSortMinimum : static_cast<std::size_t>(-1);
+			sp::FWPF::parallelForChunks(count, sp::FWPF::getChunkCount(count, mode, 16), [&](std::size_t, std::size_t chunkFirst, std::size_t chunkLast)
+			{
+				std::vector<double> buffer;
+				for (LineIteratorType i = std::next(first, chunkFirst), end = std::next(first, chunkLast); i != end; ++i)
+				{
+					if (i->size() < splitLength)
+					{
+						sortNumericLine(*i, predicate, sp::ExecutionMode::SEQUENTIAL, buffer);
+					}
+				}
+			});
+			std::vector<double> buffer;
+			for (LineIteratorType i = first; i != last && splitLength != static_cast<std::size_t>(-1); ++i)
+			{
+				if (i->size() >= splitLength)
+				{
+					sortNumericLine(*i, predicate, mode, buffer);
+				}
+			}
+		}
+
+		template <typename LineIteratorType, typename PredicateType>
+		void sortNumericLinesByEntry(LineIteratorType first, LineIteratorType last, std::size_t index, const PredicateType & predicate)
+		{
+			// Reorders the lines by their index-th entries, keeping the order of lines whose entries are equal.
+			// Lines without an index-th entry keep their order after all the others.
+			typedef typename std::iterator_traits<LineIteratorType>::value_type LineType;
+			std::vector<std::pair<double, std::size_t>> keys;
+			std::vector<std::size_t> order;
+			std::size_t line = 0;
+			for (LineIteratorType i = first; i != last; ++i, ++line)
+			{
+				if (index < i->size())
+				{
+					keys.emplace_back((*i)[index], line);
+				}
+			}
+			std::stable_sort(keys.begin(), keys.end(), [&predicate](const std::pair<double, std::size_t> & lhs, const std::pair<double, std::size_t> & rhs)
+			{
+				if constexpr (isAscendingPredicate<PredicateType>())
+				{
+					return ascendingOrder(lhs.first, rhs.first);
+				}
+				else
+				{
+					return predicate(lhs.first, rhs.first);
+				}
+			});
+			order.reserve(line);
+			for (const std::pair<double, std::size_t> & i : keys)
+			{
+				order.push_back(i.second);
+			}
+			line = 0;
+			for (LineIteratorType i = first; i != last; ++i, ++line)
+			{
+				if (index >= i->size())
+				{
+					order.push_back(line);
+				}
+			}
+			std::vector<LineType> lines;
+			lines.reserve(order.size());
+			for (std::size_t i : order)
+			{
+				lines.push_back(std::move(*std::next(first, i)));
+			}
+			std::move(lines.begin(), lines.end(), first);
+		}
+	}
+}
@@ -0,0 +1,526 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "NumericKernels.hpp"
+
+namespace fileFunctions
+{
+	// Count, sum, absolute sum, minimum, maximum, mean and variance of a set of values, gathered in a single pass.
+	// The variance is kept as a mean and a sum of squared deviations from it (Welford), which stays accurate
+	// where sum(x^2) - n * mean^2 would cancel. Two summaries of different values can be merged into the
+	// summary of all of them (Chan et al.), so partial summaries built in parallel, or over a stream,
+	// can be combined at the end.
+	class NumericSummary
+	{
+	public:
+		static constexpr std::size_t blockSize = 256; // Values are summarised in blocks of this many, then merged
+	private:
+		friend class NumericColumnSummary;
+
+		std::size_t count;
+		double      sum;
+		double      absoluteSum;
+		double      minimum;
+		double      maximum;
+		double      mean;
+		double      squaredDeviations;
+	public:
+		NumericSummary() : count(0), sum(0), absoluteSum(0), minimum(std::numeric_limits<double>::infinity()), maximum(-std::numeric_limits<double>::infinity()), mean(0), squaredDeviations(0)
+		{
+		}
+		template <typename IteratorType>
+		NumericSummary(IteratorType first, IteratorType last) : NumericSummary()
+		{
+			add(first, last);
+		}
+		void add(double value)
+		{
+			++count;
+			sum += value;
+			absoluteSum += std::abs(value);
+			minimum = value < minimum ? value : minimum;
+			maximum = value > maximum ? value : maximum;
+			double delta = value - mean;
+			mean += delta / count;
+			squaredDeviations += delta * (value - mean);
+		}
+		void add(const double * first, const double * last)
+		{
+			// Summarises blocks of values and merges them, so the division in add(double) is paid once per block.
+			// Each block is read twice, but the second read comes from cache.
+			while (first != last)
+			{
+				std::size_t size = std::min(blockSize, static_cast<std::size_t>(last - first));
+				merge(summariseBlock(first, size));
+				first += size;
+			}
+		}
+		template <typename IteratorType>
+		void add(IteratorType first, IteratorType last)
+		{
+			if constexpr (std::is_convertible_v<IteratorType, const double *>)
+			{
+				add(static_cast<const double *>(first), static_cast<const double *>(last));
+			}
+			else
+			{
+				double buffer[blockSize];
+				std::size_t buffered = 0;
+				for (; first != last; ++first)
+				{
+					buffer[buffered++] = static_cast<double>(*first);
+					if (buffered == blockSize)
+					{
+						add(buffer, buffer + buffered);
+						buffered = 0;
+					}
+				}
+				add(buffer, buffer + buffered);
+			}
+		}
+		void merge(const NumericSummary & rhs)
+		{
+			// Makes this the summary of its own values and those of rhs
+			if (rhs.count == 0)
+			{
+				return;
+			}
+			if (count == 0)
+			{
+				*this = rhs;
+				return;
+			}
+			std::size_t total = count + rhs.count;
+			double delta = rhs.mean - mean;
+			double rhsWeight = static_cast<double>(rhs.count) / total;
+			mean += delta * rhsWeight;
+			squaredDeviations += rhs.squaredDeviations + delta * delta * count * rhsWeight;
+			count = total;
+			sum += rhs.sum;
+			absoluteSum += rhs.absoluteSum;
+			minimum = rhs.minimum < minimum ? rhs.minimum : minimum;
+			maximum = rhs.maximum > maximum ? rhs.maximum : maximum;
+		}
+		// Everything computed over no values is 0, as with the compute functions of NumericFile
+		std::size_t getCount() const
+		{
+			return count;
+		}
+		double getSum() const
+		{
+			return sum;
+		}
+		double getAbsoluteSum() const
+		{
+			return absoluteSum;
+		}
+		double getMinimum() const
+		{
+			return count ? minimum : 0;
+		}
+		double getMaximum() const
+		{
+			return count ? maximum : 0;
+		}
+		double getAverage() const
+		{
+			return mean;
+		}
+		double getAbsoluteAverage() const
+		{
+			return count ? absoluteSum / count : 0;
+		}
+		double getVariance() const
+		{
+			// Population variance
+			return count ? squaredDeviations / count : 0;
+		}
+		double getStandardDeviation() const
+		{
+			return std::sqrt(getVariance());
+		}
+	private:
+		NumericSummary(std::size_t valueCount, double valueSum, double valueAbsoluteSum, double valueMinimum, double valueMaximum, double valueMean, double valueSquaredDeviations) : count(valueCount), sum(valueSum), absoluteSum(valueAbsoluteSum), minimum(valueMinimum), maximum(valueMaximum), mean(valueMean), squaredDeviations(valueSquaredDeviations)
+		{
+		}
+		static NumericSummary summariseBlock(const double * data, std::size_t size)
+		{
+			NumericSummary block;
+			if (size == 0)
+			{
+				return block;
+			}
+			double blockSum = 0;
+			double blockAbsoluteSum = 0;
+			// The extremes start from the identities of the minimum and maximum reductions, so NaNs are skipped
+			// by the compares wherever they are in the block, as they are by computeMinimumOf*
+			double blockMinimum = std::numeric_limits<double>::infinity();
+			double blockMaximum = -std::numeric_limits<double>::infinity();
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				double x = data[i];
+				blockSum += x;
+				blockAbsoluteSum += std::abs(x);
+				blockMinimum = x < blockMinimum ? x : blockMinimum;
+				blockMaximum = x > blockMaximum ? x : blockMaximum;
+			}
+			double blockMean = blockSum / size;
+			double blockSquaredDeviations = 0;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				double deviation = data[i] - blockMean;
+				blockSquaredDeviations += deviation * deviation;
+			}
+			block.count = size;
+			block.sum = blockSum;
+			block.absoluteSum = blockAbsoluteSum;
+			block.minimum = blockMinimum;
+			block.maximum = blockMaximum;
+			block.mean = blockMean;
+			block.squaredDeviations = blockSquaredDeviations;
+			return block;
+		}
+	};
+
+	// The summary of every column of a set of lines at once, where column i is the i-th entry of every line
+	// that has one. It's kept as one array per statistic, indexed by column, and lines are added in blocks
+	// of blockRows: the block is gone through row by row, and each row updates every column with one
+	// contiguous loop that the compiler vectorises, so the lines are read in the order they're stored and
+	// no column is ever walked with a stride. As with NumericSummary, each block is summarised on its own
+	// (sum, extremes, then the squared deviations from its mean) and merged into the totals (Chan et al.).
+	class NumericColumnSummary
+	{
+	public:
+		static const std::size_t blockRows = 256; // Lines are summarised in blocks of this many, then merged
+	private:
+		std::vector<std::size_t> counts;
+		std::vector<double>      sums;
+		std::vector<double>      absoluteSums;
+		std::vector<double>      minima;
+		std::vector<double>      maxima;
+		std::vector<double>      means;
+		std::vector<double>      squaredDeviations;
+	public:
+		NumericColumnSummary()
+		{
+		}
+		void add(const double * first, const double * last)
+		{
+			// Adds a single line, one value per column
+			std::size_t length = static_cast<std::size_t>(last - first);
+			addBlock(&first, &length, 1, length);
+		}
+		template <typename RowFunctionType>
+		void addRows(std::size_t firstRow, std::size_t lastRow, const RowFunctionType & getRow)
+		{
+			// Adds rows [firstRow, lastRow). getRow(i) returns something with begin(), end() and size(); rows
+			// that aren't contiguous, such as a NumericLine, are copied into a buffer a block at a time.
+			std::vector<const double *> rows;
+			std::vector<std::size_t> lengths;
+			std::vector<double> buffer;
+			for (std::size_t blockFirst = firstRow; blockFirst < lastRow; blockFirst += blockRows)
+			{
+				std::size_t blockLast = std::min(blockFirst + blockRows, lastRow);
+				rows.clear();
+				lengths.clear();
+				buffer.clear();
+				std::size_t width = 0;
+				for (std::size_t i = blockFirst; i < blockLast; ++i)
+				{
+					lengths.push_back(static_cast<std::size_t>(getRow(i).size()));
+					width = std::max(width, lengths.back());
+				}
+				for (std::size_t i = blockFirst; i < blockLast; ++i)
+				{
+					const auto & row = getRow(i);
+					if constexpr (std::is_convertible_v<decltype(std::begin(row)), const double *>)
+					{
+						rows.push_back(std::begin(row));
+					}
+					else
+					{
+						if (buffer.empty())
+						{
+							buffer.resize(blockRows * width);
+						}
+						double * copy = buffer.data() + (i - blockFirst) * width;
+						std::copy(std::begin(row), std::end(row), copy);
+						rows.push_back(copy);
+					}
+				}
+				addBlock(rows.data(), lengths.data(), rows.size(), width);
+			}
+		}
+		void merge(const NumericColumnSummary & rhs)
+		{
+			// Makes this the summary of its own lines and those of rhs
+			resize(rhs.getColumnCount());
+			for (std::size_t i = 0; i < rhs.getColumnCount(); ++i)
+			{
+				mergeColumn(i, static_cast<double>(rhs.counts[i]), rhs.sums[i], rhs.absoluteSums[i], rhs.minima[i], rhs.maxima[i], rhs.means[i], rhs.squaredDeviations[i]);
+			}
+		}
+		std::size_t         getColumnCount() const
+		{
+			// The length of the longest line added
+			return counts.size();
+		}
+		NumericSummary      getSummary    (std::size_t column) const
+		{
+			// Returns the summary of a column, which is empty if no line has that many entries
+			if (column >= getColumnCount())
+			{
+				return NumericSummary();
+			}
+			return NumericSummary(counts[column], sums[column], absoluteSums[column], minima[column], maxima[column], means[column], squaredDeviations[column]);
+		}
+		// Each statistic for every column, indexed by column. Everything computed over no values is 0.
+		std::vector<std::size_t> getCounts            () const
+		{
+			return counts;
+		}
+		std::vector<double>      getSums              () const
+		{
+			return sums;
+		}
+		std::vector<double>      getAbsoluteSums      () const
+		{
+			return absoluteSums;
+		}
+		std::vector<double>      getMinima            () const
+		{
+			return forEachColumn([this](std::size_t i) { return counts[i] ? minima[i] : 0; });
+		}
+		std::vector<double>      getMaxima            () const
+		{
+			return forEachColumn([this](std::size_t i) { return counts[i] ? maxima[i] : 0; });
+		}
+		std::vector<double>      getAverages          () const
+		{
+			return means;
+		}
+		std::vector<double>      getAbsoluteAverages  () const
+		{
+			return forEachColumn([this](std::size_t i) { return counts[i] ? absoluteSums[i] / counts[i] : 0; });
+		}
+		std::vector<double>      getVariances         () const
+		{
+			// Population variances
+			return forEachColumn([this](std::size_t i) { return counts[i] ? squaredDeviations[i] / counts[i] : 0; });
+		}
+		std::vector<double>      getStandardDeviations() const
+		{
+			return forEachColumn([this](std::size_t i) { return counts[i] ? std::sqrt(squaredDeviations[i] / counts[i]) : 0; });
+		}
+	private:
+		template <typename FunctionType>
+		std::vector<double> forEachColumn(const FunctionType & function) const
+		{
+			std::vector<double> result(getColumnCount());
+			for (std::size_t i = 0; i < result.size(); ++i)
+			{
+				result[i] = function(i);
+			}
+			return result;
+		}
+		void resize(std::size_t columns)
+		{
+			if (columns > getColumnCount())
+			{
+				counts.resize(columns, 0);
+				sums.resize(columns, 0);
+				absoluteSums.resize(columns, 0);
+				minima.resize(columns, std::numeric_limits<double>::infinity());
+				maxima.resize(columns, -std::numeric_limits<double>::infinity());
+				means.resize(columns, 0);
+				squaredDeviations.resize(columns, 0);
+			}
+		}
+		void mergeColumn(std::size_t i, double rhsCount, double rhsSum, double rhsAbsoluteSum, double rhsMinimum, double rhsMaximum, double rhsMean, double rhsSquaredDeviations)
+		{
+			// NumericSummary::merge for a single column
+			if (rhsCount == 0)
+			{
+				return;
+			}
+			std::size_t total = counts[i] + static_cast<std::size_t>(rhsCount);
+			double delta = rhsMean - means[i];
+			double rhsWeight = rhsCount / total;
+			means[i] = counts[i] ? means[i] + delta * rhsWeight : rhsMean;
+			squaredDeviations[i] = counts[i] ? squaredDeviations[i] + rhsSquaredDeviations + delta * delta * counts[i] * rhsWeight : rhsSquaredDeviations;
+			counts[i] = total;
+			sums[i] += rhsSum;
+			absoluteSums[i] += rhsAbsoluteSum;
+			minima[i] = rhsMinimum < minima[i] ? rhsMinimum : minima[i];
+			maxima[i] = rhsMaximum > maxima[i] ? rhsMaximum : maxima[i];
+		}
+		void addBlock(const double * const * rows, const std::size_t * lengths, std::size_t rowCount, std::size_t width)
+		{
+			// Summarises a block of rows, none longer than 'width', and merges it into the totals. Every column
+			// below 'width' has at least one value in the block.
+			std::vector<double> blockCounts(width, 0);
+			std::vector<double> blockSums(width, 0);
+			std::vector<double> blockAbsoluteSums(width, 0);
+			std::vector<double> blockMinima(width, std::numeric_limits<double>::infinity());
+			std::vector<double> blockMaxima(width, -std::numeric_limits<double>::infinity());
+			std::vector<double> blockSquaredDeviations(width, 0);
+			double * count = blockCounts.data();
+			double * sum = blockSums.data();
+			double * absoluteSum = blockAbsoluteSums.data();
+			double * minimum = blockMinima.data();
+			double * maximum = blockMaxima.data();
+			double * squaredDeviation = blockSquaredDeviations.data();
+			for (std::size_t r = 0; r < rowCount; ++r)
+			{
+				const double * row = rows[r];
+				for (std::size_t j = 0; j < lengths[r]; ++j)
+				{
+					double x = row[j];
+					count[j] += 1;
+					sum[j] += x;
+					absoluteSum[j] += std::abs(x);
+					minimum[j] = x < minimum[j] ? x : minimum[j];
+					maximum[j] = x > maximum[j] ? x : maximum[j];
+				}
+			}
+			std::vector<double> blockMeans(width);
+			double * mean = blockMeans.data();
+			for (std::size_t j = 0; j < width; ++j)
+			{
+				mean[j] = sum[j] / count[j];
+			}
+			for (std::size_t r = 0; r < rowCount; ++r)
+			{
+				const double * row = rows[r];
+				for (std::size_t j = 0; j < lengths[r]; ++j)
+				{
+					double deviation = row[j] - mean[j];
+					squaredDeviation[j] += deviation * deviation;
+				}
+			}
+			resize(width);
+			for (std::size_t j = 0; j < width; ++j)
+			{
+				mergeColumn(j, count[j], sum[j], absoluteSum[j], minimum[j], maximum[j], mean[j], squaredDeviation[j]);
+			}
+		}
+	};
+
+	namespace NFPF // NumericFilePrivateFunctions
+	{
+		template <typename RangeIteratorType>
+		NumericSummary summariseRanges(RangeIteratorType first, RangeIteratorType last, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL)
+		{
+			// Summarises fixed blocks of values and merges them in a fixed order, like the other reductions
+			return reduceBlocks<NumericSummary>(first, last, execution, [](const auto & forEachSegment)
+			{
+				// The values are gathered across line boundaries, so the blocks of NumericSummary::add fall in the
+				// same places however the values are split into lines
+				NumericSummary summary;
+				double buffer[NumericSummary::blockSize];
+				std::size_t buffered = 0;
+				forEachSegment([&](auto segmentFirst, auto segmentLast)
+				{
+					for (; segmentFirst != segmentLast; ++segmentFirst)
+					{
+						buffer[buffered++] = *segmentFirst;
+						if (buffered == NumericSummary::blockSize)
+						{
+							summary.add(buffer, buffer + buffered);
+							buffered = 0;
+						}
+					}
+				});
+				summary.add(buffer, buffer + buffered);
+				return summary;
+			}, [](NumericSummary lhs, const NumericSummary & rhs)
+			{
+				lhs.merge(rhs);
+				return lhs;
+			});
+		}
+
+		const std::size_t columnBlockRows = std::size_t(1) << 12;
+
+		template <typename RowFunctionType>
+		NumericColumnSummary summariseColumns(std::size_t rowCount, const RowFunctionType & getRow, sp::ExecutionMode execution = sp::ExecutionMode::SEQUENTIAL)
+		{
+			// Summarises the columns of rows [0, rowCount) in fixed blocks of columnBlockRows rows, merged in a
+			// fixed tree, so the result doesn't depend on the number of threads
+			std::size_t blockCount = std::max<std::size_t>(1, (rowCount + columnBlockRows - 1) / columnBlockRows);
+			std::vector<NumericColumnSummary> results(blockCount);
+			sp::FWPF::parallelForChunks(blockCount, sp::FWPF::getChunkCount(blockCount, execution, 1), [&](std::size_t, std::size_t firstBlock, std::size_t lastBlock)
+			{
+				for (std::size_t block = firstBlock; block < lastBlock; ++block)
+				{
+					results[block].addRows(block * columnBlockRows, std::min(rowCount, (block + 1) * columnBlockRows), getRow);
+				}
+			});
+			return combineBlocks(results, 0, blockCount, [](NumericColumnSummary lhs, const NumericColumnSummary & rhs)
+			{
+				lhs.merge(rhs);
+				return lhs;
+			});
+		}
+
+		class StreamingSummary
+		{
+			// Builds the same summary as summariseRanges, with the same bits, for values that arrive a run at a
+			// time: the same fixed blocks, the same 256-value groups, and one summary kept per block
+		private:
+			std::vector<NumericSummary> blocks;
+			NumericSummary              block;
+			std::size_t                 blockValues;
+			double                      buffer[NumericSummary::blockSize];
+			std::size_t                 buffered;
+		public:
+			StreamingSummary() : blockValues(0), buffered(0)
+			{
+			}
+			void push(const double * first, const double * last)
+			{
+				for (; first != last; ++first)
+				{
+					buffer[buffered++] = *first;
+					if (buffered == NumericSummary::blockSize)
+					{
+						block.add(buffer, buffer + buffered);
+						buffered = 0;
+					}
+					if (++blockValues == reductionBlockSize)
+					{
+						finishBlock();
+					}
+				}
+			}
+			NumericSummary finish()
+			{
+				// Returns the summary of everything pushed. Nothing more should be pushed afterwards.
+				if (blockValues || blocks.empty())
+				{
+					finishBlock();
+				}
+				return combineBlocks(blocks, 0, blocks.size(), [](NumericSummary lhs, const NumericSummary & rhs)
+				{
+					lhs.merge(rhs);
+					return lhs;
+				});
+			}
+		private:
+			void finishBlock()
+			{
+				block.add(buffer, buffer + buffered);
+				blocks.push_back(block);
+				block = NumericSummary();
+				blockValues = 0;
+				buffered = 0;
+			}
+		};
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <exception>
+
+namespace sp
+{
+	enum class ExecutionMode
+	{
+		SEQUENTIAL, // Run the operation on the calling thread
+		PARALLEL // Split the operation across getThreadCount() threads
+	};
+
+	namespace FWPF // FileWrapperPrivateFunctions
+	{
+		inline std::atomic<std::size_t> & threadCountSetting()
+		{
+			// Holds the value set by sp::setThreadCount, 0 meaning "use the hardware concurrency"
+			static std::atomic<std::size_t> threadCount(0);
+			return threadCount;
+		}
+	}
+
+	inline void setThreadCount(std::size_t threadCount)
+	{
+		// Sets the number of threads used by ExecutionMode::PARALLEL operations.
+		// Passing 0 restores the default, which is the hardware concurrency.
+		FWPF::threadCountSetting() = threadCount;
+	}
+
+	inline std::size_t getThreadCount()
+	{
+		// Returns the number of threads used by ExecutionMode::PARALLEL operations
+		std::size_t threadCount = FWPF::threadCountSetting();
+		if (threadCount == 0)
+		{
+			threadCount = std::thread::hardware_concurrency();
+		}
+		return threadCount ? threadCount : 1;
+	}
+
+	namespace FWPF // FileWrapperPrivateFunctions
+	{
+		inline std::size_t getChunkCount(std::size_t count, ExecutionMode mode, std::size_t minimumChunkSize = 1024)
+		{
+			// Returns how many contiguous chunks [0, count) should be split into
+			if (mode == ExecutionMode::SEQUENTIAL || count <= minimumChunkSize)
+			{
+				return 1;
+			}
+			return std::max<std::size_t>(1, std::min(getThreadCount(), count / minimumChunkSize));
+		}
+
+		template <typename FunctionType>
+		void parallelForChunks(std::size_t count, std::size_t chunkCount, const FunctionType & function)
+		{
+			// Splits [0, count) into chunkCount contiguous chunks and calls function(chunk, first, last)
+			// once per chunk, each on its own thread. The calling thread runs the first chunk itself.
+			// The first exception thrown by any chunk is rethrown once every thread has finished.
+			if (chunkCount <= 1)
+			{
+				function(std::size_t(0), std::size_t(0), count);
+				return;
+			}
+			std::vector<std::thread> threads;
+			std::vector<std::exception_ptr> errors(chunkCount);
+			threads.reserve(chunkCount - 1);
+			auto runChunk = [&](std::size_t chunk)
+			{
+				try
+				{
+					function(chunk, count * chunk / chunkCount, count * (chunk + 1) / chunkCount);
+				}
+				catch (...)
+				{
+					errors.at(chunk) = std::current_exception();
+				}
+			};
+			for (std::size_t i = 1; i < chunkCount; ++i)
+			{
+				threads.emplace_back(runChunk, i);
+			}
+			runChunk(0);
+			for (std::thread & i : threads)
+			{
+				i.join();
+			}
+			for (const std::exception_ptr & i : errors)
+			{
+				if (i)
+				{
+					std::rethrow_exception(i);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,1002 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <array>
+#include <bitset>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+#include <string_view>
+
+#include "ParallelFunctions.hpp"
+
+namespace sp
+{
+	// A compiled regular expression. Patterns are parsed once into a Thompson NFA, which
+	// RegexMatcher turns into a DFA lazily while it scans, so matching is linear in the length
+	// of the line no matter what the pattern looks like (there is no backtracking).
+	//
+	// Supported syntax: literals, '.', '[...]' and '[^...]' (ranges, escapes and [:alpha:]-style
+	// classes), '\d' '\D' '\w' '\W' '\s' '\S', '\t' '\n' '\r' '\f' '\v' '\xHH', '^', '$', '(...)',
+	// '(?:...)', '|', and the quantifiers '*' '+' '?' '{m}' '{m,}' '{m,n}'. Lazy quantifiers are
+	// accepted and behave like greedy ones, since only "does the line match" is ever reported.
+	class RegexProgram final
+	{
+	public:
+		typedef std::bitset<256> CharacterSet;
+
+		struct State
+		{
+			enum Type { CHARACTERS, SPLIT, JUMP, BEGIN, END, MATCH };
+			Type        type;
+			int         out;
+			int         out1;
+			std::size_t characters; // Index into m_characterSets for CHARACTERS states
+		};
+	private:
+		struct Node
+		{
+			enum Type { CHARACTERS, CONCATENATE, ALTERNATE, REPEAT, BEGIN, END, EMPTY };
+			Type             type;
+			CharacterSet     characters;
+			std::vector<int> children;
+			int              minimum;
+			int              maximum; // -1 means unbounded
+		};
+		struct Fragment
+		{
+			int                              start;
+			std::vector<std::pair<int, int>> outs; // (state, 0 for out or 1 for out1) still waiting to be patched
+		};
+
+		std::string               m_pattern;
+		std::vector<State>        m_states;
+		std::vector<CharacterSet> m_characterSets;
+		int                       m_start;
+		std::string               m_literalPrefix;
+		bool                      m_isLiteral;
+		bool                      m_matchesEmptyLine;
+
+		// Parsing
+		std::vector<Node> m_nodes;
+		std::size_t       m_position;
+	public:
+		explicit RegexProgram(const std::string & pattern) : m_pattern(pattern), m_start(0), m_isLiteral(false), m_matchesEmptyLine(false), m_position(0)
+		{
+			// Compiles 'pattern'. Throws std::invalid_argument if the pattern is malformed.
+			int root = parseAlternation(0);
+			if (m_position != m_pattern.size())
+			{
+				fail("unmatched ')'");
+			}
+			bool anchored = false;
+			m_isLiteral = extractLiteralPrefix(root, m_literalPrefix, anchored) && !anchored;
+			Fragment fragment = compile(root);
+			patch(fragment, addState(State::MATCH, -1, -1));
+			m_start = fragment.start;
+			m_nodes.clear();
+			m_nodes.shrink_to_fit();
+			m_matchesEmptyLine = closureAccepts(closure(std::vector<int>(1, m_start), true, true));
+		}
+		// Accessors
+		const std::string &               getPattern() const
+		{
+			// Returns the pattern the program was compiled from
+			return m_pattern;
+		}
+		const std::vector<State> &        getStates() const
+		{
+			// Returns the NFA
+			return m_states;
+		}
+		const CharacterSet &              getCharacterSet(std::size_t index) const
+		{
+			// Returns the set of characters accepted by a CHARACTERS state
+			return m_characterSets[index];
+		}
+		int                               getStart() const
+		{
+			// Returns the index of the first state of the NFA
+			return m_start;
+		}
+		const std::string &               getLiteralPrefix() const
+		{
+			// Returns a string every matching line must contain, or a blank string if there is none
+			return m_literalPrefix;
+		}
+		bool                              isLiteral() const
+		{
+			// Returns true if the pattern is a plain string, in which case a substring search is enough
+			return m_isLiteral;
+		}
+		bool                              matchesEmptyLine() const
+		{
+			// Returns true if an empty line matches the pattern
+			return m_matchesEmptyLine;
+		}
+		// Utilities
+		std::vector<int>                  closure(const std::vector<int> & seeds, bool atBegin, bool atEnd = false) const
+		{
+			// Follows every epsilon edge reachable from 'seeds' and returns the sorted set of states
+			// that either consume a character, wait for the end of the line, or accept. '^' is passed
+			// if 'atBegin' is set and '$' if 'atEnd' is, so both hold at once in an empty line.
+			std::vector<int> result;
+			std::vector<int> stack(seeds.rbegin(), seeds.rend());
+			std::vector<char> visited(m_states.size(), 0);
+			while (!stack.empty())
+			{
+				int state = stack.back();
+				stack.pop_back();
+				if (state < 0 || visited[state])
+				{
+					continue;
+				}
+				visited[state] = 1;
+				const State & current = m_states[state];
+				switch (current.type)
+				{
+				case State::SPLIT:
+				{
+					stack.push_back(current.out1);
+					stack.push_back(current.out);
+					break;
+				}
+				case State::JUMP:
+				{
+					stack.push_back(current.out);
+					break;
+				}
+				case State::BEGIN:
+				{
+					if (atBegin)
+					{
+						stack.push_back(current.out);
+					}
+					break;
+				}
+				case State::END:
+				{
+					if (atEnd)
+					{
+						stack.push_back(current.out);
+					}
+					else
+					{
+						result.push_back(state);
+					}
+					break;
+				}
+				default:
+				{
+					result.push_back(state);
+					break;
+				}
+				}
+			}
+			std::sort(result.begin(), result.end());
+			return result;
+		}
+		bool                              closureMatchesAtEnd(const std::vector<int> & states) const
+		{
+			// Returns true if 'states' accepts once the end of the line has been reached
+			return closureAccepts(closure(states, false, true));
+		}
+		bool                              closureAccepts(const std::vector<int> & states) const
+		{
+			// Returns true if 'states' holds the accepting state
+			return std::any_of(states.begin(), states.end(), [this](int i) { return m_states[i].type == State::MATCH; });
+		}
+	private:
+		[[noreturn]] void fail(const std::string & reason) const
+		{
+			throw std::invalid_argument("Invalid regular expression '" + m_pattern + "': " + reason);
+		}
+		int  addNode(Node::Type type)
+		{
+			Node node;
+			node.type = type;
+			node.minimum = 1;
+			node.maximum = 1;
+			m_nodes.push_back(node);
+			return static_cast<int>(m_nodes.size() - 1);
+		}
+		int  addCharacters(const CharacterSet & characters)
+		{
+			int node = addNode(Node::CHARACTERS);
+			m_nodes[node].characters = characters;
+			return node;
+		}
+		bool atEnd() const
+		{
+			return m_position >= m_pattern.size();
+		}
+		char peek() const
+		{
+			return m_pattern[m_position];
+		}
+		int  parseAlternation(int depth)
+		{
+			if (depth > 256)
+			{
+				fail("groups are nested too deeply");
+			}
+			int first = parseConcatenation(depth);
+			if (atEnd() || peek() != '|')
+			{
+				return first;
+			}
+			int node = addNode(Node::ALTERNATE);
+			m_nodes[node].children.push_back(first);
+			while (!atEnd() && peek() == '|')
+			{
+				++m_position;
+				int branch = parseConcatenation(depth);
+				m_nodes[node].children.push_back(branch);
+			}
+			return node;
+		}
+		int  parseConcatenation(int depth)
+		{
+			std::vector<int> children;
+			while (!atEnd() && peek() != '|' && peek() != ')')
+			{
+				children.push_back(parseRepetition(depth));
+			}
+			if (children.empty())
+			{
+				return addNode(Node::EMPTY);
+			}
+			if (children.size() == 1)
+			{
+				return children.front();
+			}
+			int node = addNode(Node::CONCATENATE);
+			m_nodes[node].children = children;
+			return node;
+		}
+		bool parseNumber(int & value)
+		{
+			std::size_t begin = m_position;
+			value = 0;
+			while (!atEnd() && peek() >= '0' && peek() <= '9')
+			{
+				value = value * 10 + (peek() - '0');
+				if (value > 1000)
+				{
+					fail("repetition count is larger than 1000");
+				}
+				++m_position;
+			}
+			return m_position != begin;
+		}
+		bool parseBraces(int & minimum, int & maximum)
+		{
+			// Parses '{m}', '{m,}' or '{m,n}'. Anything else is left alone and treated as a literal '{'.
+			std::size_t begin = m_position;
+			++m_position;
+			if (!parseNumber(minimum))
+			{
+				m_position = begin;
+				return false;
+			}
+			maximum = minimum;
+			if (!atEnd() && peek() == ',')
+			{
+				++m_position;
+				if (!parseNumber(maximum))
+				{
+					maximum = -1;
+				}
+			}
+			if (atEnd() || peek() != '}')
+			{
+				m_position = begin;
+				return false;
+			}
+			++m_position;
+			if (maximum != -1 && maximum < minimum)
+			{
+				fail("repetition range is out of order");
+			}
+			return true;
+		}
+		int  parseRepetition(int depth)
+		{
+			// A bare '^' or '$' can't be repeated, but a group holding only assertions, such as "(^)?", can
+			bool group = peek() == '(';
+			int atom = parseAtom(depth);
+			while (!atEnd())
+			{
+				int minimum = 0;
+				int maximum = -1;
+				char ch = peek();
+				if (ch == '*')
+				{
+					++m_position;
+				}
+				else if (ch == '+')
+				{
+					minimum = 1;
+					++m_position;
+				}
+				else if (ch == '?')
+				{
+					maximum = 1;
+					++m_position;
+				}
+				else if (ch != '{' || !parseBraces(minimum, maximum))
+				{
+					break;
+				}
+				if (!group && (m_nodes[atom].type == Node::BEGIN || m_nodes[atom].type == Node::END))
+				{
+					fail("nothing to repeat");
+				}
+				if (!atEnd() && peek() == '?') // Lazy quantifier, which matches the same lines as a greedy one
+				{
+					++m_position;
+				}
+				int node = addNode(Node::REPEAT);
+				m_nodes[node].children.push_back(atom);
+				m_nodes[node].minimum = minimum;
+				m_nodes[node].maximum = maximum;
+				atom = node;
+			}
+			return atom;
+		}
+		int  parseAtom(int depth)
+		{
+			char ch = peek();
+			++m_position;
+			switch (ch)
+			{
+			case '(':
+			{
+				if (m_pattern.compare(m_position, 2, "?:") == 0)
+				{
+					m_position += 2;
+				}
+				int node = parseAlternation(depth + 1);
+				if (atEnd() || peek() != ')')
+				{
+					fail("missing ')'");
+				}
+				++m_position;
+				return node;
+			}
+			case '[':
+			{
+				return addCharacters(parseBracket());
+			}
+			case '.':
+			{
+				return addCharacters(CharacterSet().set());
+			}
+			case '^':
+			{
+				return addNode(Node::BEGIN);
+			}
+			case '$':
+			{
+				return addNode(Node::END);
+			}
+			case '\\':
+			{
+				return addCharacters(parseEscape());
+			}
+			case '*':
+			case '+':
+			case '?':
+			{
+				fail("nothing to repeat");
+			}
+			default:
+			{
+				CharacterSet characters;
+				characters.set(static_cast<unsigned char>(ch));
+				return addCharacters(characters);
+			}
+			}
+		}
+		template <typename PredicateType>
+		static CharacterSet makeSet(const PredicateType & predicate)
+		{
+			CharacterSet characters;
+			for (int i = 0; i < 128; ++i)
+			{
+				if (predicate(i))
+				{
+					characters.set(i);
+				}
+			}
+			return characters;
+		}
+		static int isWord(int ch)
+		{
+			return isalnum(ch) || ch == '_';
+		}
+		CharacterSet parseEscape()
+		{
+			// Parses the character(s) following a '\'
+			if (atEnd())
+			{
+				fail("trailing '\\'");
+			}
+			char ch = peek();
+			++m_position;
+			CharacterSet characters;
+			switch (ch)
+			{
+			case 'd': return makeSet([](int i) { return isdigit(i); });
+			case 'D': return ~makeSet([](int i) { return isdigit(i); });
+			case 'w': return makeSet(isWord);
+			case 'W': return ~makeSet(isWord);
+			case 's': return makeSet([](int i) { return isspace(i); });
+			case 'S': return ~makeSet([](int i) { return isspace(i); });
+			case 't': ch = '\t'; break;
+			case 'n': ch = '\n'; break;
+			case 'r': ch = '\r'; break;
+			case 'f': ch = '\f'; break;
+			case 'v': ch = '\v'; break;
+			case 'x':
+			{
+				int value = 0;
+				for (int i = 0; i < 2; ++i)
+				{
+					if (atEnd() || !isxdigit(static_cast<unsigned char>(peek())))
+					{
+						fail("'\\x' must be followed by two hexadecimal digits");
+					}
+					char digit = static_cast<char>(tolower(peek()));
+					value = value * 16 + (isdigit(static_cast<unsigned char>(digit)) ? digit - '0' : digit - 'a' + 10);
+					++m_position;
+				}
+				ch = static_cast<char>(value);
+				break;
+			}
+			case 'b':
+			case 'B':
+			{
+				fail("word boundaries are not supported");
+			}
+			default:
+			{
+				if (isalnum(static_cast<unsigned char>(ch)))
+				{
+					fail(std::string("unknown escape '\\") + ch + "'");
+				}
+				break;
+			}
+			}
+			characters.set(static_cast<unsigned char>(ch));
+			return characters;
+		}
+		CharacterSet parseBracket()
+		{
+			// Parses a bracket expression. The opening '[' has already been consumed.
+			// The <cctype> functions are called from lambdas, since the standard doesn't allow taking their addresses
+			typedef int (*Predicate)(int);
+			static const std::pair<const char *, Predicate> classes[] =
+			{
+				{ "alpha", [](int i) { return isalpha(i); } }, { "digit", [](int i) { return isdigit(i); } },
+				{ "alnum", [](int i) { return isalnum(i); } }, { "space", [](int i) { return isspace(i); } },
+				{ "upper", [](int i) { return isupper(i); } }, { "lower", [](int i) { return islower(i); } },
+				{ "punct", [](int i) { return ispunct(i); } }, { "xdigit", [](int i) { return isxdigit(i); } }
+			};
+			CharacterSet characters;
+			bool negate = !atEnd() && peek() == '^';
+			if (negate)
+			{
+				++m_position;
+			}
+			bool first = true;
+			while (!atEnd() && (peek() != ']' || first))
+			{
+				first = false;
+				int low = static_cast<unsigned char>(peek());
+				if (peek() == '[' && m_pattern.compare(m_position, 2, "[:") == 0)
+				{
+					std::size_t close = m_pattern.find(":]", m_position + 2);
+					if (close == std::string::npos)
+					{
+						fail("unterminated character class");
+					}
+					std::string name = m_pattern.substr(m_position + 2, close - m_position - 2);
+					auto found = std::find_if(std::begin(classes), std::end(classes), [&name](const std::pair<const char *, Predicate> & i)
+					{
+						return name == i.first;
+					});
+					if (found == std::end(classes))
+					{
+						fail("unknown character class '" + name + "'");
+					}
+					characters |= makeSet(found->second);
+					m_position = close + 2;
+					continue;
+				}
+				if (peek() == '\\')
+				{
+					++m_position;
+					CharacterSet escaped = parseEscape();
+					if (escaped.count() != 1)
+					{
+						characters |= escaped;
+						continue;
+					}
+					for (low = 0; !escaped.test(low); ++low);
+				}
+				else
+				{
+					++m_position;
+				}
+				int high = low;
+				if (m_position + 1 < m_pattern.size() && peek() == '-' && m_pattern[m_position + 1] != ']')
+				{
+					++m_position;
+					high = static_cast<unsigned char>(peek());
+					++m_position;
+					if (high == '\\')
+					{
+						CharacterSet escaped = parseEscape();
+						if (escaped.count() != 1)
+						{
+							fail("invalid range in bracket expression");
+						}
+						for (high = 0; !escaped.test(high); ++high);
+					}
+					if (high < low)
+					{
+						fail("range is out of order in bracket expression");
+					}
+				}
+				for (int i = low; i <= high; ++i)
+				{
+					characters.set(i);
+				}
+			}
+			if (atEnd())
+			{
+				fail("missing ']'");
+			}
+			++m_position;
+			return negate ? ~characters : characters;
+		}
+		bool extractLiteralPrefix(int node, std::string & prefix, bool & anchored) const
+		{
+			// Appends the literal text every match of 'node' starts with to 'prefix', and returns true
+			// if 'node' matches exactly that text (so the caller may keep extending the prefix).
+			// 'anchored' is set if a '^' was skipped along the way.
+			const Node & current = m_nodes[node];
+			switch (current.type)
+			{
+			case Node::CHARACTERS:
+			{
+				if (current.characters.count() != 1)
+				{
+					return false;
+				}
+				for (int i = 0; i < 256; ++i)
+				{
+					if (current.characters.test(i))
+					{
+						prefix += static_cast<char>(i);
+						break;
+					}
+				}
+				return true;
+			}
+			case Node::CONCATENATE:
+			{
+				for (int i : current.children)
+				{
+					if (!extractLiteralPrefix(i, prefix, anchored))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+			case Node::REPEAT:
+			{
+				if (current.minimum == 0)
+				{
+					return false;
+				}
+				bool literal = extractLiteralPrefix(current.children.front(), prefix, anchored);
+				return literal && current.minimum == 1 && current.maximum == 1;
+			}
+			case Node::BEGIN:
+			{
+				anchored = true;
+				return true;
+			}
+			case Node::EMPTY:
+			{
+				return true;
+			}
+			default:
+			{
+				return false;
+			}
+			}
+		}
+		int  addState(State::Type type, int out, int out1, std::size_t characters = 0)
+		{
+			State state = { type, out, out1, characters };
+			m_states.push_back(state);
+			return static_cast<int>(m_states.size() - 1);
+		}
+		void patch(const Fragment & fragment, int target)
+		{
+			for (const std::pair<int, int> & i : fragment.outs)
+			{
+				(i.second ? m_states[i.first].out1 : m_states[i.first].out) = target;
+			}
+		}
+		Fragment compile(int node)
+		{
+			// Thompson's construction. Repetitions are expanded, so a node may be compiled more than once.
+			if (m_states.size() > 100000)
+			{
+				fail("pattern is too large");
+			}
+			const Node & current = m_nodes[node];
+			switch (current.type)
+			{
+			case Node::CHARACTERS:
+			{
+				m_characterSets.push_back(current.characters);
+				int state = addState(State::CHARACTERS, -1, -1, m_characterSets.size() - 1);
+				return Fragment{ state, { { state, 0 } } };
+			}
+			case Node::BEGIN:
+			case Node::END:
+			case Node::EMPTY:
+			{
+				int state = addState(current.type == Node::BEGIN ? State::BEGIN : current.type == Node::END ? State::END : State::JUMP, -1, -1);
+				return Fragment{ state, { { state, 0 } } };
+			}
+			case Node::CONCATENATE:
+			{
+				Fragment result = compile(current.children.front());
+				for (std::size_t i = 1; i < current.children.size(); ++i)
+				{
+					Fragment next = compile(current.children[i]);
+					patch(result, next.start);
+					result.outs = std::move(next.outs);
+				}
+				return result;
+			}
+			case Node::ALTERNATE:
+			{
+				Fragment result = compile(current.children.back());
+				for (std::size_t i = current.children.size() - 1; i-- > 0;)
+				{
+					Fragment branch = compile(current.children[i]);
+					int split = addState(State::SPLIT, branch.start, result.start);
+					branch.outs.insert(branch.outs.end(), result.outs.begin(), result.outs.end());
+					result = Fragment{ split, std::move(branch.outs) };
+				}
+				return result;
+			}
+			case Node::REPEAT:
+			{
+				int child = current.children.front();
+				Fragment result{ addState(State::JUMP, -1, -1), {} };
+				result.outs.push_back({ result.start, 0 });
+				for (int i = 0; i < current.minimum; ++i)
+				{
+					Fragment next = compile(child);
+					patch(result, next.start);
+					result.outs = std::move(next.outs);
+				}
+				if (current.maximum == -1)
+				{
+					Fragment loop = compile(child);
+					int split = addState(State::SPLIT, loop.start, -1);
+					patch(loop, split);
+					patch(result, split);
+					result.outs.assign(1, { split, 1 });
+				}
+				else
+				{
+					for (int i = current.minimum; i < current.maximum; ++i)
+					{
+						Fragment optional = compile(child);
+						int split = addState(State::SPLIT, optional.start, -1);
+						patch(result, split);
+						result.outs = std::move(optional.outs);
+						result.outs.push_back({ split, 1 });
+					}
+				}
+				return result;
+			}
+			}
+			fail("internal error");
+		}
+	};
+
+	class RegexMatcher final
+	{
+	private:
+		struct DfaState
+		{
+			std::vector<int>    states;
+			bool                accepting;
+			bool                acceptingAtEnd;
+			std::array<int, 256> next;
+		};
+
+		std::shared_ptr<const RegexProgram> m_program;
+		std::vector<DfaState>               m_dfa;
+		std::map<std::vector<int>, int>     m_lookup;
+		std::vector<int>                    m_unanchoredStart;
+		int                                 m_initial;
+
+		static const std::size_t            s_maximumDfaStates = 2048;
+	public:
+		explicit RegexMatcher(std::shared_ptr<const RegexProgram> program) : m_program(std::move(program)), m_initial(-1)
+		{
+			// Creates a matcher for a compiled program. Matchers cache DFA states as they are discovered,
+			// so a matcher must not be shared between threads; the program it was created from can be.
+			m_unanchoredStart = m_program->closure(std::vector<int>(1, m_program->getStart()), false);
+			reset();
+		}
+		bool search(const char * first, const char * last)
+		{
+			// Returns true if any part of [first, last) matches the pattern
+			std::string_view line(first, last - first);
+			const std::string & prefix = m_program->getLiteralPrefix();
+			if (!prefix.empty() && line.find(prefix) == std::string_view::npos)
+			{
+				return false;
+			}
+			if (m_program->isLiteral())
+			{
+				return true;
+			}
+			if (first == last)
+			{
+				return m_program->matchesEmptyLine();
+			}
+			int current = m_initial;
+			while (first != last)
+			{
+				if (m_dfa[current].accepting)
+				{
+					return true;
+				}
+				unsigned char ch = static_cast<unsigned char>(*first++);
+				int next = m_dfa[current].next[ch];
+				if (next < 0)
+				{
+					next = computeNext(current, ch);
+				}
+				current = next;
+				if (m_dfa[current].states.empty())
+				{
+					return false;
+				}
+			}
+			return m_dfa[current].acceptingAtEnd;
+		}
+		bool search(std::string_view line)
+		{
+			// Returns true if any part of 'line' matches the pattern
+			return search(line.data(), line.data() + line.size());
+		}
+	private:
+		void reset()
+		{
+			m_dfa.clear();
+			m_lookup.clear();
+			m_initial = addDfaState(m_program->closure(std::vector<int>(1, m_program->getStart()), true));
+		}
+		int  addDfaState(std::vector<int> && states)
+		{
+			auto found = m_lookup.find(states);
+			if (found != m_lookup.end())
+			{
+				return found->second;
+			}
+			DfaState state;
+			state.accepting = false;
+			for (int i : states)
+			{
+				if (m_program->getStates()[i].type == RegexProgram::State::MATCH)
+				{
+					state.accepting = true;
+				}
+			}
+			state.acceptingAtEnd = m_program->closureMatchesAtEnd(states);
+			state.next.fill(-1);
+			state.states = std::move(states);
+			m_dfa.push_back(std::move(state));
+			m_lookup.emplace(m_dfa.back().states, static_cast<int>(m_dfa.size() - 1));
+			return static_cast<int>(m_dfa.size() - 1);
+		}
+		int  computeNext(int current, unsigned char ch)
+		{
+			// Builds the DFA state reached from 'current' on 'ch'. If the cache has grown too large it is
+			// flushed first, which keeps memory bounded for patterns whose DFA would otherwise explode.
+			const std::vector<RegexProgram::State> & states = m_program->getStates();
+			std::vector<int> seeds;
+			for (int i : m_dfa[current].states)
+			{
+				if (states[i].type == RegexProgram::State::CHARACTERS && m_program->getCharacterSet(states[i].characters).test(ch))
+				{
+					seeds.push_back(states[i].out);
+				}
+			}
+			seeds.insert(seeds.end(), m_unanchoredStart.begin(), m_unanchoredStart.end());
+			std::vector<int> target = m_program->closure(seeds, false);
+			if (m_dfa.size() >= s_maximumDfaStates && m_lookup.find(target) == m_lookup.end())
+			{
+				reset();
+				return addDfaState(std::move(target));
+			}
+			int next = addDfaState(std::move(target));
+			m_dfa[current].next[ch] = next;
+			return next;
+		}
+	};
+
+	namespace FWPF // FileWrapperPrivateFunctions
+	{
+		// The compiled program for a pattern and the matchers made for it that aren't in use. Matchers keep the
+		// DFA states they've found, so lending them out again saves each call building the DFA from scratch.
+		class RegexMatcherPool final
+		{
+		private:
+			std::shared_ptr<const RegexProgram>        m_program;
+			std::vector<std::unique_ptr<RegexMatcher>> m_idle;
+			std::mutex                                 m_mutex;
+		public:
+			explicit RegexMatcherPool(const std::string & pattern) : m_program(std::make_shared<const RegexProgram>(pattern))
+			{
+			}
+			const std::shared_ptr<const RegexProgram> & getProgram() const
+			{
+				return m_program;
+			}
+			std::unique_ptr<RegexMatcher> acquire()
+			{
+				// Returns a matcher that isn't in use, making a new one if there is none
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+					if (!m_idle.empty())
+					{
+						std::unique_ptr<RegexMatcher> matcher = std::move(m_idle.back());
+						m_idle.pop_back();
+						return matcher;
+					}
+				}
+				return std::make_unique<RegexMatcher>(m_program);
+			}
+			void release(std::unique_ptr<RegexMatcher> matcher)
+			{
+				// Keeps a matcher for later, unless there are already as many as there are threads
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (m_idle.size() < getThreadCount())
+				{
+					m_idle.push_back(std::move(matcher));
+				}
+			}
+		};
+
+		// Borrows a matcher from a pool for as long as it lives, and gives it back with its DFA states
+		class CachedRegexMatcher final
+		{
+		private:
+			std::shared_ptr<RegexMatcherPool> m_pool;
+			std::unique_ptr<RegexMatcher>     m_matcher;
+		public:
+			explicit CachedRegexMatcher(std::shared_ptr<RegexMatcherPool> pool) : m_pool(std::move(pool)), m_matcher(m_pool->acquire())
+			{
+			}
+			CachedRegexMatcher(const CachedRegexMatcher &) = delete;
+			CachedRegexMatcher & operator = (const CachedRegexMatcher &) = delete;
+			~CachedRegexMatcher()
+			{
+				m_pool->release(std::move(m_matcher));
+			}
+			bool search(std::string_view line)
+			{
+				return m_matcher->search(line);
+			}
+		};
+
+		inline std::shared_ptr<RegexMatcherPool> getRegexPool(const std::string & pattern)
+		{
+			// Returns the pool for 'pattern', compiling the pattern only the first time it is seen. Up to 64
+			// patterns are kept; past that the one used least recently is dropped to make room. Matchers
+			// borrowed from a dropped pool keep it alive until they're given back.
+			static std::mutex mutex;
+			static std::map<std::string, std::pair<std::shared_ptr<RegexMatcherPool>, std::uint64_t>> cache;
+			static std::uint64_t uses = 0;
+			std::lock_guard<std::mutex> lock(mutex);
+			++uses;
+			auto found = cache.find(pattern);
+			if (found != cache.end())
+			{
+				found->second.second = uses;
+				return found->second.first;
+			}
+			std::shared_ptr<RegexMatcherPool> pool = std::make_shared<RegexMatcherPool>(pattern);
+			if (cache.size() >= 64)
+			{
+				cache.erase(std::min_element(cache.begin(), cache.end(), [](const auto & lhs, const auto & rhs)
+				{
+					return lhs.second.second < rhs.second.second;
+				}));
+			}
+			cache.emplace(pattern, std::make_pair(pool, uses));
+			return pool;
+		}
+
+		inline std::shared_ptr<const RegexProgram> getCachedRegex(const std::string & pattern)
+		{
+			// Returns the compiled program for 'pattern' from the pattern cache
+			return getRegexPool(pattern)->getProgram();
+		}
+
+		template <typename IteratorType>
+		std::size_t findFirstMatch(IteratorType first, IteratorType last, const std::string & pattern, ExecutionMode mode)
+		{
+			// Returns the index of the first line in [first, last) matching 'pattern', or last - first if there is none
+			std::shared_ptr<RegexMatcherPool> pool = getRegexPool(pattern);
+			std::size_t count = last - first;
+			std::atomic<std::size_t> best(count);
+			parallelForChunks(count, getChunkCount(count, mode), [&](std::size_t, std::size_t lower, std::size_t upper)
+			{
+				CachedRegexMatcher matcher(pool);
+				for (std::size_t i = lower; i < upper && i < best.load(std::memory_order_relaxed); ++i)
+				{
+					if (matcher.search(*(first + i)))
+					{
+						std::size_t current = best.load();
+						while (i < current && !best.compare_exchange_weak(current, i));
+						return;
+					}
+				}
+			});
+			return best;
+		}
+
+		template <typename IteratorType>
+		std::vector<char> markMatches(IteratorType first, IteratorType last, const std::string & pattern, ExecutionMode mode)
+		{
+			// Returns one flag per line in [first, last), set when the line matches 'pattern'
+			std::shared_ptr<RegexMatcherPool> pool = getRegexPool(pattern);
+			std::size_t count = last - first;
+			std::vector<char> result(count, 0);
+			parallelForChunks(count, getChunkCount(count, mode), [&](std::size_t, std::size_t lower, std::size_t upper)
+			{
+				CachedRegexMatcher matcher(pool);
+				for (std::size_t i = lower; i < upper; ++i)
+				{
+					result[i] = matcher.search(*(first + i));
+				}
+			});
+			return result;
+		}
+	}
+
+	inline std::shared_ptr<const RegexProgram> compileRegex(const std::string & pattern)
+	{
+		// Returns a compiled program for 'pattern' from the shared pattern cache
+		return FWPF::getCachedRegex(pattern);
+	}
+
+	inline bool matchesRegex(const std::string & str, const std::string & pattern)
+	{
+		// Returns true if any part of 'str' matches 'pattern'
+		return FWPF::CachedRegexMatcher(FWPF::getRegexPool(pattern)).search(str);
+	}
+}
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace sp
+{
+	// A vector that keeps its first N elements inside the object itself and only allocates beyond that.
+	// It's meant for short lists of trivially copyable values that are filled and cleared over and over,
+	// such as the fields of a line: clear() keeps whatever capacity was reached, so reusing one SmallVector
+	// across lines stops allocating after the first few.
+	template <typename T, std::size_t N>
+	class SmallVector
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "SmallVector only holds trivially copyable types");
+		static_assert(N > 0, "SmallVector needs room for at least one element");
+	private:
+		alignas(T) unsigned char m_storage[sizeof(T) * N];
+		T *         m_data;
+		std::size_t m_size;
+		std::size_t m_capacity;
+	public:
+		typedef T                                     value_type;
+		typedef T *                                   iterator;
+		typedef const T *                             const_iterator;
+		typedef std::reverse_iterator<iterator>       reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+		SmallVector() : m_data(inlineData()), m_size(0), m_capacity(N)
+		{
+		}
+		SmallVector(const SmallVector & rhs) : SmallVector()
+		{
+			reserve(rhs.m_size);
+			copyElements(m_data, rhs.m_data, rhs.m_size);
+			m_size = rhs.m_size;
+		}
+		SmallVector(SmallVector && rhs) noexcept : SmallVector()
+		{
+			takeFrom(rhs);
+		}
+		~SmallVector()
+		{
+			release();
+		}
+		SmallVector & operator = (const SmallVector & rhs)
+		{
+			if (this != &rhs)
+			{
+				m_size = 0;
+				reserve(rhs.m_size);
+				copyElements(m_data, rhs.m_data, rhs.m_size);
+				m_size = rhs.m_size;
+			}
+			return *this;
+		}
+		SmallVector & operator = (SmallVector && rhs) noexcept
+		{
+			if (this != &rhs)
+			{
+				release();
+				m_data = inlineData();
+				m_size = 0;
+				m_capacity = N;
+				takeFrom(rhs);
+			}
+			return *this;
+		}
+		// Element access
+		T &         operator [] (std::size_t index)
+		{
+			// Doesn't perform any bounds checking
+			return m_data[index];
+		}
+		const T &   operator [] (std::size_t index) const
+		{
+			// Doesn't perform any bounds checking
+			return m_data[index];
+		}
+		T &         at(std::size_t index)
+		{
+			if (index >= m_size)
+			{
+				throw std::out_of_range("SmallVector::at");
+			}
+			return m_data[index];
+		}
+		const T &   at(std::size_t index) const
+		{
+			if (index >= m_size)
+			{
+				throw std::out_of_range("SmallVector::at");
+			}
+			return m_data[index];
+		}
+		T &         front()
+		{
+			return m_data[0];
+		}
+		const T &   front() const
+		{
+			return m_data[0];
+		}
+		T &         back()
+		{
+			return m_data[m_size - 1];
+		}
+		const T &   back() const
+		{
+			return m_data[m_size - 1];
+		}
+		T *         data()
+		{
+			return m_data;
+		}
+		const T *   data() const
+		{
+			return m_data;
+		}
+		// Iterators
+		iterator               begin()
+		{
+			return m_data;
+		}
+		const_iterator         begin() const
+		{
+			return m_data;
+		}
+		const_iterator         cbegin() const
+		{
+			return m_data;
+		}
+		iterator               end()
+		{
+			return m_data + m_size;
+		}
+		const_iterator         end() const
+		{
+			return m_data + m_size;
+		}
+		const_iterator         cend() const
+		{
+			return m_data + m_size;
+		}
+		reverse_iterator       rbegin()
+		{
+			return reverse_iterator(end());
+		}
+		const_reverse_iterator rbegin() const
+		{
+			return const_reverse_iterator(end());
+		}
+		reverse_iterator       rend()
+		{
+			return reverse_iterator(begin());
+		}
+		const_reverse_iterator rend() const
+		{
+			return const_reverse_iterator(begin());
+		}
+		// Capacity
+		bool        empty() const
+		{
+			return m_size == 0;
+		}
+		std::size_t size() const
+		{
+			return m_size;
+		}
+		std::size_t capacity() const
+		{
+			return m_capacity;
+		}
+		bool        isInline() const
+		{
+			// Returns true while the elements are stored inside the object rather than on the heap
+			return m_data == inlineData();
+		}
+		void        reserve(std::size_t capacity)
+		{
+			// Makes room for at least 'capacity' elements
+			if (capacity > m_capacity)
+			{
+				T * data = std::allocator<T>().allocate(capacity);
+				copyElements(data, m_data, m_size);
+				release();
+				m_data = data;
+				m_capacity = capacity;
+			}
+		}
+		// Modifiers
+		void        clear()
+		{
+			// Removes every element but keeps the capacity
+			m_size = 0;
+		}
+		void        push_back(const T & value)
+		{
+			if (m_size == m_capacity)
+			{
+				T copy = value; // 'value' may be one of the elements
+				grow();
+				new (m_data + m_size) T(copy);
+			}
+			else
+			{
+				new (m_data + m_size) T(value);
+			}
+			++m_size;
+		}
+		template <typename... Args>
+		T &         emplace_back(Args &&... args)
+		{
+			T value(std::forward<Args>(args)...);
+			push_back(value);
+			return back();
+		}
+		void        pop_back()
+		{
+			--m_size;
+		}
+		void        resize(std::size_t size)
+		{
+			// Grows with value-initialised elements or shrinks to 'size' elements
+			reserve(size);
+			for (std::size_t i = m_size; i < size; ++i)
+			{
+				new (m_data + i) T();
+			}
+			m_size = size;
+		}
+	private:
+		T *         inlineData()
+		{
+			return reinterpret_cast<T *>(m_storage);
+		}
+		const T *   inlineData() const
+		{
+			return reinterpret_cast<const T *>(m_storage);
+		}
+		void        grow()
+		{
+			reserve(m_capacity * 2);
+		}
+		void        release()
+		{
+			if (!isInline())
+			{
+				std::allocator<T>().deallocate(m_data, m_capacity);
+			}
+		}
+		void        takeFrom(SmallVector & rhs)
+		{
+			// Steals the heap buffer of rhs, or copies its inline elements, and leaves rhs empty
+			if (rhs.isInline())
+			{
+				copyElements(m_data, rhs.m_data, rhs.m_size);
+			}
+			else
+			{
+				m_data = rhs.m_data;
+				m_capacity = rhs.m_capacity;
+				rhs.m_data = rhs.inlineData();
+				rhs.m_capacity = N;
+			}
+			m_size = rhs.m_size;
+			rhs.m_size = 0;
+		}
+		static void copyElements(T * destination, const T * source, std::size_t count)
+		{
+			if (count)
+			{
+				std::memcpy(static_cast<void *>(destination), static_cast<const void *>(source), count * sizeof(T));
+			}
+		}
+	};
+}
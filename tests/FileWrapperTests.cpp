@@ -0,0 +1,79 @@
+// Tests for FileWrapper. Build from the repository root with
+//     g++ -std=c++17 -I. tests/FileWrapperTests.cpp -o FileWrapperTests
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "FileWrapper.hpp"
+
+int main()
+{
+	{
+		// Moving a wrapper into itself leaves it as it was
+		sp::FileWrapper wrapper;
+		wrapper.appendLine("first");
+		wrapper.appendLine("second");
+		wrapper.setFilename("selfMove.txt");
+		wrapper.setClosingAction(sp::FileCloseAction::OUTPUT);
+		sp::FileWrapper & self = wrapper;
+		wrapper = std::move(self);
+		assert(wrapper.size() == 2 && wrapper.getFirstLine() == "first" && wrapper.getLastLine() == "second");
+		assert(wrapper.getFilename() == "selfMove.txt");
+		assert(wrapper.getClosingAction() == sp::FileCloseAction::OUTPUT);
+		wrapper.setClosingAction(sp::FileCloseAction::NONE);
+	}
+	{
+		// Moving from another wrapper takes its lines and closing action, and leaves it with none
+		sp::FileWrapper source;
+		source.appendLine("line");
+		source.setClosingAction(sp::FileCloseAction::APPEND);
+		sp::FileWrapper destination;
+		destination = std::move(source);
+		assert(destination.size() == 1 && destination.getFirstLine() == "line");
+		assert(destination.getClosingAction() == sp::FileCloseAction::APPEND);
+		assert(source.getClosingAction() == sp::FileCloseAction::NONE);
+		destination.setClosingAction(sp::FileCloseAction::NONE);
+	}
+	{
+		// A pmr::FileWrapper takes any string, copying it into a line that uses the wrapper's allocator
+		std::pmr::monotonic_buffer_resource resource;
+		sp::pmr::FileWrapper wrapper(&resource);
+		std::string str = "std::string";
+		wrapper.appendLine(str);
+		wrapper.appendLine(std::string("temporary"));
+		wrapper.appendLine("literal");
+		wrapper.appendLine(std::pmr::string("pmr"));
+		wrapper.setLine(1, std::string("set"));
+		wrapper.prependLine(std::string_view("first"));
+		wrapper.insertLine(1, str + "!");
+		assert(wrapper.size() == 6 && wrapper[0] == "first" && wrapper[1] == "std::string!" && wrapper[3] == "set");
+		assert(wrapper[5] == "pmr" && wrapper[1].get_allocator().resource() == &resource);
+		// So do the string functions, whose results are copied back into the lines
+		wrapper.applyFunctionToContents(sp::convertToUpperCase);
+		wrapper.applyFunctionToLine(0, sp::removeCharacter, 'I');
+		wrapper.applyFunctionToLines(1, 2, sp::replaceCharacter, ':', '-');
+		wrapper.applyFunctionToLine(5, [](std::string_view line) { return std::string(line) + "?"; });
+		wrapper.applyFunctionToLine(4, [](const sp::pmr::FileWrapper::Line & line) { return line + "."; });
+		assert(wrapper[0] == "FRST" && wrapper[1] == "STD--STRING!" && wrapper[2] == "STD--STRING" && wrapper[4] == "LITERAL." && wrapper[5] == "PMR?");
+		assert(wrapper[0].get_allocator().resource() == &resource);
+	}
+	{
+		// A file starting with short lines doesn't make loading reserve room for far more lines than it holds
+		const std::string filename = "FileWrapperTests.txt";
+		{
+			std::ofstream file(filename, std::ios::binary);
+			file << std::string(sp::FWPF::maximumReservedLines - 1, '\n') << std::string(std::size_t(16) << 20, 'x') << '\n';
+		}
+		sp::FileWrapper wrapper(filename);
+		assert(wrapper.size() == sp::FWPF::maximumReservedLines && wrapper.getLastLine().size() == std::size_t(16) << 20);
+		assert(wrapper.getContents().capacity() == sp::FWPF::maximumReservedLines);
+		std::remove(filename.c_str());
+	}
+	std::cout << "FileWrapper tests passed\n";
+}
@@ -0,0 +1,54 @@
+// Tests for Tokenizer. Build from the repository root with
+//     g++ -std=c++17 -I. tests/FormattingFunctionsTests.cpp -o FormattingFunctionsTests
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "FormattingFunctions.hpp"
+
+static std::vector<std::string> splitSlowly(const std::string & line, const std::string & separator)
+{
+	// Splits 'line' at every occurrence of 'separator', keeping the empty last field
+	std::vector<std::string> result;
+	std::size_t fieldStart = 0;
+	for (std::size_t found; (found = line.find(separator, fieldStart)) != std::string::npos; fieldStart = found + separator.size())
+	{
+		result.push_back(line.substr(fieldStart, found - fieldStart));
+	}
+	result.push_back(line.substr(fieldStart));
+	return result;
+}
+
+int main()
+{
+	std::mt19937 generator(3);
+	const char alphabet[] = "ab,:;";
+	for (const std::string separator : { ",", ":", "::", ":;:" })
+	{
+		sp::Tokenizer tokenizer(separator);
+		sp::Tokenizer::Fields fields;
+		for (int i = 0; i < 20000; ++i)
+		{
+			std::string line;
+			for (std::size_t length = 1 + generator() % 100; line.size() < length;)
+			{
+				line += alphabet[generator() % (sizeof(alphabet) - 1)];
+			}
+			std::vector<std::string> expected = splitSlowly(line, separator);
+			assert(tokenizer.split(line, fields) == expected.size());
+			for (std::size_t j = 0; j < expected.size(); ++j)
+			{
+				assert(fields[j] == expected[j]);
+			}
+		}
+	}
+	sp::Tokenizer::Fields fields;
+	sp::Tokenizer quoted(',');
+	quoted.setQuote('"');
+	quoted.split(R"(1,"a,b","he said ""hi""",x)", fields);
+	assert(fields.size() == 4 && fields[1] == "a,b" && quoted.unquote(fields[2]) == R"(he said "hi")" && fields[3] == "x");
+	std::cout << "FormattingFunctions tests passed\n";
+}
@@ -0,0 +1,69 @@
+// Tests for InternedFileWrapper. Build from the repository root with
+//     g++ -std=c++17 -pthread -I. tests/InternedFileWrapperTests.cpp -o InternedFileWrapperTests
+
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "InternedFileWrapper.hpp"
+
+int main()
+{
+	sp::InternedFileWrapper original;
+	for (int i = 0; i < 1000; ++i)
+	{
+		original.appendLine("line " + std::to_string(i % 10));
+	}
+	assert(original.getPool()->size() == 10 && original.linesAreEqual(0, 10));
+	{
+		// A copy gets a pool of its own, so both can be changed on different threads at once
+		sp::InternedFileWrapper copy(original);
+		assert(copy == original && copy.getPool() != original.getPool() && copy.getPool()->size() == 10);
+		std::thread thread([&copy]()
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				copy.appendToLine(i, "a");
+			}
+		});
+		for (int i = 0; i < 1000; ++i)
+		{
+			original.appendToLine(i, "b");
+		}
+		thread.join();
+		assert(copy.getLine(3) == "line 3a" && original.getLine(3) == "line 3b");
+		assert(original.getPool()->size() == 20 && copy.getPool()->size() == 20);
+	}
+	{
+		// Sharing a pool has to be asked for, and then the lines are shared too
+		sp::InternedFileWrapper shared(original, original.getPool());
+		assert(shared.getPool() == original.getPool() && shared.cbegin()[5] == original.cbegin()[5]);
+		sp::InternedFileWrapper assigned;
+		assigned = shared;
+		assert(assigned == original && assigned.getPool() != original.getPool());
+	}
+	{
+		// Removed lines stay in the pool until it's compacted
+		sp::InternedFileWrapper file(original);
+		file.removeLines(0, 899);
+		assert(file.size() == 100 && file.getPool()->size() == 10);
+		file.clearContents();
+		assert(file.getPool()->size() == 10);
+		file.compact();
+		assert(file.getPool()->size() == 0);
+	}
+	{
+		// Moving takes the pool along, leaving the moved-from object with an empty one of its own
+		sp::InternedFileWrapper source(original);
+		std::shared_ptr<sp::StringPool> pool = source.getPool();
+		sp::InternedFileWrapper destination(std::move(source));
+		assert(destination.getPool() == pool && destination == original);
+		assert(source.empty() && source.getPool() != pool && source.getPool()->size() == 0);
+		sp::InternedFileWrapper & self = destination;
+		destination = std::move(self);
+		assert(destination == original && destination.getPool() == pool);
+	}
+	std::cout << "InternedFileWrapper tests passed\n";
+}
@@ -0,0 +1,80 @@
+// Tests for the binary formats of NumericFile. Build from the repository root with
+//     g++ -std=c++17 -pthread -I. tests/NumericBinaryTests.cpp -o NumericBinaryTests
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "NumericFile.hpp"
+
+using namespace fileFunctions;
+
+static void writeNpy(const std::string & filePath, std::size_t rows, std::size_t columns, std::size_t valueCount)
+{
+	// Writes a .npy header claiming (rows, columns) followed by 'valueCount' values
+	std::ofstream file(filePath, std::ios::binary);
+	std::string header = NFPF::makeNpyHeader(rows, columns);
+	file.write(header.data(), static_cast<std::streamsize>(header.size()));
+	for (std::size_t i = 0; i < valueCount; ++i)
+	{
+		double value = static_cast<double>(i);
+		file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+}
+
+int main()
+{
+	const std::string filePath = "NumericBinaryTests.npy";
+	NumericFile file;
+	{
+		// Rectangular files round-trip through .npy, ragged ones through the ragged format
+		for (int i = 0; i < 5; ++i)
+		{
+			file.appendLineToFile(NumericLine{i + 0.5, i + 1.5, i + 2.5});
+		}
+		NumericFile loaded;
+		assert(file.outputToBinaryFile(filePath) && loaded.loadFromBinaryFile(filePath));
+		assert(loaded.getFileContents() == file.getFileContents());
+		file.appendLineToFile(NumericLine{});
+		assert(file.outputToBinaryFile(filePath) && loaded.loadFromBinaryFile(filePath));
+		assert(loaded.getFileContents() == file.getFileContents());
+	}
+	{
+		// Files of empty lines only round-trip too
+		NumericFile empty;
+		for (int i = 0; i < 4; ++i)
+		{
+			empty.appendLineToFile(NumericLine{});
+		}
+		NumericFile loaded;
+		assert(empty.outputToBinaryFile(filePath) && loaded.loadFromBinaryFile(filePath));
+		assert(loaded.size() == 4 && loaded.getFileContents() == empty.getFileContents());
+	}
+	{
+		// Shapes the data in the file can't hold are rejected before anything is allocated, with or without columns
+		NumericFile loaded;
+		writeNpy(filePath, 4, 3, 11);
+		assert(!loaded.loadFromBinaryFile(filePath) && loaded.size() == 0);
+		writeNpy(filePath, 4, 3, 12);
+		assert(loaded.loadFromBinaryFile(filePath) && loaded.size() == 4 && loaded.getEntry(3, 2) == 11);
+		writeNpy(filePath, std::size_t(1) << 62, 0, 0);
+		assert(!loaded.loadFromBinaryFile(filePath) && loaded.size() == 0);
+		writeNpy(filePath, std::size_t(1) << 40, 0, 16);
+		assert(!loaded.loadFromBinaryFile(filePath));
+		writeNpy(filePath, std::size_t(1) << 61, 4, 16);
+		assert(!loaded.loadFromBinaryFile(filePath));
+	}
+	{
+		// So are header lengths longer than the file, before the header is read
+		NumericFile loaded;
+		for (const char version : { '\x01', '\x02', '\x03' })
+		{
+			std::ofstream(filePath, std::ios::binary) << "\x93NUMPY" << version << '\0' << "\xff\xff\xff\xff";
+			assert(!loaded.loadFromBinaryFile(filePath) && loaded.size() == 0);
+		}
+	}
+	std::remove(filePath.c_str());
+	std::cout << "NumericBinary tests passed\n";
+}
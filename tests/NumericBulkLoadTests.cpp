@@ -0,0 +1,169 @@
+// Tests for NumericFile::bulkLoadFromFile: lines split across threads and across read blocks must be joined
+// back into the same lines as loadFromFile gives on the same data, with or without a final newline, with
+// CRLF line endings, and with tokens that aren't numbers. Build from the repository root with
+//     g++ -std=c++17 -pthread -I. tests/NumericBulkLoadTests.cpp -o NumericBulkLoadTests
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "NumericFile.hpp"
+
+using namespace fileFunctions;
+
+typedef std::vector<NumericLine> Lines;
+
+static Lines makeLines(std::size_t count, std::size_t maximumLength, unsigned seed)
+{
+	// 'count' lines of 1 to 'maximumLength' values, none of them blank so that loadFromFile keeps every one
+	std::mt19937_64 generator(seed);
+	std::uniform_int_distribution<std::size_t> length(1, maximumLength);
+	std::uniform_real_distribution<double> value(-1e6, 1e6);
+	Lines lines(count);
+	for (NumericLine & line : lines)
+	{
+		line.resize(length(generator));
+		for (double & i : line)
+		{
+			i = value(generator);
+		}
+	}
+	return lines;
+}
+
+static void writeLines(const std::string & filePath, const Lines & lines, const std::string & newline, bool finalNewline, const std::string & badToken = std::string())
+{
+	// Writes every value with enough digits to be read back exactly. A non-empty 'badToken' is written
+	// in the middle of every hundredth line.
+	std::ofstream file(filePath, std::ios::out | std::ios::binary);
+	char text[32];
+	for (std::size_t i = 0; i < lines.size(); ++i)
+	{
+		for (std::size_t j = 0; j < lines[i].size(); ++j)
+		{
+			std::snprintf(text, sizeof(text), "%.17g", lines[i][j]);
+			file << (j ? " " : "") << text;
+			if (!badToken.empty() && i % 100 == 0 && j == lines[i].size() / 2)
+			{
+				file << ' ' << badToken;
+			}
+		}
+		if (finalNewline || i + 1 < lines.size())
+		{
+			file << newline;
+		}
+	}
+}
+
+static Lines contentsOf(const NumericFile & file)
+{
+	Lines lines;
+	for (std::size_t i = 0; i < file.size(); ++i)
+	{
+		lines.push_back(file.getLine(i));
+	}
+	return lines;
+}
+
+static Lines reference(const std::string & filePath)
+{
+	// The lines loadFromFile gives, without the empty line it leaves after a final newline
+	NumericFile file;
+	file.loadFromFile(filePath);
+	Lines lines = contentsOf(file);
+	if (!lines.empty() && lines.back().empty())
+	{
+		lines.pop_back();
+	}
+	return lines;
+}
+
+static void checkBulkLoad(const std::string & filePath, const Lines & expected, bool valid)
+{
+	// Sequentially, and in parallel with chunks of at least 1 MiB split at different places
+	NumericFile file;
+	sp::setThreadCount(1);
+	assert(file.bulkLoadFromFile(filePath) == valid);
+	assert(contentsOf(file) == expected);
+	for (unsigned threads : { 3u, 8u })
+	{
+		sp::setThreadCount(threads);
+		assert(file.bulkLoadFromFile(filePath, ExecutionMode::PARALLEL) == valid);
+		assert(contentsOf(file) == expected);
+	}
+	sp::setThreadCount(1);
+}
+
+int main()
+{
+	const std::string lfPath = "NumericBulkLoadTests.lf.txt";
+	const std::string crlfPath = "NumericBulkLoadTests.crlf.txt";
+	// About 4 MiB, so that the parallel parse has several chunks
+	Lines lines = makeLines(40000, 10, 1);
+	for (bool finalNewline : { true, false })
+	{
+		writeLines(lfPath, lines, "\n", finalNewline);
+		Lines expected = reference(lfPath);
+		assert(expected == lines);
+		checkBulkLoad(lfPath, expected, true);
+		// loadFromFile doesn't end lines at CRLF, so the LF file is the reference
+		writeLines(crlfPath, lines, "\r\n", finalNewline);
+		checkBulkLoad(crlfPath, expected, true);
+	}
+	{
+		// A line of about 2 MiB spans several chunk boundaries, and there's no newline after the last line
+		Lines longLines = makeLines(2000, 10, 2);
+		longLines[1000] = makeLines(1, 100000, 3)[0];
+		longLines[1000].resize(100000, 0.5);
+		longLines.back() = longLines[1000];
+		writeLines(lfPath, longLines, "\n", false);
+		Lines expected = reference(lfPath);
+		assert(expected == longLines);
+		checkBulkLoad(lfPath, expected, true);
+		writeLines(crlfPath, longLines, "\r\n", false);
+		checkBulkLoad(crlfPath, expected, true);
+	}
+	{
+		// Tokens that aren't numbers are skipped, lines are kept, and the load says it wasn't clean
+		for (const std::string badToken : { "abc", "1.5x", "--2", "+" })
+		{
+			writeLines(lfPath, lines, "\n", true, badToken);
+			checkBulkLoad(lfPath, lines, false);
+			writeLines(crlfPath, lines, "\r\n", false, badToken);
+			checkBulkLoad(crlfPath, lines, false);
+		}
+	}
+	{
+		// Over 64 MiB, so that it's read in more than one block and lines are carried across the boundary
+		Lines manyLines = makeLines(1, 10, 4);
+		Lines block = makeLines(1000, 20, 5);
+		while (manyLines.size() < 400000)
+		{
+			manyLines.insert(manyLines.end(), block.begin(), block.end());
+		}
+		writeLines(lfPath, manyLines, "\n", false);
+		std::ifstream size(lfPath, std::ios::binary | std::ios::ate);
+		assert(size.tellg() > (std::streamoff(64) << 20));
+		size.close();
+		NumericFile file;
+		assert(file.bulkLoadFromFile(lfPath));
+		assert(contentsOf(file) == manyLines);
+		writeLines(crlfPath, manyLines, "\r\n", true);
+		sp::setThreadCount(3);
+		assert(file.bulkLoadFromFile(crlfPath, ExecutionMode::PARALLEL));
+		assert(contentsOf(file) == manyLines);
+		sp::setThreadCount(1);
+	}
+	{
+		NumericFile file;
+		assert(!file.bulkLoadFromFile("NumericBulkLoadTests.missing.txt"));
+		assert(file.size() == 0);
+	}
+	std::remove(lfPath.c_str());
+	std::remove(crlfPath.c_str());
+	std::cout << "NumericBulkLoad tests passed\n";
+}
@@ -0,0 +1,196 @@
+// Tests for NumericFileStream: with small blocks, lines split across blocks (or longer than a block) must be
+// joined back into the same lines as NumericFile loads from the same data, with or without a final newline,
+// with CRLF line endings, and with tokens that aren't numbers. Build from the repository root with
+//     g++ -std=c++17 -pthread -I. tests/NumericFileStreamTests.cpp -o NumericFileStreamTests
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "NumericFileStream.hpp"
+
+using namespace fileFunctions;
+
+typedef std::vector<NumericLine> Lines;
+
+static const std::size_t smallBlock = 4096;
+
+static Lines makeLines(std::size_t count, std::size_t maximumLength, unsigned seed)
+{
+	// 'count' lines of 1 to 'maximumLength' values, none of them blank so that loadFromFile keeps every one
+	std::mt19937_64 generator(seed);
+	std::uniform_int_distribution<std::size_t> length(1, maximumLength);
+	std::uniform_real_distribution<double> value(-1e6, 1e6);
+	Lines lines(count);
+	for (NumericLine & line : lines)
+	{
+		line.resize(length(generator));
+		for (double & i : line)
+		{
+			i = value(generator);
+		}
+	}
+	return lines;
+}
+
+static void writeLines(const std::string & filePath, const Lines & lines, const std::string & newline, bool finalNewline, const std::string & badToken = std::string())
+{
+	// Writes every value with enough digits to be read back exactly. A non-empty 'badToken' is written
+	// in the middle of every tenth line.
+	std::ofstream file(filePath, std::ios::out | std::ios::binary);
+	char text[32];
+	for (std::size_t i = 0; i < lines.size(); ++i)
+	{
+		for (std::size_t j = 0; j < lines[i].size(); ++j)
+		{
+			std::snprintf(text, sizeof(text), "%.17g", lines[i][j]);
+			file << (j ? " " : "") << text;
+			if (!badToken.empty() && i % 10 == 0 && j == lines[i].size() / 2)
+			{
+				file << ' ' << badToken;
+			}
+		}
+		if (finalNewline || i + 1 < lines.size())
+		{
+			file << newline;
+		}
+	}
+}
+
+static Lines reference(const std::string & filePath)
+{
+	// The lines loadFromFile gives, without the empty line it leaves after a final newline
+	NumericFile file;
+	file.loadFromFile(filePath);
+	Lines lines;
+	for (std::size_t i = 0; i < file.size(); ++i)
+	{
+		lines.push_back(file.getLine(i));
+	}
+	if (!lines.empty() && lines.back().empty())
+	{
+		lines.pop_back();
+	}
+	return lines;
+}
+
+static Lines streamLines(NumericFileStream & stream, bool valid)
+{
+	Lines lines;
+	assert(stream.forEachLine([&lines](ConstNumericRow row)
+	{
+		lines.emplace_back(row.begin(), row.end());
+	}) == valid);
+	assert(stream.good() == valid);
+	return lines;
+}
+
+static void checkStream(const std::string & filePath, const Lines & expected, bool valid)
+{
+	// Sequentially and in parallel, with the smallest blocks so that almost every block boundary splits a line
+	for (ExecutionMode mode : { ExecutionMode::SEQUENTIAL, ExecutionMode::PARALLEL })
+	{
+		NumericFileStream stream(filePath, mode, smallBlock);
+		assert(streamLines(stream, valid) == expected);
+	}
+}
+
+int main()
+{
+	const std::string lfPath = "NumericFileStreamTests.lf.txt";
+	const std::string crlfPath = "NumericFileStreamTests.crlf.txt";
+	sp::setThreadCount(3);
+	Lines lines = makeLines(5000, 12, 1);
+	for (bool finalNewline : { true, false })
+	{
+		writeLines(lfPath, lines, "\n", finalNewline);
+		Lines expected = reference(lfPath);
+		assert(expected == lines);
+		checkStream(lfPath, expected, true);
+		// loadFromFile doesn't end lines at CRLF, so the LF file is the reference
+		writeLines(crlfPath, lines, "\r\n", finalNewline);
+		checkStream(crlfPath, expected, true);
+	}
+	{
+		// Lines several times longer than a block make the stream grow its buffers, first, in the middle and last
+		Lines longLines = makeLines(300, 12, 2);
+		for (std::size_t i : { std::size_t(0), std::size_t(150), longLines.size() - 1 })
+		{
+			longLines[i] = makeLines(1, 5000, 3 + static_cast<unsigned>(i))[0];
+			longLines[i].resize(5000, 0.25);
+		}
+		for (bool finalNewline : { true, false })
+		{
+			writeLines(lfPath, longLines, "\n", finalNewline);
+			Lines expected = reference(lfPath);
+			assert(expected == longLines);
+			checkStream(lfPath, expected, true);
+			writeLines(crlfPath, longLines, "\r\n", finalNewline);
+			checkStream(crlfPath, expected, true);
+		}
+	}
+	{
+		// A first line of every length around the block size, so that the end of the first block falls
+		// before, on and after its '\r' and '\n'. n zeros take 2n - 1 characters, a 10 in front one more.
+		Lines alignedLines = makeLines(200, 12, 4);
+		for (std::size_t length = smallBlock - 4; length <= smallBlock + 4; ++length)
+		{
+			alignedLines[0].assign((length + 1) / 2, 0);
+			alignedLines[0][0] = length % 2 ? 0 : 10;
+			writeLines(lfPath, alignedLines, "\n", false);
+			std::ifstream file(lfPath, std::ios::in | std::ios::binary);
+			std::string firstLine;
+			std::getline(file, firstLine);
+			assert(firstLine.size() == length);
+			file.close();
+			assert(reference(lfPath) == alignedLines);
+			checkStream(lfPath, alignedLines, true);
+			writeLines(crlfPath, alignedLines, "\r\n", false);
+			checkStream(crlfPath, alignedLines, true);
+		}
+	}
+	{
+		// Tokens that aren't numbers are skipped, lines are kept, and the pass says it wasn't clean
+		for (const std::string badToken : { "abc", "1.5x", "--2", "+" })
+		{
+			writeLines(lfPath, lines, "\n", true, badToken);
+			checkStream(lfPath, lines, false);
+			writeLines(crlfPath, lines, "\r\n", false, badToken);
+			checkStream(crlfPath, lines, false);
+		}
+		// A clean pass afterwards is good again
+		writeLines(lfPath, lines, "\n", true);
+		writeLines(crlfPath, lines, "\r\n", true, "abc");
+		NumericFileStream stream(lfPath, ExecutionMode::SEQUENTIAL, smallBlock);
+		NumericFileStream badStream(crlfPath, ExecutionMode::SEQUENTIAL, smallBlock);
+		assert(streamLines(badStream, false) == lines);
+		assert(streamLines(stream, true) == lines);
+	}
+	{
+		// The compute functions give the same bits as NumericFile, and ranges stop reading early
+		writeLines(lfPath, lines, "\n", true);
+		writeLines(crlfPath, lines, "\r\n", false);
+		NumericFile file;
+		file.loadFromFile(lfPath);
+		NumericFileStream stream(crlfPath, ExecutionMode::SEQUENTIAL, smallBlock);
+		assert(stream.computeSumOfContents() == file.computeSumOfContents());
+		assert(stream.computeSumOfContents(SummationMode::COMPENSATED) == file.computeSumOfContents(SummationMode::COMPENSATED));
+		assert(stream.computeMinimumOfContents() == file.computeMinimumOfContents());
+		assert(stream.computeMaximumOfContents() == file.computeMaximumOfContents());
+		assert(stream.computeAverageOfLines(100, 2000) == file.computeAverageOfLines(100, 2000));
+		assert(stream.computeSumOfLine(lines.size() - 1) == file.computeSumOfLine(lines.size() - 1));
+		assert(stream.good());
+	}
+	{
+		NumericFileStream stream("NumericFileStreamTests.missing.txt", ExecutionMode::SEQUENTIAL, smallBlock);
+		assert(stream.computeSumOfContents() == 0);
+		assert(!stream.good());
+	}
+	std::remove(lfPath.c_str());
+	std::remove(crlfPath.c_str());
+	std::cout << "NumericFileStream tests passed\n";
+}
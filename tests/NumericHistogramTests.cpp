@@ -0,0 +1,74 @@
+// Tests for NumericHistogram. Build from the repository root with
+//     g++ -std=c++17 -I. tests/NumericHistogramTests.cpp -o NumericHistogramTests
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "NumericHistogram.hpp"
+
+using fileFunctions::NumericHistogram;
+
+static void checkAgainstEdges(const NumericHistogram & scaled)
+{
+	// Fixed-width and logarithmic bins must bin every value exactly as explicit edges do, including the values
+	// on and right next to every edge
+	NumericHistogram byEdges = NumericHistogram::withEdges(scaled.getEdges());
+	std::vector<double> values;
+	for (double edge : scaled.getEdges())
+	{
+		double below = std::nextafter(edge, -INFINITY);
+		double above = std::nextafter(edge, INFINITY);
+		values.insert(values.end(), {edge, below, above, std::nextafter(below, -INFINITY), std::nextafter(above, INFINITY)});
+	}
+	NumericHistogram lhs = scaled;
+	NumericHistogram rhs = byEdges;
+	for (double x : values)
+	{
+		lhs.clear();
+		rhs.clear();
+		lhs.add(x);
+		rhs.add(x);
+		assert(lhs.getCounts() == rhs.getCounts());
+		assert(lhs.getUnderflow() == rhs.getUnderflow() && lhs.getOverflow() == rhs.getOverflow());
+	}
+}
+
+int main()
+{
+	{
+		NumericHistogram histogram = NumericHistogram::fixedWidth(0, 10, 5);
+		double values[] = {-1, 0, 1.999, 2, 9.99, 10, 10.5, NAN, 4};
+		histogram.add(values, values + 9);
+		assert((histogram.getCounts() == std::vector<std::uint64_t>{2, 1, 1, 0, 2}));
+		assert(histogram.getUnderflow() == 1 && histogram.getOverflow() == 1 && histogram.getNaNCount() == 1 && histogram.getTotal() == 9);
+	}
+	{
+		// One ulp below an interior edge belongs to the bin below it
+		NumericHistogram histogram = NumericHistogram::fixedWidth(-65, 37, 16);
+		assert(histogram.getEdges()[6] == -26.75);
+		histogram.add(-26.750000000000004);
+		assert(histogram.getCount(5) == 1);
+	}
+	std::mt19937 generator(9);
+	std::uniform_real_distribution<double> edges(-100, 100);
+	std::uniform_int_distribution<std::size_t> binCounts(1, 200);
+	for (int i = 0; i < 2000; ++i)
+	{
+		double lower = edges(generator);
+		double upper = edges(generator);
+		if (lower == upper)
+		{
+			continue;
+		}
+		if (lower > upper)
+		{
+			std::swap(lower, upper);
+		}
+		checkAgainstEdges(NumericHistogram::fixedWidth(lower, upper, binCounts(generator)));
+		checkAgainstEdges(NumericHistogram::logarithmic(std::abs(lower) + 1e-3, std::abs(lower) + 1e-3 + (upper - lower) * 37, binCounts(generator)));
+	}
+	std::cout << "NumericHistogram tests passed\n";
+}
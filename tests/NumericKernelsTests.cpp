@@ -0,0 +1,127 @@
+// Tests for the reductions and sorts of NumericFile: the results must be the same bits whatever kernels and
+// however many threads are used, and the ascending sort must order ±0, ±infinity and NaN as documented.
+// Build from the repository root with
+//     g++ -std=c++17 -pthread -I. tests/NumericKernelsTests.cpp -o NumericKernelsTests
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "NumericFile.hpp"
+
+using namespace fileFunctions;
+
+static std::vector<double> reduce(const NumericFile & file, sp::ExecutionMode execution)
+{
+	// Every reduction of the whole file, in both summation modes
+	std::vector<double> results;
+	for (SummationMode mode : { SummationMode::STANDARD, SummationMode::COMPENSATED })
+	{
+		results.push_back(file.computeSumOfContents(execution, mode));
+		results.push_back(file.computeAbsoluteSumOfContents(execution, mode));
+		results.push_back(file.computeAverageOfContents(execution, mode));
+		results.push_back(file.computeVarianceOfContents(execution, mode));
+	}
+	results.push_back(file.computeMinimumOfContents(execution));
+	results.push_back(file.computeMaximumOfContents(execution));
+	NumericSummary summary = file.computeSummaryOfContents(execution);
+	results.insert(results.end(), { summary.getSum(), summary.getAbsoluteSum(), summary.getMinimum(), summary.getMaximum(), summary.getAverage(), summary.getVariance() });
+	return results;
+}
+
+static bool ascendingWithZeroes(double lhs, double rhs)
+{
+	// std::less, except that -0.0 comes before 0.0
+	return lhs < rhs || (lhs == rhs && std::signbit(lhs) && !std::signbit(rhs));
+}
+
+static void checkAscendingSort(const NumericLine & line, sp::ExecutionMode execution)
+{
+	// sortLine must give std::sort's order with -0.0 before 0.0, then every NaN
+	NumericFile file;
+	file.appendLineToFile(line);
+	file.sortLine(0, execution);
+	std::vector<double> expected;
+	std::copy_if(line.begin(), line.end(), std::back_inserter(expected), [](double x) { return !std::isnan(x); });
+	std::sort(expected.begin(), expected.end(), ascendingWithZeroes);
+	const NumericLine & sorted = file.getLineView(0);
+	assert(sorted.size() == line.size());
+	for (std::size_t i = 0; i < expected.size(); ++i)
+	{
+		assert(std::memcmp(&sorted[i], &expected[i], sizeof(double)) == 0);
+	}
+	assert(std::all_of(sorted.begin() + expected.size(), sorted.end(), [](double x) { return std::isnan(x); }));
+}
+
+int main()
+{
+	std::mt19937_64 generator(11);
+	std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+	std::uniform_int_distribution<int> exponents(-12, 12);
+	NumericFile file;
+	for (std::size_t length : { std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(1000), std::size_t(70000), std::size_t(200000), std::size_t(33) })
+	{
+		NumericLine line(length);
+		for (double & x : line)
+		{
+			x = distribution(generator) * std::pow(10.0, exponents(generator)); // Magnitudes that vary widely, so rounding shows
+		}
+		file.appendLineToFile(line);
+	}
+	{
+		// Bit-for-bit the same for every kernel level and thread count, sequential or parallel
+		NFPF::setKernelLevel(NFPF::KernelLevel::SCALAR);
+		sp::setThreadCount(1);
+		std::vector<double> expected = reduce(file, sp::ExecutionMode::SEQUENTIAL);
+		for (NFPF::KernelLevel level : { NFPF::KernelLevel::SCALAR, NFPF::KernelLevel::AVX2, NFPF::KernelLevel::AVX512 })
+		{
+			NFPF::setKernelLevel(level);
+			for (std::size_t threads : { 1, 3, 8 })
+			{
+				sp::setThreadCount(threads);
+				for (sp::ExecutionMode execution : { sp::ExecutionMode::SEQUENTIAL, sp::ExecutionMode::PARALLEL })
+				{
+					std::vector<double> results = reduce(file, execution);
+					assert(std::memcmp(results.data(), expected.data(), expected.size() * sizeof(double)) == 0);
+				}
+			}
+		}
+		NFPF::setKernelLevel(NFPF::KernelLevel::AVX512);
+	}
+	{
+		// Ascending sorts, short lines through std::sort and long ones through the radix sort, on one thread or several
+		const double special[] = { 0.0, -0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN(), -std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::denorm_min(), -std::numeric_limits<double>::denorm_min() };
+		for (std::size_t length : { std::size_t(20), std::size_t(5000), std::size_t(300000) })
+		{
+			NumericLine line(length);
+			for (double & x : line)
+			{
+				x = generator() % 4 == 0 ? special[generator() % 8] : distribution(generator);
+			}
+			for (std::size_t threads : { 1, 3 })
+			{
+				sp::setThreadCount(threads);
+				checkAscendingSort(line, sp::ExecutionMode::SEQUENTIAL);
+				checkAscendingSort(line, sp::ExecutionMode::PARALLEL);
+			}
+		}
+		// Other predicates go through std::sort, split between threads for long lines
+		NumericLine line(300000);
+		for (double & x : line)
+		{
+			x = distribution(generator);
+		}
+		NumericFile descending;
+		descending.appendLineToFile(line);
+		descending.sortLine(0, sp::ExecutionMode::PARALLEL, std::greater<double>());
+		std::sort(line.begin(), line.end(), std::greater<double>());
+		assert(descending.getLineView(0) == line);
+	}
+	std::cout << "NumericKernels tests passed\n";
+}
@@ -0,0 +1,68 @@
+// Tests for QuantileSketch. Build from the repository root with
+//     g++ -std=c++17 -I. tests/NumericQuantilesTests.cpp -o NumericQuantilesTests
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "NumericQuantiles.hpp"
+
+using fileFunctions::QuantileSketch;
+
+int main()
+{
+	std::mt19937_64 generator(7);
+	std::normal_distribution<double> distribution;
+	std::vector<double> values(200000);
+	for (double & value : values)
+	{
+		value = distribution(generator);
+	}
+	std::vector<double> sorted(values);
+	std::sort(sorted.begin(), sorted.end());
+	{
+		// Ranks are within the error bound, whether the values are added one at a time or all at once
+		QuantileSketch oneAtATime;
+		for (double value : values)
+		{
+			oneAtATime.add(value);
+		}
+		QuantileSketch allAtOnce;
+		allAtOnce.add(values.begin(), values.end());
+		for (const QuantileSketch * sketch : { &oneAtATime, &allAtOnce })
+		{
+			assert(sketch->getCount() == values.size() && sketch->getMinimum() == sorted.front() && sketch->getMaximum() == sorted.back());
+			for (double quantile : { 0.01, 0.1, 0.5, 0.9, 0.99 })
+			{
+				double rank = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), sketch->getQuantile(quantile)) - sorted.begin()) / sorted.size();
+				assert(std::abs(rank - quantile) < 0.01);
+			}
+		}
+	}
+	{
+		// Merging a sketch into itself is the same as merging a copy of it
+		QuantileSketch sketch;
+		sketch.add(values.begin(), values.end());
+		QuantileSketch copy(sketch);
+		QuantileSketch expected(sketch);
+		expected.merge(copy);
+		sketch.merge(sketch);
+		assert(sketch.getCount() == 2 * values.size());
+		assert(sketch.getQuantiles({ 0.1, 0.5, 0.9 }) == expected.getQuantiles({ 0.1, 0.5, 0.9 }));
+	}
+	{
+		// Sketches of different accuracies merge into one of the lower accuracy
+		QuantileSketch accurate(400);
+		QuantileSketch coarse(50);
+		accurate.add(values.begin(), values.begin() + 100000);
+		coarse.add(values.begin() + 100000, values.end());
+		accurate.merge(coarse);
+		assert(accurate.getAccuracy() == 50 && accurate.getCount() == values.size());
+		double rank = static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), accurate.getMedian()) - sorted.begin()) / sorted.size();
+		assert(std::abs(rank - 0.5) < 0.05);
+	}
+	std::cout << "NumericQuantiles tests passed\n";
+}
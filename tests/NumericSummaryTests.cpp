@@ -0,0 +1,62 @@
+// Tests for NumericSummary and NumericColumnSummary. Build from the repository root with
+//     g++ -std=c++17 -pthread -I. tests/NumericSummaryTests.cpp -o NumericSummaryTests
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "NumericFile.hpp"
+
+using namespace fileFunctions;
+
+static void checkExtremes(const NumericLine & line)
+{
+	// The summary's extremes must be those of the minimum and maximum reductions, wherever the NaNs are
+	NumericFile file;
+	file.appendLineToFile(line);
+	NumericSummary summary = file.computeSummaryOfContents();
+	assert(summary.getMinimum() == file.computeMinimumOfContents() && summary.getMaximum() == file.computeMaximumOfContents());
+	assert(!std::isnan(summary.getMinimum()) && !std::isnan(summary.getMaximum()));
+	NumericSummary reversed(line.rbegin(), line.rend());
+	assert(reversed.getMinimum() == summary.getMinimum() && reversed.getMaximum() == summary.getMaximum());
+}
+
+int main()
+{
+	checkExtremes({NAN, 1, 2});
+	checkExtremes({1, NAN, 2});
+	checkExtremes({1, 2, NAN});
+	NumericLine line(1000);
+	for (std::size_t i = 0; i < line.size(); ++i)
+	{
+		line[i] = static_cast<double>(i % 37) - 18;
+	}
+	for (std::size_t i = 0; i < line.size(); i += NumericSummary::blockSize)
+	{
+		line[i] = NAN; // At the start of every block
+	}
+	checkExtremes(line);
+	{
+		// Merging is the same in either order
+		NumericSummary lhs(line.begin(), line.begin() + 300);
+		NumericSummary rhs(line.begin() + 300, line.end());
+		NumericSummary merged = lhs;
+		merged.merge(rhs);
+		rhs.merge(lhs);
+		assert(merged.getMinimum() == -18 && merged.getMaximum() == 18);
+		assert(rhs.getMinimum() == merged.getMinimum() && rhs.getMaximum() == merged.getMaximum());
+	}
+	{
+		// So are the column extremes, with NaNs in the first row of a block
+		NumericFile file;
+		for (std::size_t i = 0; i < 600; ++i)
+		{
+			double x = static_cast<double>(i % 11);
+			file.appendLineToFile(i % NumericColumnSummary::blockRows == 0 ? NumericLine{NAN, NAN} : NumericLine{x, -x});
+		}
+		NumericColumnSummary columns = file.computeColumnSummaryOfContents();
+		assert((columns.getMinima() == std::vector<double>{0, -10}) && (columns.getMaxima() == std::vector<double>{10, 0}));
+	}
+	std::cout << "NumericSummary tests passed\n";
+}
@@ -0,0 +1,75 @@
+// Tests for RegexFunctions, checked against std::regex. Build from the repository root with
+//     g++ -std=c++17 -I. tests/RegexFunctionsTests.cpp -o RegexFunctionsTests
+
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+
+#include "RegexFunctions.hpp"
+
+static void checkAgainstStdRegex(const std::string & pattern)
+{
+	// Matches 'pattern' against every short line and a few thousand random ones
+	std::regex expected(pattern);
+	std::mt19937 generator(1);
+	const char alphabet[] = "abcdexz.-01 ";
+	for (int i = 0; i < 3000; ++i)
+	{
+		std::string line;
+		for (std::size_t length = generator() % 8; line.size() < length;)
+		{
+			line += alphabet[generator() % (sizeof(alphabet) - 1)];
+		}
+		if (sp::matchesRegex(line, pattern) != std::regex_search(line, expected))
+		{
+			std::cerr << "'" << pattern << "' disagrees with std::regex on '" << line << "'\n";
+			assert(false);
+		}
+	}
+}
+
+static bool isRejected(const std::string & pattern)
+{
+	try
+	{
+		sp::compileRegex(pattern);
+	}
+	catch (const std::invalid_argument &)
+	{
+		return true;
+	}
+	return false;
+}
+
+int main()
+{
+	const char * patterns[] =
+	{
+		"abc", "^abc", "abc$", "a.c", "a[bc]+d", "(ab|cd)*e", "^$", "x?", "[^a-z]", "\\d{2,3}", "^(a|b)c$", "a{2}",
+		"[[:digit:]]+x", "(?:foo|bar)baz", "a|^b", "c$|^d", "z*$", "[a\\-z]", "\\.", "a+?b",
+		"$^", "c?$^", "a|$^", "^$|a", "(a|^)(b|$)", "(^)?a", "($)+", "(^)+a", "(^|x)*b", "a($)?", "(^$)*", "(?:$)*a",
+		"[[:alpha:]]+", "[[:space:]]", "[[:upper:][:punct:]]", "[[:lower:]]0", "[^[:alnum:]]", "[[:xdigit:]]{3}", "\\w\\s\\S", "\\D\\W"
+	};
+	for (const char * pattern : patterns)
+	{
+		checkAgainstStdRegex(pattern);
+	}
+	// Both '^' and '$' hold in an empty line
+	assert(sp::matchesRegex("", "$^") && sp::matchesRegex("", "c?$^") && sp::matchesRegex("", "a|$^"));
+	assert(!sp::matchesRegex("b", "$^") && sp::matchesRegex("a", "a|$^"));
+	// Only groups of assertions may be repeated, not bare ones
+	for (const char * pattern : { "(a", "^*", "$+", "a^?" })
+	{
+		assert(isRejected(pattern));
+	}
+	// The cache drops the pattern used least recently when it's full, so one in constant use stays compiled
+	std::shared_ptr<const sp::RegexProgram> program = sp::compileRegex("(kept|held)+");
+	for (int i = 0; i < 200; ++i)
+	{
+		sp::compileRegex("pattern" + std::to_string(i));
+		assert(sp::compileRegex("(kept|held)+") == program);
+	}
+	std::cout << "RegexFunctions tests passed\n";
+}